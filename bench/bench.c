@@ -0,0 +1,457 @@
+#include "psrs/macro.h"
+#define PSRS_BENCH_ONLY
+#include "psrs/bench.h"
+#undef PSRS_BENCH_ONLY
+
+#include "psrs/arena.h"
+#include "psrs/convert.h"
+#include "psrs/generator.h"
+#include "psrs/sort.h"
+#include "psrs/stats.h"
+#include "psrs/timing.h"
+
+#include <errno.h>
+#include <getopt.h>      /* getopt_long() */
+#include <limits.h>      /* CHAR_MAX */
+#include <mpi.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The smallest length (8 KiB of 'long') fits in the L1 data cache of any
+ * recent processor, while the default largest one (128 MiB) only fits in
+ * main memory.
+ */
+#define BENCH_MIN_LENGTH (1 << 10)
+#define BENCH_MAX_LENGTH (1 << 24)
+#define BENCH_LENGTH_STEP 4
+
+/*
+ * Written with the result of every search, so the calls can not be
+ * optimized away.
+ */
+static volatile int bench_sink;
+
+/*
+ * NOTE:
+ * The kernels are called directly on a single process: nothing is
+ * communicated, but they may call 'MPI_Abort' on invalid input, so MPI is
+ * still initialized.
+ */
+int main(int argc, char *argv[])
+{
+        static const char *const KERNEL_NAME[KERNEL_COUNT] = {
+                [KERNEL_QSORT]     = "qsort",
+                [KERNEL_MERGE]     = "array_merge",
+                [KERNEL_SEARCH]    = "bin_search",
+                [KERNEL_PARTITION] = "partition_form"
+        };
+        static const double NS_PER_SEC = 1e9;
+        double elapsed = 0;
+        double median = 0;
+        double min = 0;
+        struct bench_arg arg;
+        struct bench_buffer buffer;
+        struct moving_window *window = NULL;
+
+        MPI_Init(&argc, &argv);
+
+        if (0 > bench_argument_parse(&arg, argc, argv) ||
+            0 > bench_buffer_init(&buffer, &arg) ||
+            0 > moving_window_init(&window, arg.run)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        printf("Kernel, Distribution, Length, Bytes, Median, Min, "
+               "ns/Element, Elements/s\n");
+
+        for (int i = KERNEL_QSORT; i < KERNEL_COUNT; ++i) {
+                for (int j = DIST_UNIFORM; j < DIST_COUNT; ++j) {
+                        for (int length = arg.min_length;
+                             length <= arg.max_length;
+                             length *= BENCH_LENGTH_STEP) {
+                                if (0 > array_dist_generate(&buffer.input,
+                                                            length,
+                                                            arg.seed,
+                                                            j) ||
+                                    0 > bench_prepare(&buffer,
+                                                      i,
+                                                      length,
+                                                      &arg)) {
+                                        MPI_Abort(MPI_COMM_WORLD,
+                                                  EXIT_FAILURE);
+                                }
+
+                                for (unsigned int k = 0U;
+                                     k < arg.warmup + arg.run;
+                                     ++k) {
+                                        if (0 > bench_run(&elapsed,
+                                                          &buffer,
+                                                          i,
+                                                          length)) {
+                                                MPI_Abort(MPI_COMM_WORLD,
+                                                          EXIT_FAILURE);
+                                        }
+                                        if (arg.warmup <= k) {
+                                                moving_window_push(window,
+                                                                   elapsed);
+                                        }
+                                }
+
+                                moving_percentile_calc(window, 50, &median);
+                                moving_min_calc(window, &min);
+                                printf("%s, %s, %d, %zu, "
+                                       "%.9f, %.9f, %f, %.0f\n",
+                                       KERNEL_NAME[i],
+                                       array_dist_name(j),
+                                       length,
+                                       length * sizeof(long),
+                                       median,
+                                       min,
+                                       median * NS_PER_SEC / length,
+                                       length / median);
+                                fflush(stdout);
+
+                                /* The next length would exceed it. */
+                                if (arg.max_length / BENCH_LENGTH_STEP <
+                                    length) {
+                                        break;
+                                }
+                        }
+                }
+        }
+
+        moving_window_destroy(&window);
+        bench_buffer_destroy(&buffer);
+        MPI_Finalize();
+        return EXIT_SUCCESS;
+}
+
+static int bench_argument_parse(struct bench_arg *result,
+                                int argc,
+                                char *argv[])
+{
+        enum {
+                OPT_WARMUP = CHAR_MAX + 1
+        };
+        /* NOTE: All the flags followed by an extra colon require arguments. */
+        static const char *const OPT_STR = ":hl:p:r:s:";
+        static const struct option OPTS[] = {
+                {"help",    no_argument,       NULL, 'h'},
+                {"length",  required_argument, NULL, 'l'},
+                {"process", required_argument, NULL, 'p'},
+                {"run",     required_argument, NULL, 'r'},
+                {"seed",    required_argument, NULL, 's'},
+                {"warmup",  required_argument, NULL, OPT_WARMUP},
+                {
+                        .name    = NULL,
+                        .has_arg = 0,
+                        .flag    = NULL,
+                        .val     = 0
+                }
+        };
+        int opt = 0;
+
+        if (NULL == result || 0 == argc || NULL == argv) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        result->min_length = BENCH_MIN_LENGTH;
+        result->max_length = BENCH_MAX_LENGTH;
+        result->run = 5U;
+        result->warmup = 1U;
+        result->seed = 10U;
+        result->process = 8;
+
+        while (-1 != (opt = getopt_long(argc, argv, OPT_STR, OPTS, NULL))) {
+                switch (opt) {
+                case 0:
+                        break;
+                case 'l':
+                        if (0 > int_convert(&result->max_length, optarg)) {
+                                bench_usage_show(argv[0],
+                                                 EXIT_FAILURE,
+                                                 "Length is too large or "
+                                                 "not valid");
+                        }
+                        break;
+                case 'p':
+                        if (0 > int_convert(&result->process, optarg)) {
+                                bench_usage_show(argv[0],
+                                                 EXIT_FAILURE,
+                                                 "Process is too large or "
+                                                 "not valid");
+                        }
+                        break;
+                case 'r':
+                        if (0 > unsigned_convert(&result->run, optarg)) {
+                                bench_usage_show(argv[0],
+                                                 EXIT_FAILURE,
+                                                 "Run is too large or "
+                                                 "not valid");
+                        }
+                        break;
+                case 's':
+                        if (0 > unsigned_convert(&result->seed, optarg)) {
+                                bench_usage_show(argv[0],
+                                                 EXIT_FAILURE,
+                                                 "Seed is too large or "
+                                                 "not valid");
+                        }
+                        break;
+                case OPT_WARMUP:
+                        if (0 > unsigned_convert(&result->warmup, optarg)) {
+                                bench_usage_show(argv[0],
+                                                 EXIT_FAILURE,
+                                                 "Warmup is too large or "
+                                                 "not valid");
+                        }
+                        break;
+                case '?':
+                        bench_usage_show(argv[0],
+                                         EXIT_FAILURE,
+                                         "There is no such option");
+                case ':':
+                        bench_usage_show(argv[0],
+                                         EXIT_FAILURE,
+                                         "Missing argument");
+                case 'h':
+                default:
+                        bench_usage_show(argv[0], EXIT_FAILURE, NULL);
+                }
+        }
+
+        if (result->min_length > result->max_length) {
+                result->min_length = result->max_length;
+        }
+
+        if (2 > result->max_length || 0U == result->run) {
+                bench_usage_show(argv[0],
+                                 EXIT_FAILURE,
+                                 "Length must be at least 2 and run must be "
+                                 "positive");
+        }
+
+        if (2 > result->process || result->min_length < result->process) {
+                bench_usage_show(argv[0],
+                                 EXIT_FAILURE,
+                                 "Process must be between 2 and the "
+                                 "smallest length");
+        }
+        return 0;
+}
+
+static void bench_usage_show(const char *name, int status, const char *msg)
+{
+        if (NULL != msg) {
+                fprintf(stderr,
+                        "[" ANSI_COLOR_BLUE "Error" ANSI_COLOR_RESET "]\n"
+                        "%s\n\n",
+                        msg);
+        }
+        fprintf(stderr,
+                "[" ANSI_COLOR_BLUE "Usage" ANSI_COLOR_RESET "]\n"
+                "%s [-h]\n"
+                "[-l MAX_LENGTH]\n"
+                "[-p NUMBER_OF_PARTITIONS]\n"
+                "[-r NUMBER_OF_RUNS]\n"
+                "[-s SEED]\n"
+                "[--warmup NUMBER_OF_RUNS]\n\n"
+
+                "[" ANSI_COLOR_BLUE "Optional Arguments" ANSI_COLOR_RESET "]\n"
+                "-h, --help\tshow this help message and exit\n"
+                "-l, --length\tlargest length measured (default: %d);\n"
+                "\t\tthe lengths grow by %dx from %d\n"
+                "-p, --process\tnumber of partitions formed by\n"
+                "\t\tpartition_form (default: 8)\n"
+                "-r, --run\tnumber of runs measured (default: 5)\n"
+                "-s, --seed\tseed for PRNG of srandom() (default: 10)\n"
+                "--warmup\tnumber of runs thrown away before the\n"
+                "\t\tmeasured ones (default: 1)\n\n"
+
+                "[" ANSI_COLOR_BLUE "NOTE" ANSI_COLOR_RESET "]\n"
+                "The median and minimum are in seconds; the throughput\n"
+                "is derived from the median.\n",
+                NULL == name ? "" : name,
+                BENCH_MAX_LENGTH,
+                BENCH_LENGTH_STEP,
+                BENCH_MIN_LENGTH);
+        MPI_Abort(MPI_COMM_WORLD, status);
+}
+
+static int bench_buffer_init(struct bench_buffer *self,
+                             const struct bench_arg *const arg)
+{
+        size_t size = 0U;
+
+        if (NULL == self || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        size = sizeof(long) * arg->max_length;
+        memset(self, 0, sizeof(struct bench_buffer));
+
+        if (NULL == (self->input = (long *)malloc(size)) ||
+            NULL == (self->work = (long *)malloc(size)) ||
+            NULL == (self->output = (long *)malloc(size)) ||
+            NULL == (self->pivot = (long *)malloc(sizeof(long) *\
+                                                  arg->process))) {
+                return -1;
+        }
+
+        if (0 > arena_init(&self->arena,
+                           sizeof(struct part_blk) +\
+                           arg->process * sizeof(struct partition) +\
+                           ARENA_ALIGN) ||
+            0 > part_blk_init(&self->blk, self->arena, arg->process)) {
+                return -1;
+        }
+
+        /*
+         * Only the members read by 'partition_form' matter; with the
+         * barriers turned off it never communicates.
+         */
+        self->process.root = true;
+        self->process.barrier = false;
+        self->process.comm = MPI_COMM_SELF;
+        self->process.process = arg->process;
+        return 0;
+}
+
+static int bench_buffer_destroy(struct bench_buffer *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        free(self->input);
+        free(self->work);
+        free(self->output);
+        free(self->pivot);
+        if (NULL != self->arena) {
+                arena_destroy(&self->arena);
+        }
+        memset(self, 0, sizeof(struct bench_buffer));
+        return 0;
+}
+
+/*
+ * Prepares the input of 'kernel' from the generated 'buffer->input' of
+ * 'length' values; nothing done here is timed.
+ */
+static int bench_prepare(struct bench_buffer *const buffer,
+                         const enum bench_kernel kernel,
+                         const int length,
+                         const struct bench_arg *const arg)
+{
+        const int half = length / 2;
+
+        if (NULL == buffer || 2 > length || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        memcpy(buffer->work, buffer->input, sizeof(long) * length);
+
+        switch (kernel) {
+        case KERNEL_QSORT:
+                /* 'bench_run' copies the input afresh for every run. */
+                break;
+        case KERNEL_MERGE:
+                /* 2 sorted halves, as 2 partitions received in phase 3. */
+                qsort(buffer->work, half, sizeof(long), long_compare);
+                qsort(buffer->work + half,
+                      length - half,
+                      sizeof(long),
+                      long_compare);
+                break;
+        case KERNEL_SEARCH:
+                qsort(buffer->work, length, sizeof(long), long_compare);
+                break;
+        case KERNEL_PARTITION:
+                /* Pivots are regular samples of the sorted values. */
+                qsort(buffer->work, length, sizeof(long), long_compare);
+                for (int i = 1; i < arg->process; ++i) {
+                        buffer->pivot[i - 1] =
+                                buffer->work[(long)i * length / arg->process];
+                }
+                buffer->process.head = buffer->work;
+                buffer->process.size = length;
+                break;
+        default:
+                errno = EINVAL;
+                return -1;
+        }
+        return 0;
+}
+
+/* Times a single run of 'kernel' over 'length' values. */
+static int bench_run(double *elapsed,
+                     struct bench_buffer *const buffer,
+                     const enum bench_kernel kernel,
+                     const int length)
+{
+        const int half = length / 2;
+        int index = 0;
+        struct timespec start;
+        struct partition pivots;
+
+        if (NULL == elapsed || NULL == buffer || 2 > length) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        /*
+         * 'partition_form' consumes the pivots, so they are described
+         * afresh for every run.
+         */
+        pivots.head = buffer->pivot;
+        pivots.size = buffer->process.process - 1;
+
+        if (KERNEL_QSORT == kernel) {
+                memcpy(buffer->work, buffer->input, sizeof(long) * length);
+        }
+
+        timing_reset(&start);
+        timing_start(&start);
+
+        switch (kernel) {
+        case KERNEL_QSORT:
+                qsort(buffer->work, length, sizeof(long), long_compare);
+                break;
+        case KERNEL_MERGE:
+                if (0 > array_merge(buffer->output,
+                                    buffer->work,
+                                    half,
+                                    buffer->work + half,
+                                    length - half)) {
+                        return -1;
+                }
+                break;
+        case KERNEL_SEARCH:
+                for (int i = 0; i < length; ++i) {
+                        if (0 > bin_search(&index,
+                                           buffer->input[i],
+                                           buffer->work,
+                                           length)) {
+                                return -1;
+                        }
+                        bench_sink = index;
+                }
+                break;
+        case KERNEL_PARTITION:
+                partition_form(buffer->blk, &pivots, &buffer->process);
+                break;
+        default:
+                errno = EINVAL;
+                return -1;
+        }
+
+        return timing_stop(elapsed, &start);
+}
@@ -0,0 +1,464 @@
+/*
+ * Benchmark of the C++ front-end (see "include/psrs/libpsrs.hpp") against
+ * the C path it stands in for, on every process of a full MPI run: the
+ * local sort alone ('qsort' with 'long_compare' against 'std::sort' with
+ * an inlined comparison) and a whole distributed sort ('psrs_sort' against
+ * 'psrs::sort<long>', also with a comparator and with a key extractor of
+ * its own).
+ */
+#include "psrs/libpsrs.hpp"
+#include "psrs/libpsrs.h"
+
+extern "C" {
+#include "psrs/generator.h"
+
+/*
+ * NOTE:
+ * Declared in "include/psrs/convert.h" and "include/psrs/sort.h", neither
+ * of which is valid C++ (both take array parameters qualified 'const').
+ */
+int int_convert(int *number, const char *const candidate);
+int unsigned_convert(unsigned int *number, const char *const candidate);
+int long_compare(const void *left, const void *right);
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>     /* CHAR_MAX */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>  /* std::greater */
+#include <getopt.h>      /* getopt_long() */
+#include <vector>
+
+namespace {
+
+/* Paths measured, in the order they are reported. */
+enum cxx_path {
+        PATH_QSORT,      /* 'qsort' with 'long_compare' of the block. */
+        PATH_STD_SORT,   /* 'std::sort' of the block. */
+        PATH_PSRS_SORT,  /* 'psrs_sort' of the blocks of all processes. */
+        PATH_FRONT_END,  /* 'psrs::sort<long>' of the same. */
+        PATH_GREATER,    /* The same, in descending order. */
+        PATH_KEY,        /* 'psrs::sort' of records by 'cxx_record_key'. */
+        PATH_COUNT
+};
+
+/* A record of 'PATH_KEY': a key of the block along with a payload. */
+struct cxx_record {
+        long key;
+        long payload; /* '~key', so a record torn apart is told. */
+};
+
+/* The key extractor of 'PATH_KEY'. */
+struct cxx_record_key {
+        long operator()(const cxx_record &record) const noexcept
+        {
+                return record.key;
+        }
+};
+
+struct cxx_arg {
+        int length; /* Of the whole table, split evenly among processes. */
+        unsigned int run;
+        /* Number of runs before the measured ones that are thrown away. */
+        unsigned int warmup;
+        unsigned int seed;
+};
+
+/* What every path sorts into, kept across the runs of each. */
+struct cxx_buffer {
+        std::vector<long> block; /* As scattered. */
+        std::vector<long> work;  /* Sorted in place, from 'block'. */
+        std::vector<cxx_record> record; /* Likewise for 'PATH_KEY'. */
+        struct psrs_result c_result;
+        psrs::result<long> cxx_result;
+        psrs::result<cxx_record> record_result;
+        /*
+         * The part of the result of 'psrs_sort', copied since it may point
+         * into 'work', which the next path sorts into.
+         */
+        std::vector<long> expected;
+        std::int64_t expected_offset;
+};
+
+void cxx_usage_show(const char *name, int status, const char *msg)
+{
+        if (nullptr != msg) {
+                std::fprintf(stderr, "[Error]\n%s\n\n", msg);
+        }
+        std::fprintf(stderr,
+                     "[Usage]\n"
+                     "%s [-h]\n"
+                     "[-l LENGTH_OF_ARRAY]\n"
+                     "[-r NUMBER_OF_RUNS]\n"
+                     "[-s SEED]\n"
+                     "[--warmup NUMBER_OF_RUNS]\n\n"
+
+                     "[Optional Arguments]\n"
+                     "-h, --help\tshow this help message and exit\n"
+                     "-l, --length\tlength of the whole array, divisible\n"
+                     "\t\tby the number of processes (default: 4194304)\n"
+                     "-r, --run\tnumber of runs measured (default: 5)\n"
+                     "-s, --seed\tseed for PRNG of srandom() (default: 10)\n"
+                     "--warmup\tnumber of runs thrown away before the\n"
+                     "\t\tmeasured ones (default: 1)\n\n"
+
+                     "[NOTE]\n"
+                     "The time of a run is that of the slowest process;\n"
+                     "the median and minimum are in seconds, and the\n"
+                     "throughput is derived from the median.\n",
+                     nullptr == name ? "" : name);
+        MPI_Abort(MPI_COMM_WORLD, status);
+}
+
+int cxx_argument_parse(struct cxx_arg *result, int argc, char *argv[])
+{
+        enum {
+                OPT_WARMUP = CHAR_MAX + 1
+        };
+        /* NOTE: All the flags followed by an extra colon require arguments. */
+        static const char *const OPT_STR = ":hl:r:s:";
+        static const struct option OPTS[] = {
+                {"help",   no_argument,       nullptr, 'h'},
+                {"length", required_argument, nullptr, 'l'},
+                {"run",    required_argument, nullptr, 'r'},
+                {"seed",   required_argument, nullptr, 's'},
+                {"warmup", required_argument, nullptr, OPT_WARMUP},
+                {nullptr,  0,                 nullptr, 0}
+        };
+        int process = 0;
+        int opt = 0;
+
+        if (nullptr == result || 0 == argc || nullptr == argv) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        result->length = 1 << 22;
+        result->run = 5U;
+        result->warmup = 1U;
+        result->seed = 10U;
+
+        while (-1 != (opt = getopt_long(argc, argv, OPT_STR, OPTS, nullptr))) {
+                switch (opt) {
+                case 'l':
+                        if (0 > int_convert(&result->length, optarg)) {
+                                cxx_usage_show(argv[0],
+                                               EXIT_FAILURE,
+                                               "Length is too large or "
+                                               "not valid");
+                        }
+                        break;
+                case 'r':
+                        if (0 > unsigned_convert(&result->run, optarg)) {
+                                cxx_usage_show(argv[0],
+                                               EXIT_FAILURE,
+                                               "Run is too large or "
+                                               "not valid");
+                        }
+                        break;
+                case 's':
+                        if (0 > unsigned_convert(&result->seed, optarg)) {
+                                cxx_usage_show(argv[0],
+                                               EXIT_FAILURE,
+                                               "Seed is too large or "
+                                               "not valid");
+                        }
+                        break;
+                case OPT_WARMUP:
+                        if (0 > unsigned_convert(&result->warmup, optarg)) {
+                                cxx_usage_show(argv[0],
+                                               EXIT_FAILURE,
+                                               "Warmup is too large or "
+                                               "not valid");
+                        }
+                        break;
+                case '?':
+                        cxx_usage_show(argv[0],
+                                       EXIT_FAILURE,
+                                       "There is no such option");
+                        break;
+                case ':':
+                        cxx_usage_show(argv[0],
+                                       EXIT_FAILURE,
+                                       "Missing argument");
+                        break;
+                case 'h':
+                default:
+                        cxx_usage_show(argv[0], EXIT_FAILURE, nullptr);
+                }
+        }
+
+        MPI_Comm_size(MPI_COMM_WORLD, &process);
+        if (0 >= result->length || 0 != result->length % process ||
+            0U == result->run) {
+                cxx_usage_show(argv[0],
+                               EXIT_FAILURE,
+                               "Length must be positive and divisible by "
+                               "the number of processes, and run must be "
+                               "positive");
+        }
+        return 0;
+}
+
+/*
+ * Runs 'path' once on the blocks of every process, and returns the time of
+ * this process in 'elapsed'.
+ */
+int cxx_run(double *elapsed,
+            struct cxx_buffer *const buffer,
+            const enum cxx_path path)
+{
+        /* The memory of the previous run is sorted into again. */
+        struct psrs_opts opts = { 0UL, 0U, 1U };
+        double begin = 0;
+
+        if (PATH_KEY == path) {
+                for (std::size_t i = 0U; i < buffer->block.size(); ++i) {
+                        buffer->record[i].key = buffer->block[i];
+                        buffer->record[i].payload = ~buffer->block[i];
+                }
+        } else {
+                std::copy(buffer->block.begin(),
+                          buffer->block.end(),
+                          buffer->work.begin());
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        begin = MPI_Wtime();
+
+        switch (path) {
+        case PATH_QSORT:
+                std::qsort(buffer->work.data(),
+                           buffer->work.size(),
+                           sizeof(long),
+                           long_compare);
+                break;
+        case PATH_STD_SORT:
+                std::sort(buffer->work.begin(), buffer->work.end());
+                break;
+        case PATH_PSRS_SORT:
+                if (0 > psrs_sort(MPI_COMM_WORLD,
+                                  buffer->work.data(),
+                                  buffer->work.size(),
+                                  &buffer->c_result,
+                                  &opts)) {
+                        return -1;
+                }
+                break;
+        case PATH_FRONT_END:
+                if (0 > psrs::sort(MPI_COMM_WORLD,
+                                   psrs::span<long>(buffer->work),
+                                   buffer->cxx_result)) {
+                        return -1;
+                }
+                break;
+        case PATH_GREATER:
+                if (0 > psrs::sort(MPI_COMM_WORLD,
+                                   psrs::span<long>(buffer->work),
+                                   buffer->cxx_result,
+                                   std::greater<>())) {
+                        return -1;
+                }
+                break;
+        case PATH_KEY:
+                if (0 > psrs::sort(MPI_COMM_WORLD,
+                                   psrs::span<cxx_record>(buffer->record),
+                                   buffer->record_result,
+                                   std::less<>(),
+                                   cxx_record_key())) {
+                        return -1;
+                }
+                break;
+        default:
+                errno = EINVAL;
+                return -1;
+        }
+
+        *elapsed = MPI_Wtime() - begin;
+        return 0;
+}
+
+/*
+ * Sorts the blocks of every process through 'psrs_sort' into
+ * 'buffer->expected', as 'path' (one of the front-end) should have: those
+ * of 'PATH_GREATER' are negated first, which orders them the other way
+ * round (no generated key is 'LONG_MIN').
+ */
+int cxx_expected_sort(struct cxx_buffer *const buffer,
+                      const enum cxx_path path)
+{
+        struct psrs_opts opts = { 0UL, 0U, 1U };
+
+        for (std::size_t i = 0U; i < buffer->block.size(); ++i) {
+                buffer->work[i] = PATH_GREATER == path ?
+                                  -buffer->block[i] : buffer->block[i];
+        }
+        if (0 > psrs_sort(MPI_COMM_WORLD,
+                          buffer->work.data(),
+                          buffer->work.size(),
+                          &buffer->c_result,
+                          &opts)) {
+                return -1;
+        }
+        buffer->expected.assign(buffer->c_result.head,
+                                buffer->c_result.head +
+                                buffer->c_result.size);
+        buffer->expected_offset = buffer->c_result.offset;
+        return 0;
+}
+
+/*
+ * Whether the part of the result of 'psrs_sort' and that of 'psrs::sort'
+ * by 'path' are the same on every process, as they pick the same pivots;
+ * the keys of 'PATH_GREATER' are negated back, and those of 'PATH_KEY'
+ * must still carry their payloads.
+ */
+bool cxx_result_match(const struct cxx_buffer *const buffer,
+                      const enum cxx_path path)
+{
+        const psrs::result<long> &cxx_result = buffer->cxx_result;
+        const psrs::result<cxx_record> &record_result =
+                buffer->record_result;
+        const std::size_t size = PATH_KEY == path ?
+                                 record_result.data.size() :
+                                 cxx_result.data.size();
+        int match = size == buffer->expected.size() &&
+                    (PATH_KEY == path ?
+                     record_result.offset : cxx_result.offset) ==
+                    buffer->expected_offset;
+        int all_match = 0;
+
+        for (std::size_t i = 0U; match && i < size; ++i) {
+                switch (path) {
+                case PATH_GREATER:
+                        match = -cxx_result.data[i] == buffer->expected[i];
+                        break;
+                case PATH_KEY:
+                        match = record_result.data[i].key ==
+                                buffer->expected[i] &&
+                                record_result.data[i].payload ==
+                                ~buffer->expected[i];
+                        break;
+                default:
+                        match = cxx_result.data[i] == buffer->expected[i];
+                }
+        }
+
+        MPI_Allreduce(&match, &all_match, 1, MPI_INT, MPI_MIN,
+                      MPI_COMM_WORLD);
+        return 0 != all_match;
+}
+
+} /* namespace */
+
+int main(int argc, char *argv[])
+{
+        static const char *const PATH_NAME[PATH_COUNT] = {
+                "qsort", "std::sort", "psrs_sort", "psrs::sort",
+                "psrs::sort greater", "psrs::sort key"
+        };
+        static const double NS_PER_SEC = 1e9;
+        int rank = 0;
+        int process = 0;
+        int size = 0;
+        double elapsed = 0;
+        double slowest = 0;
+        double median = 0;
+        long *table = nullptr;
+        std::vector<double> time;
+        struct cxx_arg arg;
+        struct cxx_buffer buffer;
+
+        MPI_Init(&argc, &argv);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &process);
+
+        if (0 > cxx_argument_parse(&arg, argc, argv)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        size = arg.length / process;
+        std::memset(&buffer.c_result, 0, sizeof(struct psrs_result));
+        buffer.block.resize(size);
+        buffer.work.resize(size);
+        buffer.record.resize(size);
+        time.resize(arg.run);
+
+        if (0 == rank) {
+                std::printf("Path, Distribution, Length, Processes, Median, "
+                            "Min, ns/Element, Elements/s\n");
+        }
+
+        for (int i = DIST_UNIFORM; i < DIST_COUNT; ++i) {
+                if (0 == rank &&
+                    0 > array_dist_generate(&table,
+                                            arg.length,
+                                            arg.seed,
+                                            static_cast<enum array_dist>(i))) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                MPI_Scatter(table, size, MPI_LONG,
+                            buffer.block.data(), size, MPI_LONG,
+                            0, MPI_COMM_WORLD);
+                if (0 == rank) {
+                        array_destroy(&table);
+                }
+
+                for (int j = PATH_QSORT; j < PATH_COUNT; ++j) {
+                        for (unsigned int k = 0U;
+                             k < arg.warmup + arg.run;
+                             ++k) {
+                                if (0 > cxx_run(&elapsed,
+                                                &buffer,
+                                                static_cast<cxx_path>(j))) {
+                                        MPI_Abort(MPI_COMM_WORLD,
+                                                  EXIT_FAILURE);
+                                }
+                                MPI_Reduce(&elapsed, &slowest, 1, MPI_DOUBLE,
+                                           MPI_MAX, 0, MPI_COMM_WORLD);
+                                if (arg.warmup <= k) {
+                                        time[k - arg.warmup] = slowest;
+                                }
+                        }
+                        if (PATH_FRONT_END <= j &&
+                            (0 > cxx_expected_sort(
+                                    &buffer,
+                                    static_cast<cxx_path>(j)) ||
+                             !cxx_result_match(&buffer,
+                                               static_cast<cxx_path>(j)))) {
+                                if (0 == rank) {
+                                        std::fprintf(stderr,
+                                                     "%s and psrs_sort do "
+                                                     "not agree\n",
+                                                     PATH_NAME[j]);
+                                }
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        if (0 != rank) {
+                                continue;
+                        }
+                        std::nth_element(time.begin(),
+                                         time.begin() + time.size() / 2U,
+                                         time.end());
+                        median = time[time.size() / 2U];
+                        std::printf("%s, %s, %d, %d, %.9f, %.9f, %f, %.0f\n",
+                                    PATH_NAME[j],
+                                    array_dist_name(
+                                            static_cast<enum array_dist>(i)),
+                                    arg.length,
+                                    process,
+                                    median,
+                                    *std::min_element(time.begin(),
+                                                      time.end()),
+                                    median * NS_PER_SEC / arg.length,
+                                    arg.length / median);
+                        std::fflush(stdout);
+                }
+        }
+
+        psrs_result_destroy(&buffer.c_result);
+        MPI_Finalize();
+        return EXIT_SUCCESS;
+}
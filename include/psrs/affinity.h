@@ -0,0 +1,25 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include "macro.h"
+
+#include <mpi.h>
+#include <stddef.h>
+
+/*
+ * Size of the buffer holding the list of CPUs a process may run on, in the
+ * form of "0-3,8"; longer lists are truncated.
+ */
+#define AFFINITY_SIZE 64
+
+int affinity_pin(MPI_Comm comm);
+int affinity_get(char list[const], const size_t size);
+
+#ifdef AFFINITY_ONLY
+static void affinity_range_append_(char list[const],
+                                   const size_t size,
+                                   const int first,
+                                   const int last);
+#endif
+
+#endif /* AFFINITY_H */
@@ -0,0 +1,50 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "macro.h"
+
+#include <stddef.h>
+
+/*
+ * Every address handed out by 'arena_alloc' is aligned to this boundary,
+ * which is large enough for any of the builtin types used by the program.
+ */
+#define ARENA_ALIGN 16U
+
+struct arena_chunk {
+        size_t size; /* Capacity of 'data' in bytes. */
+        size_t used; /* Number of bytes already handed out. */
+        unsigned char *data;
+        struct arena_chunk *next;
+};
+
+/*
+ * A bump allocator: memory is handed out linearly from a (normally single)
+ * chunk and is only ever given back all at once through 'arena_reset'.
+ *
+ * If a request does not fit into the remaining space, an extra chunk is
+ * chained at the end; 'arena_reset' later folds all the chunks into one
+ * so every following round is served by a single block again.
+ */
+struct arena {
+        size_t capacity; /* Sum of the 'size' of every chunk. */
+        /* Bytes handed out (rounded up) since the last 'arena_reset'. */
+        size_t used;
+        /* Number of requests and bytes handed out since 'arena_init'. */
+        size_t count;
+        size_t total;
+        struct arena_chunk *head;
+        struct arena_chunk *current;
+};
+
+int arena_init(struct arena **self, const size_t capacity);
+int arena_alloc(struct arena *self, void **ptr, const size_t size);
+int arena_reset(struct arena *self);
+int arena_destroy(struct arena **self);
+
+#ifdef ARENA_ONLY
+static int arena_chunk_init_(struct arena_chunk **self, const size_t size);
+static void arena_chunk_destroy_(struct arena_chunk **self);
+#endif
+
+#endif /* ARENA_H */
@@ -0,0 +1,65 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "macro.h"
+#include "arena.h"
+#include "sort.h"
+
+#include <stddef.h>
+
+/* Kernels measured by 'psrs_bench', in the order they are reported. */
+enum bench_kernel {
+        KERNEL_QSORT,     /* 'qsort' with 'long_compare' (phase 1.2) */
+        KERNEL_MERGE,     /* 'array_merge' of 2 halves (phase 4.1) */
+        KERNEL_SEARCH,    /* 'bin_search' of every value (phase 2.3) */
+        KERNEL_PARTITION, /* 'partition_form' (phase 2.3) */
+        KERNEL_COUNT
+};
+
+struct bench_arg {
+        /*
+         * The lengths measured start from 'min_length' and grow by a factor
+         * of 'BENCH_LENGTH_STEP' until 'max_length' is exceeded.
+         */
+        int min_length;
+        int max_length;
+        unsigned int run;
+        /* Number of runs before the measured ones that are thrown away. */
+        unsigned int warmup;
+        unsigned int seed;
+        /* Number of partitions formed by 'KERNEL_PARTITION'. */
+        int process;
+};
+
+/* Buffers shared by all the kernels, large enough for 'max_length'. */
+struct bench_buffer {
+        long *input;  /* As generated. */
+        long *work;   /* Input of the kernel, prepared from 'input'. */
+        long *output; /* Output of 'array_merge'. */
+        long *pivot;  /* 'process - 1' pivots of 'partition_form'. */
+        struct arena *arena;
+        struct part_blk *blk;
+        struct process_arg process;
+};
+
+#ifdef PSRS_BENCH_ONLY
+static int bench_argument_parse(struct bench_arg *result,
+                                int argc,
+                                char *argv[]);
+static void bench_usage_show(const char *name,
+                             int status,
+                             const char *msg);
+static int bench_buffer_init(struct bench_buffer *self,
+                             const struct bench_arg *const arg);
+static int bench_buffer_destroy(struct bench_buffer *self);
+static int bench_prepare(struct bench_buffer *const buffer,
+                         const enum bench_kernel kernel,
+                         const int length,
+                         const struct bench_arg *const arg);
+static int bench_run(double *elapsed,
+                     struct bench_buffer *const buffer,
+                     const enum bench_kernel kernel,
+                     const int length);
+#endif
+
+#endif /* BENCH_H */
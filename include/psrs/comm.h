@@ -0,0 +1,61 @@
+#ifndef COMM_H
+#define COMM_H
+
+#include "macro.h"
+
+#include <mpi.h>
+
+/*
+ * MPI functions accounted for by the PMPI layer (see 'pmpi/comm.c'), which
+ * are all the ones PSRS communicates through.
+ */
+enum comm_func {
+        COMM_SEND,
+        COMM_SSEND,
+        COMM_RECV,
+        COMM_BARRIER,
+        COMM_BCAST,
+        COMM_SCATTER,
+        COMM_GATHER,
+        COMM_GATHERV,
+        COMM_ALLTOALL,
+        COMM_REDUCE,
+        COMM_FUNC_COUNT
+};
+
+/* What is accounted for each function. */
+enum comm_stat {
+        COMM_CALLS,
+        COMM_BYTES_SENT,
+        COMM_BYTES_RECEIVED,
+        COMM_TIME, /* Seconds spent within the call (blocked or copying). */
+        COMM_STAT_SIZE
+};
+
+/* Number of phases the calls can be charged to. */
+#define COMM_PHASE_MAX 8
+
+/* The calls made outside of any phase are not charged at all. */
+#define COMM_PHASE_NONE (-1)
+
+/*
+ * NOTE:
+ * These are only defined if the PMPI layer is linked in, which is the case
+ * if 'PSRS_PMPI' is defined (see the "PSRS_PMPI" option of CMake).
+ */
+#ifdef PSRS_PMPI
+int comm_phase_set(const int phase);
+int comm_reset(void);
+int comm_read(double count[const][COMM_FUNC_COUNT][COMM_STAT_SIZE],
+              const int phase_count);
+#endif
+
+#ifdef COMM_ONLY
+static inline void comm_account_(const enum comm_func func,
+                                 const double begin,
+                                 const double sent,
+                                 const double received);
+static inline double comm_bytes_(const int count, MPI_Datatype datatype);
+#endif
+
+#endif /* COMM_H */
@@ -6,4 +6,8 @@
 int int_convert(int *number, const char *const candidate);
 int unsigned_convert(unsigned int *number, const char *const candidate);
 int sizet_convert(size_t *size, const char *const candidate);
+int token_split(char *const str,
+                char *token[const],
+                unsigned int *const count,
+                const unsigned int max);
 #endif /* CONVERT_H */
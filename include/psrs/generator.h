@@ -5,7 +5,28 @@
 
 #include <stddef.h>
 
+/* Distribution of the values generated by 'array_dist_generate'. */
+enum array_dist {
+        DIST_UNIFORM,     /* Uniformly random, as 'array_generate'. */
+        DIST_SORTED,      /* Already sorted in ascending order. */
+        DIST_REVERSE,     /* Sorted in descending order. */
+        DIST_FEW_UNIQUE,  /* Uniformly random among 16 distinct values. */
+        DIST_COUNT
+};
+
 int array_generate(long **const array, const size_t length, unsigned int seed);
+int array_dist_generate(long **const array,
+                        const size_t length,
+                        unsigned int seed,
+                        const enum array_dist dist);
+int array_dist_slice_generate(long *const array,
+                              const size_t offset,
+                              const size_t size,
+                              const size_t length,
+                              unsigned int seed,
+                              const enum array_dist dist);
+int array_dist_convert(unsigned int *dist, const char *const candidate);
+const char *array_dist_name(const enum array_dist dist);
 int array_destroy(long **const array);
 
 #endif /* GENERATOR_H */
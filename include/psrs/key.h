@@ -0,0 +1,111 @@
+#ifndef KEY_H
+#define KEY_H
+
+#include "macro.h"
+#include "arena.h"
+#include "generator.h"
+
+#include <mpi.h>
+#include <stddef.h>
+
+/*
+ * Types of the keys that can be sorted; 'KEY_LONG' is the one the rest of
+ * the program is written for, and the only one 'parallel_sort' handles.
+ */
+enum key_type {
+        KEY_LONG,
+        KEY_INT32,
+        KEY_UINT32,
+        KEY_INT64,
+        KEY_UINT64,
+        KEY_FLOAT,
+        KEY_DOUBLE,
+        KEY_TYPE_COUNT
+};
+
+/*
+ * The kernels of a single key type, all of which order the keys the same
+ * way; every one of them is generated from the same source by 'KEY_DEFINE'
+ * in 'src/key.c'.
+ *
+ * NOTE:
+ * The keys are ordered by their bits mapped onto an unsigned integer of
+ * the same width, which is what the radix sort works on as well: an
+ * integer with its sign bit flipped, or a floating point number with its
+ * sign bit flipped if it is positive and all its bits if it is negative.
+ * For the floating point types this is a total order where
+ * -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN, so -0.0 and +0.0
+ * are told apart and every NaN has a place (by its sign and payload).
+ *
+ * Items other than keys, such as the records of 'include/psrs/record.h',
+ * are sorted by 'key_sort' through a kernel of their own with only 'size'
+ * and 'compare' set.
+ */
+struct key_kernel {
+        const char *name;
+        size_t size; /* Bytes of a key. */
+        /*
+         * Converts 'length' values as made by 'array_dist_generate' with
+         * 'dist' into keys (see 'key_table_convert').
+         */
+        void (*convert)(void *dst,
+                        const long src[],
+                        const size_t length,
+                        const enum array_dist dist);
+        /* LSD radix sort of 'length' keys, through 'tmp' of as many. */
+        void (*sort)(void *base, void *tmp, const size_t length);
+        /* Merges 2 sorted arrays of keys into 'dst'. */
+        void (*merge)(void *dst,
+                      const void *left,
+                      const size_t left_length,
+                      const void *right,
+                      const size_t right_length);
+        /* Number of keys of the sorted 'base' no greater than 'key'. */
+        size_t (*upper_bound)(const void *base,
+                              const size_t length,
+                              const void *key);
+        /* As for 'qsort'. */
+        int (*compare)(const void *left, const void *right);
+};
+
+/* What 'key_sort' leaves on each process. */
+struct key_sorted {
+        void *head; /* The sorted keys of this process, in the arena. */
+        int size;
+        /* Bytes sent to the other processes while exchanging partitions. */
+        double sent;
+};
+
+const struct key_kernel *key_kernel(const enum key_type type);
+MPI_Datatype key_datatype(const enum key_type type);
+int key_type_convert(unsigned int *type, const char *const candidate);
+const char *key_type_name(const enum key_type type);
+int key_sort(struct key_sorted *out,
+             MPI_Comm comm,
+             const struct key_kernel *kernel,
+             MPI_Datatype datatype,
+             void *block,
+             const int size,
+             struct arena *arena);
+
+#ifdef KEY_ONLY
+static void key_merge_all_(struct key_sorted *out,
+                           const struct key_kernel *kernel,
+                           unsigned char *recv,
+                           const int recv_count[const],
+                           const int recv_displ[const],
+                           const int process,
+                           struct arena *arena);
+static void key_merge_(const struct key_kernel *kernel,
+                       unsigned char *dst,
+                       const unsigned char *left,
+                       const size_t left_length,
+                       const unsigned char *right,
+                       const size_t right_length);
+static size_t key_upper_bound_(const struct key_kernel *kernel,
+                               const unsigned char *base,
+                               const size_t length,
+                               const unsigned char *key);
+#endif
+
+#endif /* KEY_H */
@@ -0,0 +1,106 @@
+#ifndef LIBPSRS_H
+#define LIBPSRS_H
+
+/*
+ * NOTE:
+ * This is the only header installed along with 'libpsrs', so it must stand
+ * on its own: unlike the others it includes neither "macro.h" nor any other
+ * header of the project.
+ */
+#include <mpi.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Defined in 'include/psrs/arena.h'; opaque to the users of 'libpsrs'. */
+struct arena;
+
+/* Options of 'psrs_sort'; a zeroed structure asks for the defaults. */
+struct psrs_opts {
+        /*
+         * Bytes a process may receive at once while the partitions are
+         * exchanged, which also merges them as they arrive so the working
+         * memory stays at about 2 blocks plus this much; 0 if unbounded.
+         */
+        unsigned long mem_limit;
+        /*
+         * Whether the processes synchronize between the phases, which only
+         * matters for timing them individually; off by default.
+         */
+        unsigned int barrier;
+        /*
+         * Whether the memory of the 'out' given, as filled in by an earlier
+         * call and not destroyed since, is sorted into again instead of
+         * allocating afresh; it only ever grows, so a series of sorts of
+         * similar sizes allocates once.  Off by default.
+         *
+         * NOTE: The earlier result is gone once the call returns.
+         */
+        unsigned int reuse;
+};
+
+/* The part of the sorted sequence held by a single process. */
+struct psrs_result {
+        /*
+         * 'size' sorted elements, all of which are no less than those of
+         * every lower rank and no greater than those of every higher rank.
+         *
+         * NOTE: 'head' may point into the 'in' buffer given to
+         * 'psrs_sort', which must therefore outlive the result.
+         */
+        long *head;
+        int64_t size;
+        /* Index of 'head[0]' within the whole sorted sequence. */
+        int64_t offset;
+        /*
+         * Segment of each element of 'head' for 'psrs_sort_segments';
+         * 'NULL' otherwise.
+         */
+        int32_t *segment;
+        /*
+         * Index each element of 'head' had within the whole input (the
+         * blocks of all the processes one after another in rank order) for
+         * 'psrs_argsort'; 'NULL' otherwise.
+         */
+        int64_t *index;
+        /* Seconds 'psrs_sort' took on this process. */
+        double elapsed;
+        /* Owns the memory of 'head'; released by 'psrs_result_destroy'. */
+        struct arena *arena;
+};
+
+int psrs_sort(MPI_Comm comm,
+              long *in,
+              const int64_t n_local,
+              struct psrs_result *const out,
+              const struct psrs_opts *const opts);
+int psrs_sort_segments(MPI_Comm comm,
+                       long *in,
+                       const int32_t segment[],
+                       const int64_t n_local,
+                       struct psrs_result *const out,
+                       const struct psrs_opts *const opts);
+int psrs_argsort(MPI_Comm comm,
+                 const long *in,
+                 const int64_t n_local,
+                 struct psrs_result *const out,
+                 const struct psrs_opts *const opts);
+int psrs_result_destroy(struct psrs_result *const result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef LIBPSRS_ONLY
+static int psrs_check_(MPI_Comm comm,
+                       const long *const in,
+                       const int64_t n_local,
+                       const struct psrs_result *const out,
+                       int64_t *const total);
+static long psrs_segment_pack_(const int32_t segment, const long key);
+static void psrs_segment_unpack_(int32_t *const segment, long *const key);
+#endif
+
+#endif /* LIBPSRS_H */
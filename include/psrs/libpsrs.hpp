@@ -0,0 +1,387 @@
+#ifndef LIBPSRS_HPP
+#define LIBPSRS_HPP
+
+/*
+ * NOTE:
+ * A C++17 front-end of 'libpsrs' that needs nothing but this header and
+ * MPI: the phases of 'psrs_sort' are written again as templates, so the
+ * comparator and the key extractor given as template parameters are
+ * inlined into the local sort, the search for the pivots and the merge
+ * instead of being called through a pointer for every comparison as
+ * 'long_compare' is by 'qsort'.  Like "libpsrs.h" it includes no other
+ * header of the project.
+ *
+ * The C++ bindings of MPI, gone since MPI-3, are kept out so only the C
+ * library needs to be linked.
+ */
+#ifndef OMPI_SKIP_MPICXX
+#define OMPI_SKIP_MPICXX 1
+#endif
+#ifndef MPICH_SKIP_MPICXX
+#define MPICH_SKIP_MPICXX 1
+#endif
+#include <mpi.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace psrs {
+
+#if __cplusplus >= 202002L
+template <class T>
+using span = std::span<T>;
+#else
+/* The part of 'std::span' (of C++20) that 'sort' needs. */
+template <class T>
+class span {
+public:
+        span() noexcept : head_(nullptr), size_(0U) {}
+        span(T *head, const std::size_t size) noexcept
+                : head_(head), size_(size) {}
+        template <class Allocator>
+        span(std::vector<T, Allocator> &vector) noexcept
+                : head_(vector.data()), size_(vector.size()) {}
+        template <std::size_t N>
+        span(T (&array)[N]) noexcept : head_(array), size_(N) {}
+
+        T *data() const noexcept { return head_; }
+        std::size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return 0U == size_; }
+        T *begin() const noexcept { return head_; }
+        T *end() const noexcept { return head_ + size_; }
+        T &operator[](const std::size_t i) const { return head_[i]; }
+
+private:
+        T *head_;
+        std::size_t size_;
+};
+#endif
+
+/* The key extractor of 'sort' by default: every element is its own key. */
+struct identity {
+        template <class T>
+        constexpr T &&operator()(T &&value) const noexcept
+        {
+                return std::forward<T>(value);
+        }
+};
+
+/* The part of the sorted sequence held by a single process. */
+template <class T>
+struct result {
+        /*
+         * Sorted elements, all of which are no less than those of every
+         * lower rank and no greater than those of every higher rank.
+         *
+         * NOTE: Unlike 'struct psrs_result' it never points into the
+         * input; a result given again to 'sort' is sorted into in place of
+         * allocating afresh, so its memory only ever grows.
+         */
+        std::vector<T> data;
+        /* Index of 'data[0]' within the whole sorted sequence. */
+        std::int64_t offset = 0;
+        /* Seconds 'sort' took on this process. */
+        double elapsed = 0;
+        /* The other buffer of the merges, kept along for the same reason. */
+        std::vector<T> scratch;
+};
+
+namespace detail {
+
+/*
+ * A type of the bytes of 'T', made and committed on the first call and
+ * kept until 'MPI_Finalize' (which frees it along with everything else).
+ */
+template <class T>
+MPI_Datatype opaque_datatype_()
+{
+        static const MPI_Datatype datatype = [] {
+                MPI_Datatype made = MPI_DATATYPE_NULL;
+
+                MPI_Type_contiguous(static_cast<int>(sizeof(T)),
+                                    MPI_BYTE,
+                                    &made);
+                MPI_Type_commit(&made);
+                return made;
+        }();
+
+        return datatype;
+}
+
+} /* namespace detail */
+
+/*
+ * The MPI data type of 'T': the predefined one of an arithmetic type, or
+ * else a contiguous run of its bytes, which describes any trivially
+ * copyable type between processes of the same architecture.
+ */
+template <class T>
+MPI_Datatype datatype()
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only trivially copyable types can be sent as bytes");
+
+        if constexpr (std::is_same<T, char>::value) {
+                return MPI_CHAR;
+        } else if constexpr (std::is_same<T, signed char>::value) {
+                return MPI_SIGNED_CHAR;
+        } else if constexpr (std::is_same<T, unsigned char>::value) {
+                return MPI_UNSIGNED_CHAR;
+        } else if constexpr (std::is_same<T, short>::value) {
+                return MPI_SHORT;
+        } else if constexpr (std::is_same<T, unsigned short>::value) {
+                return MPI_UNSIGNED_SHORT;
+        } else if constexpr (std::is_same<T, int>::value) {
+                return MPI_INT;
+        } else if constexpr (std::is_same<T, unsigned int>::value) {
+                return MPI_UNSIGNED;
+        } else if constexpr (std::is_same<T, long>::value) {
+                return MPI_LONG;
+        } else if constexpr (std::is_same<T, unsigned long>::value) {
+                return MPI_UNSIGNED_LONG;
+        } else if constexpr (std::is_same<T, long long>::value) {
+                return MPI_LONG_LONG;
+        } else if constexpr (std::is_same<T, unsigned long long>::value) {
+                return MPI_UNSIGNED_LONG_LONG;
+        } else if constexpr (std::is_same<T, float>::value) {
+                return MPI_FLOAT;
+        } else if constexpr (std::is_same<T, double>::value) {
+                return MPI_DOUBLE;
+        } else if constexpr (std::is_same<T, long double>::value) {
+                return MPI_LONG_DOUBLE;
+        } else {
+                return detail::opaque_datatype_<T>();
+        }
+}
+
+namespace detail {
+
+/*
+ * Merges the sorted runs of 'data' that start at each 'bound' (the last
+ * of which is the end of the runs) 2 at a time, level by level, through
+ * 'scratch'; the merged whole ends up in 'data'.
+ */
+template <class T, class Less>
+void merge_all_(std::vector<T> &data,
+                std::vector<T> &scratch,
+                std::vector<int> &bound,
+                Less less)
+{
+        std::size_t runs = bound.size() - 1U;
+        std::size_t kept = 0U;
+
+        scratch.resize(data.size());
+        while (1U < runs) {
+                kept = 0U;
+                for (std::size_t i = 0U; i < runs; i += 2U) {
+                        if (i + 1U == runs) {
+                                std::copy(data.begin() + bound[i],
+                                          data.begin() + bound[i + 1U],
+                                          scratch.begin() + bound[i]);
+                        } else {
+                                std::merge(data.begin() + bound[i],
+                                           data.begin() + bound[i + 1U],
+                                           data.begin() + bound[i + 1U],
+                                           data.begin() + bound[i + 2U],
+                                           scratch.begin() + bound[i],
+                                           less);
+                        }
+                        bound[kept++] = bound[i];
+                }
+                bound[kept] = bound[runs];
+                runs = kept;
+                data.swap(scratch);
+        }
+}
+
+} /* namespace detail */
+
+/*
+ * Sorts the elements of 'in' of every process of 'comm' as a single
+ * sequence distributed over all of them by the keys 'key' extracts,
+ * ordered by 'compare', and fills in 'out' of each process with its part
+ * of the result, just as 'psrs_sort' does; this is collective over 'comm'.
+ *
+ * NOTE:
+ * 'in' is sorted in place along the way.  The samples and the pivots are
+ * picked exactly as by 'psrs_sort', so for 'long' both leave the same
+ * part of the result on every process; the partitions received are merged
+ * level by level rather than into a single running result.  An invalid
+ * argument of any process fails the call on every process (with 'EINVAL'),
+ * as does a total beyond 'INT_MAX' elements (with 'EOVERFLOW').
+ */
+template <class T, class Compare = std::less<>, class KeyExtract = identity>
+int sort(MPI_Comm comm,
+         span<T> in,
+         result<T> &out,
+         Compare compare = Compare(),
+         KeyExtract key = KeyExtract())
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only trivially copyable types can be sorted");
+
+        const MPI_Datatype type = datatype<T>();
+        const auto less = [&compare, &key](const T &left, const T &right) {
+                return compare(key(left), key(right));
+        };
+        const double begin = MPI_Wtime();
+        const int invalid = (nullptr == in.data() && !in.empty()) ||
+                            static_cast<std::size_t>(INT_MAX) < in.size();
+        const std::int64_t count = invalid ?
+                                   0 : static_cast<std::int64_t>(in.size());
+        std::int64_t total = 0;
+        int any_invalid = 0;
+        int process = 0;
+        int id = 0;
+        int size = 0;
+        int window = 0;
+        int sample_total = 0;
+        MPI_Comm dup = MPI_COMM_NULL;
+        std::vector<T> sample;
+        std::vector<T> all_sample;
+        std::vector<T> pivot;
+        /*
+         * 'part' holds the number of elements sent to and received from
+         * each process, followed by where they go in either buffer (the
+         * numbers of samples of root first use it the same way); 'bound'
+         * is where each partition received starts, and then each run of
+         * the merge.
+         */
+        std::vector<int> part;
+        std::vector<int> bound;
+
+        if (MPI_COMM_NULL == comm) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Allreduce(&invalid, &any_invalid, 1, MPI_INT, MPI_MAX, comm);
+        MPI_Allreduce(&count, &total, 1, MPI_INT64_T, MPI_SUM, comm);
+        if (any_invalid) {
+                errno = EINVAL;
+                return -1;
+        }
+        if (INT_MAX < total) {
+                errno = EOVERFLOW;
+                return -1;
+        }
+
+        out.data.clear();
+        out.offset = 0;
+
+        /* The messages of the sort never mix with those of the caller. */
+        MPI_Comm_dup(comm, &dup);
+        MPI_Comm_size(dup, &process);
+        MPI_Comm_rank(dup, &id);
+        size = static_cast<int>(in.size());
+
+        /* There are no samples to pick the pivots from otherwise. */
+        if (0 < total) {
+                T *const first = in.data();
+                T *const last = first + size;
+                T *head = first;
+
+                /* Phase 1: the local sort and the regular samples. */
+                std::sort(first, last, less);
+                window = size / process;
+                for (int i = 0;
+                     i < size && static_cast<int>(sample.size()) < process;
+                     i += window) {
+                        sample.push_back(first[i]);
+                        if (0 == window) {
+                                break;
+                        }
+                }
+
+                /* Phase 2: root picks the pivots out of all the samples. */
+                part.assign(4U * process, 0);
+                sample_total = static_cast<int>(sample.size());
+                MPI_Gather(&sample_total, 1, MPI_INT,
+                           part.data(), 1, MPI_INT,
+                           0, dup);
+                sample_total = 0;
+                for (int i = 0; 0 == id && i < process; ++i) {
+                        part[2 * process + i] = sample_total;
+                        sample_total += part[i];
+                }
+                all_sample.resize(sample_total);
+                MPI_Gatherv(sample.data(), static_cast<int>(sample.size()),
+                            type,
+                            all_sample.data(), part.data(),
+                            part.data() + 2 * process, type,
+                            0, dup);
+
+                pivot.resize(process - 1);
+                if (0 == id) {
+                        std::sort(all_sample.begin(), all_sample.end(), less);
+                        std::size_t picked = 0U;
+                        for (int i = process + process / 2;
+                             i < sample_total && picked < pivot.size();
+                             i += process) {
+                                pivot[picked++] = all_sample[i];
+                        }
+                        while (0 < sample_total && picked < pivot.size()) {
+                                pivot[picked++] = all_sample.back();
+                        }
+                }
+                MPI_Bcast(pivot.data(), process - 1, type, 0, dup);
+
+                /* Phase 3: the partitions formed and exchanged. */
+                for (int i = 0; i < process - 1; ++i) {
+                        T *const next = std::upper_bound(head,
+                                                         last,
+                                                         pivot[i],
+                                                         less);
+                        part[i] = static_cast<int>(next - head);
+                        head = next;
+                }
+                part[process - 1] = static_cast<int>(last - head);
+                for (int i = 0, displ = 0; i < process; ++i) {
+                        part[2 * process + i] = displ;
+                        displ += part[i];
+                }
+                MPI_Alltoall(part.data(), 1, MPI_INT,
+                             part.data() + process, 1, MPI_INT,
+                             dup);
+                bound.resize(process + 1);
+                bound[0] = 0;
+                for (int i = 0; i < process; ++i) {
+                        part[3 * process + i] = bound[i];
+                        bound[i + 1] = bound[i] + part[process + i];
+                }
+                out.data.resize(bound[process]);
+                MPI_Alltoallv(first, part.data(),
+                              part.data() + 2 * process, type,
+                              out.data.data(), part.data() + process,
+                              part.data() + 3 * process, type,
+                              dup);
+
+                /* Phase 4: the partitions received merged. */
+                detail::merge_all_(out.data, out.scratch, bound, less);
+        }
+
+        const std::int64_t held = static_cast<std::int64_t>(out.data.size());
+        MPI_Exscan(&held, &out.offset, 1, MPI_INT64_T, MPI_SUM, dup);
+        /* 'MPI_Exscan' leaves the one of the first process undefined. */
+        if (0 == id) {
+                out.offset = 0;
+        }
+        MPI_Comm_free(&dup);
+        out.elapsed = MPI_Wtime() - begin;
+        return 0;
+}
+
+} /* namespace psrs */
+
+#endif /* LIBPSRS_HPP */
@@ -0,0 +1,26 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "macro.h"
+#include "arena.h"
+
+#include <stddef.h>
+
+/* What is recorded about the memory of a process at a point in time. */
+enum memory_stat {
+        MEMORY_ALLOCATED,   /* Bytes handed out by the arena so far. */
+        MEMORY_ALLOCATIONS, /* Number of requests served by the arena. */
+        MEMORY_LIVE,        /* Bytes of the arena in use right now. */
+        MEMORY_RESERVED,    /* Bytes the arena holds from 'malloc'. */
+        MEMORY_RSS,         /* Resident set size of the process. */
+        MEMORY_PEAK_RSS,    /* Highest resident set size so far. */
+        MEMORY_STAT_SIZE
+};
+
+int memory_read(double usage[const], const struct arena *const arena);
+
+#ifdef MEMORY_ONLY
+static int memory_status_read_(double *const rss, double *const peak);
+#endif
+
+#endif /* MEMORY_H */
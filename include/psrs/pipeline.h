@@ -0,0 +1,96 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "macro.h"
+#include "arena.h"
+#include "sort.h"
+
+#include <mpi.h>
+#include <stddef.h>
+
+/*
+ * Number of elements the local sort of a job works on between 2 polls of
+ * the collectives in flight (see 'pipeline_poll_'): 256 KiB of 'long's,
+ * which a piece sorted on its own fits into the L2 cache with.
+ */
+#define PIPELINE_PIECE (1 << 15)
+
+/*
+ * Where a job of a 'pipeline_slot' is at; every stage but 'STAGE_FREE'
+ * waits for the nonblocking collective named after it, and the work
+ * between 2 collectives is done as soon as the first one completes.
+ */
+enum pipeline_stage {
+        STAGE_FREE,     /* No job; the slot may take the next one. */
+        STAGE_GATHER,   /* Regular samples on their way to root. */
+        STAGE_BCAST,    /* Pivots on their way from root. */
+        STAGE_COUNT,    /* Sizes of the partitions being exchanged. */
+        STAGE_EXCHANGE  /* Partitions being exchanged. */
+};
+
+/*
+ * A job in flight and everything it works in; a slot takes every
+ * 'depth'-th job, so the same job lands in the same slot on every process.
+ *
+ * NOTE:
+ * Every slot has a communicator of its own: nonblocking collectives on a
+ * communicator match in the order they are started, and the processes
+ * reach the stages of different jobs in different orders.
+ */
+struct pipeline_slot {
+        enum pipeline_stage stage;
+        unsigned int job;
+        double begin; /* 'MPI_Wtime' when the job is started. */
+        MPI_Comm comm;
+        /*
+         * Block and arena of the job, and its result in 'merged', as the
+         * kernels of the phases in 'include/psrs/sort.h' expect them; its
+         * barriers are off, so none of them blocks.
+         */
+        struct process_arg arg;
+        struct partition sample; /* Regular samples of the block. */
+        long *all_sample; /* 'process' samples of every process; root. */
+        struct partition pivots;
+        int *send_count;
+        int *send_displ;
+        int *recv_count;
+        int *recv_displ;
+        long *recv;       /* The partitions received. */
+        struct part_blk *blk;
+};
+
+struct pipeline {
+        unsigned int depth; /* Number of jobs in flight at most. */
+        int id;
+        int process;
+        int size; /* Number of elements of the block of each job. */
+        struct pipeline_slot *slot;
+        /* Request of the collective each slot waits for, in slot order. */
+        MPI_Request *request;
+};
+
+int pipeline_init(struct pipeline **self,
+                  MPI_Comm comm,
+                  const unsigned int depth,
+                  const int size);
+int pipeline_run(struct pipeline *self,
+                 const long block[const],
+                 const unsigned int jobs,
+                 double latency[const]);
+int pipeline_destroy(struct pipeline **self);
+
+#ifdef PIPELINE_ONLY
+static void pipeline_start_(struct pipeline *self,
+                            struct pipeline_slot *slot,
+                            const long block[const],
+                            const unsigned int job);
+static void pipeline_advance_(struct pipeline *self,
+                              struct pipeline_slot *slot,
+                              double latency[const]);
+static void pipeline_sort_(struct pipeline *self,
+                           struct pipeline_slot *slot);
+static void pipeline_merge_(struct pipeline_slot *slot);
+static void pipeline_poll_(struct pipeline *self);
+#endif
+
+#endif /* PIPELINE_H */
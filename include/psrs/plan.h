@@ -0,0 +1,73 @@
+#ifndef PLAN_H
+#define PLAN_H
+
+#include "macro.h"
+#include "sort.h"
+
+#include <mpi.h>
+#include <stddef.h>
+
+/*
+ * Persistent requests of the regular samples gathered in phase 2.1 and of
+ * the partitions exchanged in phase 3, set up by the first run and started
+ * again by every following one.
+ *
+ * NOTE:
+ * A request is bound to a buffer and a number of elements, so only the
+ * ones whose partition moves or changes size are made again: the sends
+ * whenever their partition does, and the receives only when a partition
+ * arrives larger than any so far, since a receive may take less than it
+ * is bound to.  The receive buffer is owned by the plan and only grows.
+ */
+struct plan {
+        MPI_Comm comm;
+        int id;
+        int process;
+        /*
+         * The samples of this process are sent from 'sample', bound to
+         * 'sample_bound' of them; root receives those of every other
+         * process into 'all_sample', 'sample_max' apart.
+         */
+        int sample_max;
+        int sample_bound;
+        long *sample;
+        long *all_sample;
+        /* Root: a receive per other process; others: a single send. */
+        MPI_Request *gather;
+        /* Elements sent to and received from each process in phase 3. */
+        int *send_count;
+        int *recv_count;
+        /*
+         * 'MPI_Alltoall_init' of the counts above with MPI-4, or
+         * 'MPI_REQUEST_NULL' if they are exchanged by 'MPI_Alltoall'.
+         */
+        MPI_Request count;
+        /* The partition each send is bound to; the room of each receive. */
+        long **send_head;
+        int *send_bound;
+        int *recv_bound;
+        long *recv;
+        size_t recv_capacity; /* In elements. */
+        /*
+         * A receive from every other process in the order of their ranks,
+         * then a send to each of them likewise; 'status' is of the former.
+         */
+        MPI_Request *exchange;
+        MPI_Status *status;
+};
+
+int plan_init(struct plan **self, MPI_Comm comm, const int sample_max);
+int plan_gather(struct plan *self,
+                struct partition *const total_samples,
+                const struct partition *const local_samples);
+int plan_exchange(struct plan *self,
+                  struct part_blk *const blk_copy,
+                  const struct part_blk *const blk);
+int plan_destroy(struct plan **self);
+
+#ifdef PLAN_ONLY
+static int plan_peer_(const struct plan *self, const int rank);
+static int plan_recv_grow_(struct plan *self);
+#endif
+
+#endif /* PLAN_H */
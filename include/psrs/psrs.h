@@ -7,11 +7,38 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/* Layout of the result written to the standard output. */
+enum output_format {
+        FORMAT_TEXT, /* Human readable table(s), or raw doubles with '-b'. */
+        FORMAT_JSON,
+        FORMAT_CSV
+};
+
+/*
+ * Maximum number of items in each of the lists given to the sweep options.
+ */
+#define SWEEP_MAX 16
+
 /*
  * Ensure all the members are of builtin types so MPI can transmit them
  * easily without worrying about custom defined types.
  */
 struct cli_arg {
+        /*
+         * Whether to sort stably, returning the original index of every
+         * element along with it, and compare it with the unstable sort.
+         */
+        unsigned int argsort;
+        /*
+         * Whether all the processes are synchronized with barriers within
+         * and between the phases of PSRS; turning it off measures the
+         * natural critical path instead.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int barrier;
         /*
          * Whether output the sorting time(s) (moving average)
          * in binary format.
@@ -21,12 +48,81 @@ struct cli_arg {
          * for MPICH.
          */
         unsigned int binary;
+        /*
+         * Whether the caches are flushed before every run, so each run
+         * starts cold instead of with the data left by the previous one.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int cold;
+        /*
+         * Whether the calls, bytes and blocking time of every MPI function
+         * are accounted for each phase (through the PMPI layer).
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int comm;
+        /*
+         * Whether hardware performance counters are read for each phase.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int counter;
+        /* One of 'enum array_dist' defined in 'include/psrs/generator.h'. */
+        unsigned int dist;
+        /* One of 'enum output_format'. */
+        unsigned int format;
+        /*
+         * Number of groups the processes are split into, each of which
+         * sorts a table of its own concurrently with all the others; 0 if
+         * the processes sort a single array together.
+         */
+        unsigned int group;
         /*
          * Contrary to common practice these days, the 'count' formal parameter
          * of 'MPI_Send' is of 'int' type instead of 'size_t', so here a
          * similar convention needs to be maintained.
          */
         int length;
+        /*
+         * Bytes a process may receive at once in phase 3, which turns on
+         * the memory-bounded mode; 0 if it is off.
+         */
+        unsigned long mem_limit;
+        /*
+         * Whether the memory of every process is recorded at the end of
+         * each phase.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int memory;
+        /*
+         * Whether runs that are outliers by their median absolute
+         * deviation are left out of the statistics.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int outlier;
+        /*
+         * Whether the samples and the partitions travel through requests
+         * made once and started by every run (see 'include/psrs/plan.h'),
+         * instead of being sent afresh each time.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int persistent;
         /*
          * Whether output the sorting time(s) (moving average)
          * in a per-phase format.
@@ -36,18 +132,146 @@ struct cli_arg {
          * for MPICH.
          */
         unsigned int phase;
+        /*
+         * Whether every process is pinned to a CPU of its own.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int pin;
+        /*
+         * Number of sorts in flight at once when the phases of consecutive
+         * sorts overlap (see 'include/psrs/pipeline.h'), compared with
+         * running them back to back; 0 if off.
+         */
+        unsigned int pipeline;
+        /*
+         * Bytes of payload of the records that are sorted, both carried
+         * along with their keys and fetched after them (see
+         * 'include/psrs/record.h'), one size after another; 0 sizes if
+         * plain elements are sorted instead.
+         */
+        int record[SWEEP_MAX];
+        unsigned int record_count;
         unsigned int run;
         unsigned int seed;
+        /*
+         * Number of independent segments of equal length the array is
+         * sorted as, both in a single pass and one after another; 0 if it
+         * is sorted as a whole.
+         */
+        unsigned int segment;
+        /*
+         * Whether the processes stay up and sort the jobs written into the
+         * FIFO at 'serve_path' one after another (see
+         * 'include/psrs/serve.h'), instead of the single case given by the
+         * other arguments.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int serve;
+        /*
+         * Path of the FIFO the jobs are read from, which points into 'argv'
+         * directly.
+         *
+         * NOTE: It is only set on root, which is the only process that
+         * reads the jobs; it is not transmitted to any other process.
+         */
+        const char *serve_path;
+        /*
+         * Whether every combination of 'sweep_length', 'sweep_dist' and
+         * 'sweep_process' is sorted in turn within a single launch, instead
+         * of the single case given by 'length', 'dist' and 'process'.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int sweep;
+        int sweep_length[SWEEP_MAX];
+        unsigned int sweep_length_count;
+        unsigned int sweep_dist[SWEEP_MAX];
+        unsigned int sweep_dist_count;
+        /*
+         * Each number of processes is no more than the number of processes
+         * launched; the cases of a smaller number run on a sub-communicator
+         * of the ranks below it.
+         */
+        int sweep_process[SWEEP_MAX];
+        unsigned int sweep_process_count;
+        /*
+         * Whether a timeline of every process is written into 'trace_file'.
+         *
+         * NOTE: This is a boolean variable; however its actual type is
+         * not 'bool' because there is no 'MPI_BOOL' data type built-in
+         * for MPICH.
+         */
+        unsigned int trace;
+        /*
+         * Path of the trace written, which points into 'argv' directly.
+         *
+         * NOTE: It is only set on root, which is the only process that
+         * writes the file; it is not transmitted to any other process.
+         */
+        const char *trace_file;
+        /*
+         * Type of the keys sorted, one of 'enum key_type'; any other than
+         * 'KEY_LONG' is sorted through the kernels generated for it (see
+         * 'include/psrs/key.h') rather than the rest of the program.
+         */
+        unsigned int type;
         /*
          * 'process' is not a command line parameter directly supplied to the
          * program itself, but 'mpiexec' instead.
          */
         int process;
+        /* Number of runs before the measured ones that are thrown away. */
+        unsigned int warmup;
         unsigned int window;
 };
 
 #ifdef PSRS_PSRS_ONLY
+/*
+ * Options that change what a launch measures or how it reports it, which
+ * not all go along with each other (see 'argument_conflict_check').
+ */
+enum cli_option {
+        CLI_SWEEP,
+        CLI_BINARY,
+        CLI_TRACE,
+        CLI_PHASE,
+        CLI_COUNTERS,
+        CLI_COMM,
+        CLI_MEMORY,
+        CLI_COLD,
+        CLI_GROUPS,
+        CLI_SERVE,
+        CLI_SEGMENTS,
+        CLI_PIPELINE,
+        CLI_PERSISTENT,
+        CLI_TYPE,
+        CLI_RECORDS,
+        CLI_ARGSORT,
+        CLI_MEM_LIMIT,
+        CLI_OPTION_COUNT
+};
+
+/* Bit of an option of 'enum cli_option' within a mask. */
+#define CLI_BIT(option) (1UL << (option))
+
 static int argument_parse(struct cli_arg *result, int argc, char *argv[]);
+static int argument_list_parse(int list[const],
+                               unsigned int *const count,
+                               const char *const candidate);
+static int argument_dist_list_parse(unsigned int list[const],
+                                    unsigned int *const count,
+                                    const char *const candidate);
+static unsigned long argument_option_given(const struct cli_arg *arg);
+static void argument_conflict_check(const struct cli_arg *arg,
+                                    const char *name);
 static void argument_bcast(struct cli_arg *arg);
 static void usage_show(const char *name, int status, const char *msg);
 #endif
@@ -0,0 +1,90 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "macro.h"
+#include "arena.h"
+
+#include <mpi.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bytes of payload a record may carry, in steps of 'RECORD_PAYLOAD_MIN'. */
+#define RECORD_PAYLOAD_MIN 8U
+#define RECORD_PAYLOAD_MAX 120U
+
+/*
+ * How 'record_sort' moves the payloads along with the keys.
+ *
+ * NOTE:
+ * 'RECORD_PERMUTE' sorts (key, origin) pairs instead, where the origin
+ * tells the rank and the index a record starts off at, then every process
+ * asks for the payloads of the pairs it ends up with: the local sort and
+ * the merges move 16 bytes per record whatever the payload, but the pairs
+ * and the indices asked for take 2 more exchanges.
+ */
+enum record_strategy {
+        RECORD_CARRY,   /* The whole records go through every phase. */
+        RECORD_PERMUTE, /* Keys are sorted first, payloads fetched after. */
+        RECORD_STRATEGY_COUNT
+};
+
+/*
+ * A record is an 'int64_t' key followed by 'payload' bytes, with no
+ * padding in between; 'datatype' is the MPI data type of a record,
+ * 'payload_type' that of its payload alone, and 'pair_type' that of the
+ * (key, origin) pairs of 'RECORD_PERMUTE'.
+ */
+struct record_layout {
+        size_t payload;
+        size_t size; /* Bytes of a whole record. */
+        MPI_Datatype datatype;
+        MPI_Datatype payload_type;
+        MPI_Datatype pair_type;
+};
+
+/* What 'record_sort' leaves on each process. */
+struct record_sorted {
+        unsigned char *head; /* The sorted records of this process. */
+        int size;
+        /* Bytes sent to the other processes, over all the exchanges. */
+        double sent;
+};
+
+int record_layout_init(struct record_layout *self, const size_t payload);
+int record_layout_destroy(struct record_layout *self);
+int64_t record_key(const unsigned char *record);
+const char *record_strategy_name(const enum record_strategy strategy);
+int record_sort(struct record_sorted *out,
+                MPI_Comm comm,
+                const struct record_layout *layout,
+                const enum record_strategy strategy,
+                unsigned char *block,
+                const int size,
+                struct arena *arena);
+int record_pair_sort(struct record_sorted *out,
+                     MPI_Comm comm,
+                     const struct record_layout *layout,
+                     unsigned char *pair,
+                     const int size,
+                     struct arena *arena);
+
+#ifdef RECORD_ONLY
+static int record_origin_compare_(const void *left, const void *right);
+static int record_compare_(const void *left, const void *right);
+static int record_psrs_(struct record_sorted *out,
+                        MPI_Comm comm,
+                        const size_t item,
+                        MPI_Datatype datatype,
+                        int (*compare)(const void *, const void *),
+                        unsigned char *block,
+                        const int size,
+                        struct arena *arena);
+static int record_fetch_(struct record_sorted *out,
+                         MPI_Comm comm,
+                         const struct record_layout *layout,
+                         const struct record_sorted *pairs,
+                         const unsigned char *block,
+                         struct arena *arena);
+#endif
+
+#endif /* RECORD_H */
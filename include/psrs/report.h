@@ -0,0 +1,102 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "macro.h"
+#include "affinity.h"
+#include "psrs.h"
+#include "serve.h"
+#include "sort.h"
+
+#include <mpi.h>
+#include <stdio.h>
+
+/*
+ * Version of the layout written by 'report_json_write' and
+ * 'report_csv_write'; bumped whenever a field is renamed or removed, so
+ * results written by older builds can still be told apart.
+ */
+#define REPORT_SCHEMA 1
+
+/* Description of the environment a result is obtained from. */
+struct report_meta {
+        int process; /* Number of processes. */
+        int node; /* Number of distinct hosts among the processes. */
+        /*
+         * Host name of each process in the order of rank;
+         * only filled in on root.
+         */
+        char (*host)[MPI_MAX_PROCESSOR_NAME];
+        /*
+         * CPUs each process is allowed to run on, in the order of rank;
+         * only filled in on root.
+         */
+        char (*affinity)[AFFINITY_SIZE];
+        char cpu[256];
+        char mpi[MPI_MAX_LIBRARY_VERSION_STRING];
+};
+
+int report_meta_init(struct report_meta *self, MPI_Comm comm);
+int report_meta_destroy(struct report_meta *self);
+int report_json_write(FILE *stream,
+                      const struct sort_result *result,
+                      const struct cli_arg *arg,
+                      const struct report_meta *meta);
+int report_csv_write(FILE *stream,
+                     const struct sort_result *result,
+                     const struct cli_arg *arg,
+                     const struct report_meta *meta);
+int report_sweep_begin(FILE *stream, const struct cli_arg *arg);
+int report_sweep_write(FILE *stream,
+                       const unsigned int id,
+                       const struct sort_result *result,
+                       const struct cli_arg *arg,
+                       const struct report_meta *meta);
+int report_sweep_end(FILE *stream, const struct cli_arg *arg);
+int report_batch_write(FILE *stream,
+                       const struct batch_result *result,
+                       const struct cli_arg *arg,
+                       const struct report_meta *meta);
+int report_segment_write(FILE *stream,
+                         const struct segment_result *result,
+                         const struct cli_arg *arg,
+                         const struct report_meta *meta);
+int report_pipeline_write(FILE *stream,
+                          const struct pipeline_result *result,
+                          const struct cli_arg *arg,
+                          const struct report_meta *meta);
+int report_key_write(FILE *stream,
+                     const struct key_result *result,
+                     const struct cli_arg *arg,
+                     const struct report_meta *meta);
+int report_record_write(FILE *stream,
+                        const struct record_result *result,
+                        const struct cli_arg *arg,
+                        const struct report_meta *meta);
+int report_argsort_write(FILE *stream,
+                         const struct argsort_result *result,
+                         const struct cli_arg *arg,
+                         const struct report_meta *meta);
+int report_serve_begin(FILE *stream,
+                       const struct cli_arg *arg,
+                       const struct report_meta *meta);
+int report_serve_write(FILE *stream,
+                       const struct serve_record *record,
+                       const struct cli_arg *arg);
+int report_serve_end(FILE *stream,
+                     const struct serve_result *result,
+                     const struct cli_arg *arg);
+
+#ifdef REPORT_ONLY
+static void report_cpu_read_(char cpu[const], const size_t size);
+static void json_string_write_(FILE *stream, const char *str);
+static void json_stats_write_(FILE *stream, const double stats[const]);
+static void csv_string_write_(FILE *stream, const char *str);
+static void json_header_write_(FILE *stream,
+                               const struct cli_arg *arg,
+                               const struct report_meta *meta);
+static void csv_header_write_(FILE *stream,
+                              const struct cli_arg *arg,
+                              const struct report_meta *meta);
+#endif
+
+#endif /* REPORT_H */
@@ -8,43 +8,30 @@
 typedef void *(*ring_alloc_t)(size_t size);
 typedef void (*ring_free_t)(void *ptr);
 
-struct ring_node {
-        void *data;
-        struct ring_node *next;
-};
-
-struct ring_iter {
-        struct ring_node *pos;
-};
-
+/*
+ * A fixed-capacity circular buffer of equally sized slots stored in one
+ * contiguous block: adding an element is a single 'memcpy' into the slot
+ * next in line, overwriting the oldest one once the ring is full.
+ */
 struct ring {
-        size_t length;
+        size_t length; /* Number of slots. */
+        size_t size; /* Size of each slot in bytes. */
+        size_t pos; /* Index of the slot to be written next. */
+        size_t count; /* Number of slots holding data; at most 'length'. */
         ring_alloc_t alloc;
         ring_free_t clean;
-        struct ring_node *head;
-        struct ring_node *pos;
+        unsigned char *data;
 };
 
 int ring_init(struct ring **self,
               const size_t length,
+              const size_t size,
               ring_alloc_t alloc,
               ring_free_t clean);
-int ring_add(struct ring *self, const void *data, const size_t size);
+int ring_add(struct ring *self, const void *data, void *evicted);
+int ring_get(const struct ring *self, const size_t index, void *data);
 int ring_length(const struct ring *self, size_t *length);
+int ring_count(const struct ring *self, size_t *count);
 int ring_destroy(struct ring **self);
 
-int ring_iter_init(struct ring_iter **self, const struct ring *circle);
-int ring_iter_walk(struct ring_iter *self, void **data);
-int ring_iter_destroy(struct ring_iter **self);
-
-#ifdef RING_ONLY
-static int ring_node_init_(struct ring_node **self, ring_alloc_t alloc);
-static int ring_node_fill_(struct ring_node *self,
-                           const void *data,
-                           const size_t size,
-                           ring_alloc_t alloc,
-                           ring_free_t clean);
-static int ring_node_destroy_(struct ring_node **self, ring_free_t clean);
-#endif
-
 #endif /* RING_H */
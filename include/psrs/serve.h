@@ -0,0 +1,98 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+#include "macro.h"
+
+#include <stddef.h>
+
+/* Longest job descriptor accepted, including its newline. */
+#define SERVE_LINE_MAX 256U
+
+/* A single sort requested through the FIFO of a 'serve_queue'. */
+struct serve_job {
+        unsigned int id; /* In the order of arrival, counting from 0. */
+        int length;
+        unsigned int seed;
+        unsigned int dist; /* One of 'enum array_dist'. */
+        /* 'MPI_Wtime' of root when the descriptor was read. */
+        double arrival;
+};
+
+/*
+ * The jobs written into a FIFO that are not served yet, in the order of
+ * arrival; only root has one.
+ *
+ * Every line written into the FIFO describes a job as
+ * "LENGTH [SEED [DIST]]", where the seed and the distribution default to
+ * the ones given on the command line; "quit" stops the service once the
+ * jobs before it are served.  Empty lines and lines starting with '#' are
+ * ignored, and malformed ones are reported on the standard error and
+ * skipped.
+ */
+struct serve_queue {
+        const char *path;
+        /* -1 while there is no writer the FIFO is open for. */
+        int fd;
+        /* Whether the FIFO is created (and later removed) by the queue. */
+        unsigned int created;
+        /* Whether "quit" has been read. */
+        unsigned int stopped;
+        unsigned int seed;
+        unsigned int dist;
+        unsigned int next_id;
+        /* The last line read so far, which lacks its newline yet. */
+        char line[SERVE_LINE_MAX];
+        size_t line_size;
+        /* Whether the rest of the current line is too long and ignored. */
+        unsigned int discard;
+        /* Ring of 'capacity' jobs, 'count' of which start at 'head'. */
+        struct serve_job *job;
+        size_t head;
+        size_t count;
+        size_t capacity;
+};
+
+/*
+ * What is reported of a single job served; the times are in seconds of
+ * root, and the sort takes as long as its slowest process.
+ */
+struct serve_record {
+        struct serve_job job;
+        /* Jobs still waiting in the queue when this one is started. */
+        unsigned int queued;
+        double wait;    /* From its arrival to its start. */
+        double setup;   /* Generating and scattering its table. */
+        double sort;    /* 'psrs_sort'. */
+        double latency; /* From its arrival to its end. */
+};
+
+/* Enumerates the times of 'struct serve_record' that are summarized. */
+enum serve_time {
+        SERVE_WAIT,
+        SERVE_SETUP,
+        SERVE_SORT,
+        SERVE_LATENCY,
+        SERVE_TIME_COUNT
+};
+
+int serve_queue_init(struct serve_queue **self,
+                     const char *const path,
+                     const unsigned int seed,
+                     const unsigned int dist);
+int serve_queue_next(struct serve_queue *self, struct serve_job *job);
+int serve_queue_destroy(struct serve_queue **self);
+
+#ifdef SERVE_ONLY
+static int serve_queue_read_(struct serve_queue *self, const int timeout);
+static void serve_queue_scan_(struct serve_queue *self,
+                              const char *data,
+                              size_t size,
+                              const double arrival);
+static int serve_line_parse_(struct serve_queue *self,
+                             char *line,
+                             const double arrival);
+static int serve_queue_push_(struct serve_queue *self,
+                             const struct serve_job *job);
+#endif
+
+#endif /* SERVE_H */
@@ -2,8 +2,16 @@
 #define SORT_H
 
 #include "macro.h"
-#include "list.h"
+#include "arena.h"
+#include "comm.h"
+#include "key.h"
+#include "memory.h"
 #include "psrs.h"
+#include "record.h"
+#include "serve.h"
+#include "stats.h"
+#include "timing.h"
+#include "trace.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -14,18 +22,70 @@ struct partition {
 };
 
 struct part_blk {
-        bool clean; /* Whether 'free' needs to be called for each 'part'. */
         int size; /* Number of partitions. */
         struct partition part[]; /* Flexible array of 'partition's. */
 };
 
+/* Defined in 'include/psrs/plan.h', which needs the 2 above. */
+struct plan;
+
 struct process_arg {
         unsigned int root;
-        int id; /* Rank of the process. */
+        /* Whether barriers are issued within and between phases. */
+        unsigned int barrier;
+        /*
+         * Seconds spent in the barriers since the current sub-phase began,
+         * which 'psort_start' takes out of the time of the sub-phase; 'NULL'
+         * outside of 'psort_start'.
+         */
+        double *barrier_wait;
+        /* Communicator of all the processes taking part in the sort. */
+        MPI_Comm comm;
+        int id; /* Rank of the process within 'comm'. */
         int process; /* Total number of processes. */
         long *head; /* Starting address of the individual array. */
+        /*
+         * Serves every working buffer of a single run; it is reset by
+         * 'parallel_sort' between runs rather than freed piece by piece.
+         */
+        struct arena *arena;
+        /* Events of this process; 'NULL' unless tracing is turned on. */
+        struct trace *trace;
+        /*
+         * Hardware counters of this process and the events counted so far
+         * for each phase; 'NULL' unless the counters are turned on.
+         */
+        struct timing_counter *counter;
+        double (*count)[COUNTER_COUNT];
+        /*
+         * Memory of this process at the end of each phase (the largest
+         * over the runs so far), and the state at the beginning of the
+         * current phase; 'NULL' unless memory instrumentation is turned on.
+         */
+        double (*memory)[MEMORY_STAT_SIZE];
+        double memory_mark[MEMORY_STAT_SIZE];
         int size; /* Size of the individual array to be sorted. */
+        /*
+         * Whether every process brings its own block in 'head' and keeps
+         * its part of the result, rather than root scattering the array
+         * and gathering the result (see 'psrs_sort').
+         */
+        unsigned int distributed;
+        /* Elements this process holds after phase 4.1, and their number. */
+        long *merged;
+        int merged_size;
         int max_sample_size;
+        /*
+         * Largest number of elements received in a single message in
+         * phase 3, or 0 if it is unbounded; any other value turns on the
+         * memory-bounded mode (see 'partition_exchange_bounded').
+         */
+        int chunk_limit;
+        /*
+         * Persistent requests of phases 2.1 and 3, set up once for all the
+         * runs of 'parallel_sort'; 'NULL' unless they are turned on.
+         */
+        struct plan *plan;
         /*
          * Total size of the array to be sorted;
          * 'total_size' should be equal to the sum of the 'size' member
@@ -34,14 +94,29 @@ struct process_arg {
         int total_size;
 };
 
+/*
+ * Statistics of a series of sorting times over the moving window;
+ * 'CI95_LOW' and 'CI95_HIGH' bound the 95% confidence interval of the mean.
+ *
+ * NOTE:
+ * The order is also the order of the values in the binary output, so
+ * 'MEAN' and 'STDEV' must stay first.
+ */
 enum sort_stat {
         MEAN,
         STDEV,
+        MIN,
+        MAX,
+        MEDIAN,
+        P90,
+        P99,
+        CI95_LOW,
+        CI95_HIGH,
         SORT_STAT_SIZE
 };
 /*
  * Used for indexing the array passed as a parameter to 'psort_launch'
- * and 'parallel_sort'.
+ * and the 'phase' member of 'struct sort_result'.
  *
  * NOTE:
  * Both 'psort_launch' and 'parallel_sort' calculate per-phase sorting time
@@ -56,92 +131,559 @@ enum psrs_phase {
         PHASE_COUNT
 };
 
+/*
+ * Used for indexing the array of sub-phase times each process records for
+ * itself and the 'subphase' member of 'struct sort_result'.
+ */
+enum psrs_subphase {
+        SUB_SCATTER,       /* Phase 1.1 */
+        SUB_LOCAL_SORT,    /* Phase 1.2 */
+        SUB_SAMPLING,      /* Phase 1.3 */
+        SUB_GATHER,        /* Phase 2.1 */
+        SUB_PIVOT,         /* Phase 2.2 */
+        SUB_PARTITION,     /* Phase 2.3 */
+        SUB_EXCHANGE,      /* Phase 3 */
+        SUB_MERGE,         /* Phase 4.1 */
+        SUB_RESULT_GATHER, /* Phase 4.2 */
+        SUBPHASE_COUNT
+};
+
+/* Number of values recorded per run in 'sample' of 'struct sort_result'. */
+#define SAMPLE_SIZE (PHASE_COUNT + 1)
+
+/*
+ * With outlier rejection turned on, a run is left out of the statistics if
+ * its modified z-score exceeds this (as recommended by Iglewicz and
+ * Hoaglin).
+ */
+#define OUTLIER_LIMIT 3.5
+
+/* How a per-process value is summarized across all the processes. */
+enum rank_stat {
+        RANK_MIN,
+        RANK_AVG,
+        RANK_MAX,
+        RANK_STAT_SIZE
+};
+
+struct sort_result {
+        /* Statistics of the total sorting time. */
+        double total[SORT_STAT_SIZE];
+        /*
+         * Statistics of the sorting time of each phase;
+         * not filled in for the one-process sequential sort.
+         */
+        double phase[PHASE_COUNT][SORT_STAT_SIZE];
+        /*
+         * The mean time of each sub-phase over the moving window, which
+         * each process records on its own, summarized across processes;
+         * not filled in for the one-process sequential sort either.
+         */
+        double subphase[SUBPHASE_COUNT][RANK_STAT_SIZE];
+        /*
+         * The mean number of hardware events per run of each phase,
+         * summarized across processes; only filled in if the counters are
+         * turned on, and bit 'i' of 'counter_available' is set only if the
+         * 'i'-th counter of 'enum timing_counter_kind' worked on every
+         * process.
+         */
+        double counter[PHASE_COUNT][COUNTER_COUNT][RANK_STAT_SIZE];
+        unsigned int counter_available;
+        /*
+         * The mean calls, bytes and time per run within each MPI function
+         * of each phase, summarized across processes; only filled in if the
+         * communication accounting is turned on (see 'include/psrs/comm.h'
+         * for what is accounted).
+         */
+        double comm[PHASE_COUNT][COMM_FUNC_COUNT][COMM_STAT_SIZE]
+                   [RANK_STAT_SIZE];
+        /*
+         * The share (in percent) of its own time in each phase a process
+         * spends within MPI calls other than 'MPI_Barrier', over all the
+         * measured runs, summarized across processes; the time in a phase
+         * is the sum of the sub-phases, which leaves out the barrier waits
+         * as well (see 'subphase_lap').  Only filled in along with 'comm'.
+         */
+        double comm_share[PHASE_COUNT][RANK_STAT_SIZE];
+        /*
+         * The memory of each process at the end of each phase, the largest
+         * over the runs, summarized across processes: the bytes and the
+         * number of allocations made within the phase, and the bytes in use
+         * or resident at its end; only filled in if memory instrumentation
+         * is turned on.
+         */
+        double memory[PHASE_COUNT][MEMORY_STAT_SIZE][RANK_STAT_SIZE];
+        /*
+         * Number of elements each process ends up with after the partition
+         * exchange, summarized across processes (the load balance achieved
+         * by the pivots); not filled in for the one-process sequential sort.
+         */
+        double load[RANK_STAT_SIZE];
+        /*
+         * Bytes of working memory the largest process needs at most in the
+         * memory-bounded mode; 0 if the mode is off.
+         */
+        double mem_bound;
+        /*
+         * The raw sorting time of every run (not only the ones within the
+         * moving window) on root, in the order of the runs: the time of
+         * each phase (0 for the one-process sequential sort) followed by
+         * the total; 'sample_count' rows in all.
+         */
+        double (*sample)[SAMPLE_SIZE];
+        unsigned int sample_count;
+        /*
+         * Number of runs within the moving window left out of the
+         * statistics as outliers, in the same order as a row of 'sample';
+         * always 0 unless outlier rejection is turned on.
+         */
+        unsigned int rejected[SAMPLE_SIZE];
+};
+
+/*
+ * Outcome of a batch of independent sorts run concurrently by groups of
+ * processes (see the 'group' member of 'struct cli_arg'), on root.
+ */
+struct batch_result {
+        unsigned int group; /* Number of groups. */
+        int group_process; /* Number of processes of each group. */
+        unsigned int sorts; /* Measured sorts of all the groups together. */
+        /*
+         * Seconds from the beginning of the first measured sort to the end
+         * of the last one, over all the groups.
+         */
+        double wall;
+        double throughput; /* 'sorts' per second of 'wall'. */
+        /*
+         * Statistics of the time of a single sort (that of the slowest
+         * process of the group) for each group, and the number of runs
+         * left out of them as outliers; 'group' of each.
+         */
+        double (*stats)[SORT_STAT_SIZE];
+        unsigned int *rejected;
+};
+
+/*
+ * Outcome of sorting the array as independent segments (see the 'segment'
+ * member of 'struct cli_arg'), on root.
+ */
+struct segment_result {
+        unsigned int segment; /* Number of segments. */
+        int segment_length; /* Number of elements of each segment. */
+        /*
+         * Statistics of the time to sort all the segments (that of the
+         * slowest process), in a single pass and one segment after another,
+         * and the number of runs left out of each as outliers.
+         */
+        double batched[SORT_STAT_SIZE];
+        double serial[SORT_STAT_SIZE];
+        unsigned int batched_rejected;
+        unsigned int serial_rejected;
+};
+
+/* The 2 ways 'pipeline_launch' runs the same jobs. */
+enum pipeline_mode {
+        PIPELINE_SERIAL,    /* Back to back. */
+        PIPELINE_OVERLAP,   /* With their phases overlapped. */
+        PIPELINE_MODE_COUNT
+};
+
+/*
+ * Outcome of running sorts pipelined (see the 'pipeline' member of
+ * 'struct cli_arg'), and back to back for comparison, on root.
+ */
+struct pipeline_result {
+        unsigned int depth; /* Jobs in flight at once when overlapped. */
+        unsigned int jobs; /* Measured jobs of each mode. */
+        /*
+         * Seconds from the start of the first measured job to the end of
+         * the last one, and 'jobs' per second of it, for each mode.
+         */
+        double wall[PIPELINE_MODE_COUNT];
+        double throughput[PIPELINE_MODE_COUNT];
+        /*
+         * Statistics of the time from the start to the end of a job (that
+         * of the slowest process), and the number of jobs left out of them
+         * as outliers, for each mode.
+         */
+        double latency[PIPELINE_MODE_COUNT][SORT_STAT_SIZE];
+        unsigned int rejected[PIPELINE_MODE_COUNT];
+};
+
+/*
+ * Outcome of sorting keys of a type other than 'long' (see the 'type'
+ * member of 'struct cli_arg'), on root.
+ */
+struct key_result {
+        unsigned int type; /* One of 'enum key_type'. */
+        size_t size; /* Bytes of a key. */
+        /*
+         * Statistics of the time of a sort (that of the slowest process),
+         * and the number of sorts left out of them as outliers.
+         */
+        double time[SORT_STAT_SIZE];
+        unsigned int rejected;
+        double throughput; /* Keys per second, by the mean time. */
+        /* Bytes a process sends to the others per sort, on average. */
+        double sent;
+        double sent_max; /* Bytes sent by the process that sends most. */
+};
+
+/*
+ * Outcome of sorting records of every payload size (see the 'record'
+ * member of 'struct cli_arg') by either strategy, on root; the latter
+ * index of each array is one of 'enum record_strategy'.
+ */
+struct record_result {
+        unsigned int count; /* Payload sizes measured. */
+        int payload[SWEEP_MAX];
+        size_t size[SWEEP_MAX]; /* Bytes of a record. */
+        /* As in 'struct key_result'. */
+        double time[SWEEP_MAX][RECORD_STRATEGY_COUNT][SORT_STAT_SIZE];
+        unsigned int rejected[SWEEP_MAX][RECORD_STRATEGY_COUNT];
+        double throughput[SWEEP_MAX][RECORD_STRATEGY_COUNT]; /* Records/s. */
+        /* Bytes a process sends to the others per sort, on average. */
+        double sent[SWEEP_MAX][RECORD_STRATEGY_COUNT];
+};
+
+/* The 2 ways 'argsort_launch' sorts the same table. */
+enum argsort_mode {
+        ARGSORT_SORT,   /* 'psrs_sort', unstable. */
+        ARGSORT_STABLE, /* 'psrs_argsort', stable and with the indices. */
+        ARGSORT_MODE_COUNT
+};
+
+/*
+ * Outcome of sorting the array both ways (see the 'argsort' member of
+ * 'struct cli_arg'), on root.
+ */
+struct argsort_result {
+        /* As in 'struct key_result', for each mode. */
+        double time[ARGSORT_MODE_COUNT][SORT_STAT_SIZE];
+        unsigned int rejected[ARGSORT_MODE_COUNT];
+        double throughput[ARGSORT_MODE_COUNT]; /* Elements per second. */
+        /* Mean time of 'ARGSORT_STABLE' over that of 'ARGSORT_SORT'. */
+        double overhead;
+};
+
+/*
+ * Outcome of a service of sorts (see the 'serve' member of
+ * 'struct cli_arg'), on root.
+ */
+struct serve_result {
+        unsigned int jobs; /* Jobs served, the warm-up ones included. */
+        /*
+         * Jobs after the warm-up ones; the statistics cover the last
+         * 'window' of them at most.
+         */
+        unsigned int measured;
+        unsigned int queued_max; /* Most jobs ever waiting at once. */
+        /* Seconds spent serving the measured jobs, from start to end. */
+        double busy;
+        double throughput; /* 'measured' jobs per second of 'busy'. */
+        /* Statistics of each time of 'enum serve_time'. */
+        double time[SERVE_TIME_COUNT][SORT_STAT_SIZE];
+};
+
 void
 sort_launch(const struct cli_arg *const arg);
 
+void
+psort_start(double elapsed[const],
+            double lap[const],
+            long array[const],
+            struct process_arg *const arg);
+
 int
-part_blk_init(struct part_blk **self, bool clean, int size);
+part_blk_init(struct part_blk **self, struct arena *arena, int size);
 
+/*
+ * Kernels of the phases, which do not communicate (unless the barriers of
+ * 'arg' are turned on); they are exposed so that 'psrs_bench' can measure
+ * them in isolation, and so that the pipeline (see
+ * 'include/psrs/pipeline.h') can run them between collectives of its own.
+ */
+
+/* Phase 1.2 and the one-process sequential sort, through 'qsort'. */
 int
-part_blk_destroy(struct part_blk **self);
+long_compare(const void *left, const void *right);
+
+/* Phase 1.2 */
+void
+local_sort(const struct process_arg *const arg);
+
+/* Phase 1.3 */
+void
+local_sample(struct partition *const local_samples,
+             const struct process_arg *const arg);
+
+/* Phase 2.2, on root only */
+void
+pivots_pick(struct partition *const pivots,
+            struct partition *const total_samples,
+            const struct process_arg *const arg);
+
+/* Phase 2.3 */
+void
+partition_form(struct part_blk *const blk,
+               struct partition *const pivots,
+               const struct process_arg *const arg);
+
+/* Phase 4.1 */
+void
+partition_merge(struct partition *const merged,
+                struct part_blk *blk_copy,
+                const struct process_arg *const arg);
+
+int
+array_merge(long output[const],
+            const long left[const],
+            const size_t lsize,
+            const long right[const],
+            const size_t rsize);
+
+int
+array_merge_back(long inout[const],
+                 const size_t lsize,
+                 const long right[const],
+                 const size_t rsize);
+
+int
+bin_search(int *const index,
+           const long value,
+           const long array[const],
+           const int size);
 
 #ifdef PSRS_SORT_ONLY
+/* Defined in 'include/psrs/report.h'. */
+struct report_meta;
+/* Defined in 'include/psrs/libpsrs.h'. */
+struct psrs_result;
+
+static void
+sweep_launch(const struct cli_arg *const arg);
+
+static void
+batch_launch(const struct cli_arg *const arg);
+
+static void
+serve_launch(const struct cli_arg *const arg);
+
 static void
-output_write(double data[const], const struct cli_arg *const arg);
+segment_launch(const struct cli_arg *const arg);
+
+static void
+pipeline_launch(const struct cli_arg *const arg);
+
+static void
+key_launch(const struct cli_arg *const arg);
+
+static void
+record_launch(const struct cli_arg *const arg);
+
+static void
+record_case_run(struct record_result *const result,
+                const unsigned int index,
+                const struct cli_arg *const arg);
+
+static void
+argsort_launch(const struct cli_arg *const arg);
+
+#ifdef PRINT_DEBUG_INFO
+static void
+key_check(const struct key_sorted *const sorted,
+          void *table,
+          const struct cli_arg *const arg);
+
+static void
+record_check(const struct record_sorted *const sorted,
+             unsigned char *table,
+             const struct record_layout *const layout,
+             const struct cli_arg *const arg);
 
 static int
-sequential_sort(double ssort_stats[const], const struct cli_arg *const arg);
+record_check_compare(const void *left, const void *right);
 
 static void
-parallel_sort(double psort_stats[const], const struct cli_arg *const arg);
+argsort_check(const struct psrs_result *const sorted,
+              const long table[const],
+              const struct cli_arg *const arg);
 
 static void
-psort_launch(double elapsed[const], const struct cli_arg *const arg);
+segment_check(const struct psrs_result *const sorted,
+              long table[const],
+              const struct cli_arg *const arg);
 
 static void
-psort_start(double elapsed[const],
-            long array[const],
-            struct process_arg *const arg);
+array_check(const long sorted[const],
+            const int size,
+            long table[const],
+            const int length,
+            MPI_Comm comm);
+#endif
+
+static void
+serve_record_add(struct serve_result *const result,
+                 struct serve_record recent[const],
+                 const struct serve_record *const record,
+                 const struct cli_arg *const arg);
+
+static void
+serve_stats_calc(struct serve_result *const result,
+                 const struct serve_record recent[const],
+                 const struct cli_arg *const arg);
+
+static void
+sweep_case_run(struct sort_result *const result,
+               struct report_meta *const meta,
+               const struct cli_arg *const arg,
+               MPI_Comm comm);
+
+static void
+output_write(const struct sort_result *const result,
+             const struct cli_arg *const arg,
+             const struct report_meta *const meta);
+
+static bool
+methodology_given(const struct cli_arg *const arg);
+
+static int
+stats_calc(double stats[const],
+           unsigned int *const rejected,
+           const struct moving_window *const window,
+           const struct cli_arg *const arg);
+
+static void
+series_stats_calc(double stats[const],
+                  unsigned int *const rejected,
+                  const double series[const],
+                  const unsigned int count,
+                  const struct cli_arg *const arg);
+
+static int
+sequential_sort(struct sort_result *const result,
+                const struct cli_arg *const arg,
+                MPI_Comm comm);
+
+static void
+parallel_sort(struct sort_result *const result,
+              const struct cli_arg *const arg,
+              MPI_Comm comm);
+
+static void
+counter_reduce(struct sort_result *const result,
+               double count[const][COUNTER_COUNT],
+               const unsigned int available,
+               const struct cli_arg *const arg,
+               MPI_Comm comm);
+
+static void
+memory_reduce(struct sort_result *const result,
+              double memory[const][MEMORY_STAT_SIZE],
+              MPI_Comm comm);
+
+static void
+comm_reduce(struct sort_result *const result,
+            const double lap_total[const],
+            const struct cli_arg *const arg,
+            MPI_Comm comm);
+
+static void
+psort_launch(double elapsed[const],
+             double lap[const],
+             const struct cli_arg *const arg,
+             struct process_arg *const process);
 
 /* Phase 1.1 */
 static void
 local_scatter(long array[const], struct process_arg *const arg);
 
-/* Phase 1.2 */
+/* Phase 2.1 */
 static void
-local_sort(struct partition *const local_samples,
-           const struct process_arg *const arg);
+samples_gather(struct partition *const total_samples,
+               struct partition *const local_samples,
+               const struct process_arg *const arg);
 
-/* Phase 2.1 - 2.2 */
+/* Phase 2.2 */
 static void
 pivots_bcast(struct partition *const pivots,
-             struct partition *const local_samples,
+             struct partition *const total_samples,
              const struct process_arg *const arg);
 
-/* Phase 2.3 */
-static void
-partition_form(struct part_blk *const blk,
-               struct partition *const pivots,
-               const struct process_arg *const arg);
-
 /* Phase 3 */
 static void
 partition_exchange(struct part_blk *const blk_copy,
                    struct part_blk *blk,
                    const struct process_arg *const arg);
 
+static void
+partition_exchange_bounded(struct part_blk *const blk_copy,
+                           struct part_blk *blk,
+                           const int recv_size[const],
+                           const struct process_arg *const arg);
+
 static void
 partition_send(struct part_blk *const blk_copy,
                struct part_blk *const blk,
                const int sid,
-               int *const pindex,
                const struct process_arg *const arg);
-/* Phase 4 */
+
 static void
-partition_merge(struct partition *const result,
-                struct part_blk *blk_copy,
-                const struct process_arg *const arg);
+partition_send_bounded(struct part_blk *const blk_copy,
+                       struct part_blk *const blk,
+                       const int sid,
+                       const int j,
+                       const struct process_arg *const arg);
 
-static int
-long_compare(const void *left, const void *right);
+static void
+array_merge_stream_back(long inout[const],
+                        size_t *const lindex,
+                        size_t *const oindex,
+                        const long right[const],
+                        const size_t rsize);
+/* Phase 4.2 */
+static void
+result_gather(struct partition *const result,
+              const struct partition *const merged,
+              const struct process_arg *const arg);
 
-static int
-array_merge(long output[const],
-            const long left[const],
-            const size_t lsize,
-            const long right[const],
-            const size_t rsize);
+static inline void
+phase_barrier(const struct process_arg *const arg);
 
-static int
-bin_search(int *const index,
-           const long value,
-           const long array[const],
-           const int size);
+static inline void
+subphase_lap(double *const lap,
+             struct timespec *const lap_start,
+             double *const barrier_wait);
+
+static inline void
+counter_begin(const struct process_arg *const arg);
+
+static inline void
+counter_end(const struct process_arg *const arg, const enum psrs_phase phase);
+
+static inline void
+memory_begin(struct process_arg *const arg);
+
+static inline void
+memory_end(struct process_arg *const arg, const enum psrs_phase phase);
+
+static inline void
+comm_mark(MPI_Comm comm, const int phase);
+
+static inline void
+comm_clear(void);
+
+static inline void
+trace_record(const struct process_arg *const arg,
+             const enum trace_kind kind,
+             const int value,
+             const double begin);
 
 static inline void
 mpi_recv_check(const MPI_Status *const status,
                MPI_Datatype datatype,
-               const int count);
+               const int count,
+               MPI_Comm comm);
 #endif
 
 #endif /* SORT_H */
@@ -6,9 +6,16 @@
 /*
  * 'moving_window' is a specialized version of 'ring': it has an extra
  * 'written' field and all the values are of double type.
+ *
+ * The mean and the sum of squared differences of the values currently in
+ * the window are maintained incrementally (Welford's method, extended to
+ * evict the oldest value once the window is full), so pushing a value and
+ * querying the mean or standard deviation are both O(1).
  */
 struct moving_window {
         struct ring *ring;
+        double mean;
+        double m2; /* Sum of squared differences from 'mean'. */
         /*
          * This field is only meaningful when there is no overflow;
          * once an overflow is about to occur, it would stay at 'SIZE_MAX'
@@ -23,5 +30,25 @@ int moving_window_destroy(struct moving_window **self);
 
 int moving_average_calc(const struct moving_window *window, double *average);
 int moving_stdev_calc(const struct moving_window *window, double *stdev);
+int moving_min_calc(const struct moving_window *window, double *min);
+int moving_max_calc(const struct moving_window *window, double *max);
+int moving_percentile_calc(const struct moving_window *window,
+                           const double percent,
+                           double *percentile);
+int moving_ci95_calc(const struct moving_window *window,
+                     double *low,
+                     double *high);
+int moving_mad_filter(const struct moving_window *window,
+                      const double limit,
+                      struct moving_window **filtered,
+                      size_t *rejected);
+
+#ifdef STATS_ONLY
+static int moving_window_sorted_(const struct moving_window *window,
+                                 double **sorted,
+                                 size_t *count);
+static int double_compare_(const void *left, const void *right);
+static double t_critical95_(const size_t freedom);
+#endif
 
 #endif /* STATS_H */
@@ -3,9 +3,61 @@
 
 #include "macro.h"
 
+#include <stddef.h>
 #include <time.h>
 
+/* Hardware events counted by 'struct timing_counter'. */
+enum timing_counter_kind {
+        COUNTER_CYCLES,
+        COUNTER_INSTRUCTIONS,
+        COUNTER_BRANCH_MISSES,
+        COUNTER_LLC_MISSES,
+        COUNTER_DTLB_MISSES,
+        COUNTER_COUNT
+};
+
+/*
+ * A set of hardware performance counters of the calling thread, opened
+ * through 'perf_event_open' on Linux.
+ *
+ * NOTE:
+ * A counter that can not be opened (unsupported hardware, virtual machines,
+ * 'perf_event_paranoid' settings, other platforms) is simply left out:
+ * its bit in 'available' is cleared and it always counts 0.
+ */
+struct timing_counter {
+        int fd[COUNTER_COUNT];
+        /* Bit 'i' is set if the 'i'-th counter is actually counting. */
+        unsigned int available;
+};
+
+/*
+ * A buffer larger than the last level cache; walking through it evicts
+ * whatever the previous run left in the caches, so the next run starts
+ * cold.
+ */
+struct timing_flush {
+        unsigned char *buffer;
+        size_t size;
+};
+
 int timing_start(struct timespec *start);
 int timing_reset(struct timespec *start);
 int timing_stop(double *elapsed, const struct timespec *start);
+int timing_lap(double *elapsed, struct timespec *start);
+int timing_counter_init(struct timing_counter *self);
+int timing_counter_start(struct timing_counter *self);
+int timing_counter_stop(struct timing_counter *self, double count[const]);
+int timing_counter_destroy(struct timing_counter *self);
+int timing_flush_init(struct timing_flush *self);
+int timing_flush(struct timing_flush *self);
+int timing_flush_destroy(struct timing_flush *self);
+
+#ifdef TIMING_ONLY
+static int timing_stop_at_(double *elapsed,
+                           const struct timespec *start,
+                           const struct timespec *end);
+static int timing_counter_open_(const enum timing_counter_kind kind);
+static size_t timing_llc_size_(void);
+#endif
 #endif /* TIMING_H */
@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "macro.h"
+
+#include <mpi.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Every kind of event recorded; the name shown in the trace viewer is
+ * looked up by kind when the trace is written, so no string is stored per
+ * event.
+ */
+enum trace_kind {
+        TRACE_RUN,
+        TRACE_PHASE1,
+        TRACE_PHASE2,
+        TRACE_PHASE3,
+        TRACE_PHASE4,
+        TRACE_BARRIER,
+        TRACE_SEND,   /* 'arg' is the rank of the receiver. */
+        TRACE_RECV,   /* 'arg' is the rank of the sender. */
+        TRACE_MERGE,  /* 'arg' is the number of elements merged. */
+        TRACE_KIND_COUNT
+};
+
+/* A complete event: both of its ends are in the local 'MPI_Wtime' clock. */
+struct trace_event {
+        double begin;
+        double end;
+        int kind;
+        int arg;
+};
+
+/*
+ * Events recorded by one process, in the order they complete; the buffer
+ * doubles in size whenever it is full.
+ */
+struct trace {
+        size_t capacity;
+        size_t count;
+        struct trace_event *event;
+};
+
+int trace_init(struct trace **self, const size_t capacity);
+int trace_add(struct trace *self,
+              const enum trace_kind kind,
+              const int arg,
+              const double begin);
+int trace_write(struct trace *self, const char *path, MPI_Comm comm);
+int trace_destroy(struct trace **self);
+
+#ifdef TRACE_ONLY
+static int trace_offset_(double *offset, MPI_Comm comm);
+static int trace_json_write_(FILE *stream,
+                             const struct trace_event event[],
+                             const size_t count,
+                             const int rank,
+                             const double origin,
+                             const int first);
+#endif
+
+#endif /* TRACE_H */
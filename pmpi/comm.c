@@ -0,0 +1,265 @@
+#include "psrs/macro.h"
+#define COMM_ONLY
+#include "psrs/comm.h"
+#undef COMM_ONLY
+
+#include <errno.h>
+#include <string.h>
+
+/*
+ * Communication accounting through the MPI profiling interface: every
+ * function below intercepts the MPI function of the same name, forwards the
+ * call to its 'PMPI_' counterpart and charges it to the phase set by
+ * 'comm_phase_set' of the calling process.
+ *
+ * NOTE:
+ * The bytes are the payload as seen by the calling process, regardless of
+ * how the MPI library actually moves it: for a rooted collective the root
+ * sends (or receives) one block to (or from) every other process, while
+ * every other process receives (or sends) a single one; the block a process
+ * keeps for itself is not counted.
+ */
+
+/* The phase the calls are charged to, or 'COMM_PHASE_NONE'. */
+static int comm_phase = COMM_PHASE_NONE;
+static double comm_count[COMM_PHASE_MAX][COMM_FUNC_COUNT][COMM_STAT_SIZE];
+
+int comm_phase_set(const int phase)
+{
+        if (COMM_PHASE_NONE > phase || COMM_PHASE_MAX <= phase) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        comm_phase = phase;
+        return 0;
+}
+
+int comm_reset(void)
+{
+        memset(comm_count, 0, sizeof comm_count);
+        return 0;
+}
+
+/*
+ * Copies what is accounted so far for the first 'phase_count' phases into
+ * 'count'.
+ */
+int comm_read(double count[const][COMM_FUNC_COUNT][COMM_STAT_SIZE],
+              const int phase_count)
+{
+        if (NULL == count || 0 > phase_count || COMM_PHASE_MAX < phase_count) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        memcpy(count, comm_count, phase_count * sizeof(comm_count[0]));
+        return 0;
+}
+
+int MPI_Send(const void *buf, int count, MPI_Datatype datatype,
+             int dest, int tag, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Send(buf, count, datatype, dest, tag, comm);
+
+        comm_account_(COMM_SEND, begin, comm_bytes_(count, datatype), 0);
+        return retval;
+}
+
+int MPI_Ssend(const void *buf, int count, MPI_Datatype datatype,
+              int dest, int tag, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Ssend(buf, count, datatype, dest, tag, comm);
+
+        comm_account_(COMM_SSEND, begin, comm_bytes_(count, datatype), 0);
+        return retval;
+}
+
+int MPI_Recv(void *buf, int count, MPI_Datatype datatype,
+             int source, int tag, MPI_Comm comm, MPI_Status *status)
+{
+        const double begin = PMPI_Wtime();
+        /* The size actually received is only known from the status. */
+        MPI_Status local;
+        MPI_Status *const actual = MPI_STATUS_IGNORE == status ?
+                                   &local : status;
+        const int retval = PMPI_Recv(buf, count, datatype,
+                                     source, tag, comm, actual);
+        int received = 0;
+
+        if (MPI_SUCCESS == retval) {
+                PMPI_Get_count(actual, datatype, &received);
+        }
+        comm_account_(COMM_RECV, begin, 0, comm_bytes_(received, datatype));
+        return retval;
+}
+
+int MPI_Barrier(MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Barrier(comm);
+
+        comm_account_(COMM_BARRIER, begin, 0, 0);
+        return retval;
+}
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype,
+              int root, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Bcast(buffer, count, datatype, root, comm);
+        const double bytes = comm_bytes_(count, datatype);
+        int rank = 0;
+        int size = 0;
+
+        PMPI_Comm_rank(comm, &rank);
+        PMPI_Comm_size(comm, &size);
+        if (root == rank) {
+                comm_account_(COMM_BCAST, begin, bytes * (size - 1), 0);
+        } else {
+                comm_account_(COMM_BCAST, begin, 0, bytes);
+        }
+        return retval;
+}
+
+int MPI_Scatter(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+                void *recvbuf, int recvcount, MPI_Datatype recvtype,
+                int root, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Scatter(sendbuf, sendcount, sendtype,
+                                        recvbuf, recvcount, recvtype,
+                                        root, comm);
+        int rank = 0;
+        int size = 0;
+
+        PMPI_Comm_rank(comm, &rank);
+        PMPI_Comm_size(comm, &size);
+        if (root == rank) {
+                comm_account_(COMM_SCATTER, begin,
+                              comm_bytes_(sendcount, sendtype) * (size - 1),
+                              0);
+        } else {
+                comm_account_(COMM_SCATTER, begin,
+                              0, comm_bytes_(recvcount, recvtype));
+        }
+        return retval;
+}
+
+int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+               void *recvbuf, int recvcount, MPI_Datatype recvtype,
+               int root, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Gather(sendbuf, sendcount, sendtype,
+                                       recvbuf, recvcount, recvtype,
+                                       root, comm);
+        int rank = 0;
+        int size = 0;
+
+        PMPI_Comm_rank(comm, &rank);
+        PMPI_Comm_size(comm, &size);
+        if (root == rank) {
+                comm_account_(COMM_GATHER, begin,
+                              0,
+                              comm_bytes_(recvcount, recvtype) * (size - 1));
+        } else {
+                comm_account_(COMM_GATHER, begin,
+                              comm_bytes_(sendcount, sendtype), 0);
+        }
+        return retval;
+}
+
+int MPI_Gatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+                void *recvbuf, const int recvcounts[], const int displs[],
+                MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Gatherv(sendbuf, sendcount, sendtype,
+                                        recvbuf, recvcounts, displs, recvtype,
+                                        root, comm);
+        int rank = 0;
+        int size = 0;
+        double received = 0;
+
+        PMPI_Comm_rank(comm, &rank);
+        PMPI_Comm_size(comm, &size);
+        if (root == rank) {
+                for (int i = 0; i < size; ++i) {
+                        if (i != rank) {
+                                received += comm_bytes_(recvcounts[i],
+                                                        recvtype);
+                        }
+                }
+                comm_account_(COMM_GATHERV, begin, 0, received);
+        } else {
+                comm_account_(COMM_GATHERV, begin,
+                              comm_bytes_(sendcount, sendtype), 0);
+        }
+        return retval;
+}
+
+int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+                 void *recvbuf, int recvcount, MPI_Datatype recvtype,
+                 MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Alltoall(sendbuf, sendcount, sendtype,
+                                         recvbuf, recvcount, recvtype,
+                                         comm);
+        int size = 0;
+
+        PMPI_Comm_size(comm, &size);
+        comm_account_(COMM_ALLTOALL, begin,
+                      comm_bytes_(sendcount, sendtype) * (size - 1),
+                      comm_bytes_(recvcount, recvtype) * (size - 1));
+        return retval;
+}
+
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
+               MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
+{
+        const double begin = PMPI_Wtime();
+        const int retval = PMPI_Reduce(sendbuf, recvbuf, count,
+                                       datatype, op, root, comm);
+        const double bytes = comm_bytes_(count, datatype);
+        int rank = 0;
+        int size = 0;
+
+        PMPI_Comm_rank(comm, &rank);
+        PMPI_Comm_size(comm, &size);
+        if (root == rank) {
+                comm_account_(COMM_REDUCE, begin, 0, bytes * (size - 1));
+        } else {
+                comm_account_(COMM_REDUCE, begin, bytes, 0);
+        }
+        return retval;
+}
+
+/* Charges a call to 'func' that started at 'begin' to the current phase. */
+static inline void comm_account_(const enum comm_func func,
+                                 const double begin,
+                                 const double sent,
+                                 const double received)
+{
+        const double end = PMPI_Wtime();
+
+        if (COMM_PHASE_NONE == comm_phase) {
+                return;
+        }
+
+        comm_count[comm_phase][func][COMM_CALLS] += 1;
+        comm_count[comm_phase][func][COMM_BYTES_SENT] += sent;
+        comm_count[comm_phase][func][COMM_BYTES_RECEIVED] += received;
+        comm_count[comm_phase][func][COMM_TIME] += end - begin;
+}
+
+static inline double comm_bytes_(const int count, MPI_Datatype datatype)
+{
+        int size = 0;
+
+        PMPI_Type_size(datatype, &size);
+        return (double)count * size;
+}
@@ -0,0 +1,131 @@
+/* 'sched_setaffinity' along with the 'CPU_*' macros are GNU extensions. */
+#define _GNU_SOURCE
+#include "psrs/macro.h"
+#define AFFINITY_ONLY
+#include "psrs/affinity.h"
+#undef AFFINITY_ONLY
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/*
+ * Collective over 'comm': pins every process to a single CPU among the ones
+ * it is allowed to run on, the 'i'-th one for the process with rank 'i'
+ * among the processes of 'comm' on the same node, so no 2 processes on a
+ * node share a CPU unless there are more processes than CPUs.
+ *
+ * NOTE: Not supported (ENOTSUP) on platforms other than Linux.
+ */
+int affinity_pin(MPI_Comm comm)
+{
+        int rank = 0;
+        int local_rank = 0;
+        MPI_Comm node = MPI_COMM_NULL;
+
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+                            MPI_INFO_NULL, &node);
+        MPI_Comm_rank(node, &local_rank);
+        MPI_Comm_free(&node);
+
+#ifdef __linux__
+        int count = 0;
+        int target = 0;
+        cpu_set_t allowed;
+        cpu_set_t pinned;
+
+        CPU_ZERO(&allowed);
+        CPU_ZERO(&pinned);
+
+        if (0 > sched_getaffinity(0, sizeof allowed, &allowed)) {
+                return -1;
+        }
+
+        count = CPU_COUNT(&allowed);
+        if (0 == count) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        target = local_rank % count;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed) && 0 == target--) {
+                        CPU_SET(cpu, &pinned);
+                        break;
+                }
+        }
+
+        if (0 > sched_setaffinity(0, sizeof pinned, &pinned)) {
+                return -1;
+        }
+        return 0;
+#else
+        errno = ENOTSUP;
+        return -1;
+#endif
+}
+
+/*
+ * Writes the list of CPUs the calling process may run on into 'list' in the
+ * form of "0-3,8"; "n/a" is written if it can not be told.
+ */
+int affinity_get(char list[const], const size_t size)
+{
+        if (NULL == list || 0U == size) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        list[0] = '\0';
+
+#ifdef __linux__
+        int first = -1;
+        cpu_set_t allowed;
+
+        CPU_ZERO(&allowed);
+
+        if (0 > sched_getaffinity(0, sizeof allowed, &allowed)) {
+                snprintf(list, size, "n/a");
+                return 0;
+        }
+
+        /* Consecutive CPUs are collapsed into a single range. */
+        for (int cpu = 0; cpu <= CPU_SETSIZE; ++cpu) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                        if (0 > first) {
+                                first = cpu;
+                        }
+                } else if (0 <= first) {
+                        affinity_range_append_(list, size, first, cpu - 1);
+                        first = -1;
+                }
+        }
+#else
+        snprintf(list, size, "n/a");
+#endif
+        return 0;
+}
+
+static void affinity_range_append_(char list[const],
+                                   const size_t size,
+                                   const int first,
+                                   const int last)
+{
+        const size_t length = strlen(list);
+
+        if (length + 1U >= size) {
+                return;
+        }
+
+        if (first == last) {
+                snprintf(list + length, size - length, "%s%d",
+                         length ? "," : "", first);
+        } else {
+                snprintf(list + length, size - length, "%s%d-%d",
+                         length ? "," : "", first, last);
+        }
+}
@@ -0,0 +1,187 @@
+#include "psrs/macro.h"
+#define ARENA_ONLY
+#include "psrs/arena.h"
+#undef ARENA_ONLY
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+int arena_init(struct arena **self, const size_t capacity)
+{
+        struct arena *arena = NULL;
+        struct arena_chunk *chunk = NULL;
+
+        if (NULL == self || 0U == capacity) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        arena = (struct arena *)malloc(sizeof(struct arena));
+
+        if (NULL == arena) {
+                return -1;
+        }
+
+        if (0 > arena_chunk_init_(&chunk, capacity)) {
+                free(arena);
+                return -1;
+        }
+
+        arena->capacity = chunk->size;
+        arena->used = 0U;
+        arena->count = 0U;
+        arena->total = 0U;
+        arena->head = chunk;
+        arena->current = chunk;
+
+        *self = arena;
+        return 0;
+}
+
+/*
+ * NOTE:
+ * The memory returned is NOT zero-initialized; it stays valid until the next
+ * 'arena_reset' or 'arena_destroy' call on 'self'.
+ *
+ * A request of 0 byte is valid (e.g. an empty partition): the address
+ * returned is aligned but must not be dereferenced.
+ */
+int arena_alloc(struct arena *self, void **ptr, const size_t size)
+{
+        struct arena_chunk *chunk = NULL;
+        size_t rounded = 0U;
+
+        if (NULL == self || NULL == ptr) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (SIZE_MAX - ARENA_ALIGN < size) {
+                errno = EOVERFLOW;
+                return -1;
+        }
+
+        rounded = (size + ARENA_ALIGN - 1U) & ~(size_t)(ARENA_ALIGN - 1U);
+
+        /*
+         * Chunks past 'current' are only left over from an earlier round,
+         * so try them in order before chaining a brand new one at the end.
+         */
+        for (chunk = self->current; NULL != chunk; chunk = chunk->next) {
+                if (chunk->size - chunk->used >= rounded) {
+                        break;
+                }
+                self->current = chunk;
+        }
+
+        if (NULL == chunk) {
+                if (0 > arena_chunk_init_(&chunk, rounded > self->capacity ?
+                                                  rounded : self->capacity)) {
+                        return -1;
+                }
+                self->current->next = chunk;
+                self->capacity += chunk->size;
+        }
+
+        *ptr = chunk->data + chunk->used;
+        chunk->used += rounded;
+        self->current = chunk;
+        self->used += rounded;
+        self->count += 1U;
+        self->total += rounded;
+        return 0;
+}
+
+/*
+ * Gives back every address handed out so far; if the previous round
+ * overflowed into extra chunks, they are folded into a single chunk large
+ * enough to serve the same workload without chaining again.
+ */
+int arena_reset(struct arena *self)
+{
+        struct arena_chunk *chunk = NULL;
+        struct arena_chunk *next = NULL;
+
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (NULL != self->head->next) {
+                if (0 > arena_chunk_init_(&chunk, self->capacity)) {
+                        return -1;
+                }
+
+                for (next = self->head; NULL != next; next = self->head) {
+                        self->head = next->next;
+                        arena_chunk_destroy_(&next);
+                }
+                self->head = chunk;
+        }
+
+        self->head->used = 0U;
+        self->current = self->head;
+        self->used = 0U;
+        return 0;
+}
+
+int arena_destroy(struct arena **self)
+{
+        struct arena *arena = NULL;
+        struct arena_chunk *chunk = NULL;
+
+        if (NULL == self || NULL == *self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        arena = *self;
+
+        for (chunk = arena->head; NULL != chunk; chunk = arena->head) {
+                arena->head = chunk->next;
+                arena_chunk_destroy_(&chunk);
+        }
+
+        free(arena);
+        *self = NULL;
+        return 0;
+}
+
+static int arena_chunk_init_(struct arena_chunk **self, const size_t size)
+{
+        struct arena_chunk *chunk = NULL;
+
+        if (NULL == self || 0U == size) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        chunk = (struct arena_chunk *)malloc(sizeof(struct arena_chunk));
+
+        if (NULL == chunk) {
+                return -1;
+        }
+
+        /* 'malloc' already returns memory suitable for any builtin type. */
+        chunk->data = (unsigned char *)malloc(size);
+
+        if (NULL == chunk->data) {
+                free(chunk);
+                return -1;
+        }
+
+        chunk->size = size;
+        chunk->used = 0U;
+        chunk->next = NULL;
+
+        *self = chunk;
+        return 0;
+}
+
+static void arena_chunk_destroy_(struct arena_chunk **self)
+{
+        free((*self)->data);
+        free(*self);
+        *self = NULL;
+}
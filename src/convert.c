@@ -5,6 +5,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 
 int int_convert(int *number, const char *const candidate)
 {
@@ -108,3 +109,37 @@ int sizet_convert(size_t *size, const char *const candidate)
         return 0;
 }
 
+/*
+ * Splits the comma-separated list 'str' IN PLACE: 'token' receives the
+ * address of each of the (at most 'max') items, and 'count' their number.
+ *
+ * NOTE: Empty items (e.g. "1,,2") are skipped; more than 'max' items is an
+ * error.
+ */
+int token_split(char *const str,
+                char *token[const],
+                unsigned int *const count,
+                const unsigned int max)
+{
+        char *save = NULL;
+        char *item = NULL;
+        unsigned int total = 0U;
+
+        if (NULL == str || NULL == token || NULL == count) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (item = strtok_r(str, ",", &save);
+             NULL != item;
+             item = strtok_r(NULL, ",", &save)) {
+                if (max == total) {
+                        errno = E2BIG;
+                        return -1;
+                }
+                token[total++] = item;
+        }
+
+        *count = total;
+        return 0;
+}
@@ -3,6 +3,17 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+
+/* Number of distinct values for 'DIST_FEW_UNIQUE'. */
+#define FEW_UNIQUE_COUNT 16
+
+static const char *const DIST_NAME[DIST_COUNT] = {
+        [DIST_UNIFORM]    = "uniform",
+        [DIST_SORTED]     = "sorted",
+        [DIST_REVERSE]    = "reverse",
+        [DIST_FEW_UNIQUE] = "few-unique"
+};
 
 /*
  * NOTE:
@@ -12,6 +23,19 @@
  * If NULL != *array, this function assumes the memory region is valid.
  */
 int array_generate(long **const array, const size_t length, unsigned int seed)
+{
+        return array_dist_generate(array, length, seed, DIST_UNIFORM);
+}
+
+/*
+ * NOTE:
+ * Same as 'array_generate' in terms of memory management; 'seed' has no
+ * effect on the distributions that are not random.
+ */
+int array_dist_generate(long **const array,
+                        const size_t length,
+                        unsigned int seed,
+                        const enum array_dist dist)
 {
         long *temp_ptr = NULL;
 
@@ -29,7 +53,7 @@ int array_generate(long **const array, const size_t length, unsigned int seed)
          * assignment statements of the form errno = value in threaded
          * programs.)
          */
-        if (NULL == array || 0U == length) {
+        if (NULL == array || 0U == length || DIST_COUNT <= dist) {
                 errno = EINVAL;
                 return -1;
         }
@@ -48,16 +72,107 @@ int array_generate(long **const array, const size_t length, unsigned int seed)
                 return -1;
         }
 
-        srandom(seed);
-
-        for (size_t i = 0; i < length; ++i) {
-                temp_ptr[i] = random();
+        if (0 > array_dist_slice_generate(temp_ptr,
+                                          0U,
+                                          length,
+                                          length,
+                                          seed,
+                                          dist)) {
+                if (NULL == *array) {
+                        free(temp_ptr);
+                }
+                return -1;
         }
 
         *array = temp_ptr;
         return 0;
 }
 
+/*
+ * Fills 'array' with the 'size' elements starting at 'offset' of the array
+ * of 'length' elements 'array_dist_generate' would make with the same
+ * 'seed' and 'dist', so that every process can generate its own block of
+ * the same input; the random distributions skip the first 'offset' values
+ * of the sequence, which takes time linear in 'offset'.
+ */
+int array_dist_slice_generate(long *const array,
+                              const size_t offset,
+                              const size_t size,
+                              const size_t length,
+                              unsigned int seed,
+                              const enum array_dist dist)
+{
+        if (NULL == array || 0U == size || length < offset ||
+            length - offset < size || DIST_COUNT <= dist) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        srandom(seed);
+
+        switch (dist) {
+        case DIST_UNIFORM:
+                for (size_t i = 0; i < offset; ++i) {
+                        random();
+                }
+                for (size_t i = 0; i < size; ++i) {
+                        array[i] = random();
+                }
+                break;
+        case DIST_SORTED:
+                for (size_t i = 0; i < size; ++i) {
+                        array[i] = (long)(offset + i);
+                }
+                break;
+        case DIST_REVERSE:
+                for (size_t i = 0; i < size; ++i) {
+                        array[i] = (long)(length - offset - i);
+                }
+                break;
+        case DIST_FEW_UNIQUE:
+                for (size_t i = 0; i < offset; ++i) {
+                        random();
+                }
+                for (size_t i = 0; i < size; ++i) {
+                        array[i] = random() % FEW_UNIQUE_COUNT;
+                }
+                break;
+        default:
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Converts the name of a distribution (as returned by 'array_dist_name')
+ * into one of 'enum array_dist'.
+ */
+int array_dist_convert(unsigned int *dist, const char *const candidate)
+{
+        if (NULL == dist || NULL == candidate) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (unsigned int i = DIST_UNIFORM; i < DIST_COUNT; ++i) {
+                if (0 == strcmp(DIST_NAME[i], candidate)) {
+                        *dist = i;
+                        return 0;
+                }
+        }
+
+        errno = EINVAL;
+        return -1;
+}
+
+const char *array_dist_name(const enum array_dist dist)
+{
+        if (DIST_COUNT <= dist) {
+                return "unknown";
+        }
+        return DIST_NAME[dist];
+}
+
 int array_destroy(long **const array)
 {
         if (NULL == array) {
@@ -0,0 +1,581 @@
+#include "psrs/macro.h"
+#define KEY_ONLY
+#include "psrs/key.h"
+#undef KEY_ONLY
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The 16 values of 'DIST_FEW_UNIQUE' for the floating point types. */
+static const float KEY_FLOAT_SPECIAL[16] = {
+        -NAN, -INFINITY, -FLT_MAX, -1.0f, -FLT_MIN, -1e-45f, -0.0f, 0.0f,
+        0.0f, 1e-45f, FLT_MIN, 0.5f, 1.0f, FLT_MAX, INFINITY, NAN
+};
+static const double KEY_DOUBLE_SPECIAL[16] = {
+        -NAN, -INFINITY, -DBL_MAX, -1.0, -DBL_MIN, -5e-324, -0.0, 0.0,
+        0.0, 5e-324, DBL_MIN, 0.5, 1.0, DBL_MAX, INFINITY, NAN
+};
+
+/* The most significant bit of the unsigned integer type 'UTYPE'. */
+#define KEY_SIGN_(UTYPE) ((UTYPE)1 << (sizeof(UTYPE) * CHAR_BIT - 1U))
+
+/* Maps the 'bits' of a key onto an unsigned integer of the same order. */
+#define KEY_ENCODE_UNSIGNED_(UTYPE, bits) (bits)
+#define KEY_ENCODE_SIGNED_(UTYPE, bits) ((bits) ^ KEY_SIGN_(UTYPE))
+#define KEY_ENCODE_FLOAT_(UTYPE, bits)\
+        ((bits) & KEY_SIGN_(UTYPE) ? (UTYPE)~(bits) :\
+                                     (bits) ^ KEY_SIGN_(UTYPE))
+
+/*
+ * Turns the value 'c' made by 'array_dist_generate' with 'dist', already
+ * centered on 0 (see 'KEY_DEFINE'), into a key.
+ *
+ * NOTE:
+ * The 64-bit integers are spread over all their bits so the radix sort
+ * does not skip their lower half; the floating point numbers of
+ * 'DIST_FEW_UNIQUE' are the special values of the type (NaN, infinity,
+ * -0.0 and denormals among others).
+ */
+#define KEY_FROM_32_(TYPE, c, dist) ((TYPE)(c))
+#define KEY_FROM_64_(TYPE, c, dist)\
+        ((TYPE)((int64_t)(c) * 4294967296LL + (uint32_t)(c)))
+#define KEY_FROM_FLOAT_(TYPE, c, dist)\
+        (DIST_FEW_UNIQUE == (dist) ? KEY_FLOAT_SPECIAL[(c) + 8] :\
+                                     (float)(c) / 1024.0f)
+#define KEY_FROM_DOUBLE_(TYPE, c, dist)\
+        (DIST_FEW_UNIQUE == (dist) ? KEY_DOUBLE_SPECIAL[(c) + 8] :\
+                                     (double)(c) / 1024.0)
+#define KEY_FROM_LONG_(TYPE, c, dist) ((TYPE)(c))
+
+/*
+ * Defines the kernels of 'struct key_kernel' for keys of 'TYPE' named
+ * 'NAME', ordered as the unsigned integers 'UTYPE' the 'ENCODE' macro maps
+ * their bits onto, and converted from generated values by 'FROM'.
+ */
+#define KEY_DEFINE(NAME, TYPE, UTYPE, ENCODE, FROM)\
+static inline UTYPE key_encode_##NAME##_(const TYPE key)\
+{\
+        UTYPE bits;\
+\
+        memcpy(&bits, &key, sizeof bits);\
+        return (UTYPE)ENCODE(UTYPE, bits);\
+}\
+\
+static void key_convert_##NAME##_(void *dst,\
+                                  const long src[],\
+                                  const size_t length,\
+                                  const enum array_dist dist)\
+{\
+        TYPE *const key = (TYPE *)dst;\
+        long c = 0;\
+\
+        for (size_t i = 0U; i < length; ++i) {\
+                c = src[i];\
+                if (DIST_UNIFORM == dist) {\
+                        c -= 1L << 30;\
+                } else if (DIST_FEW_UNIQUE == dist) {\
+                        c -= 8L;\
+                }\
+                key[i] = FROM(TYPE, c, dist);\
+        }\
+}\
+\
+static void key_sort_##NAME##_(void *base, void *tmp, const size_t length)\
+{\
+        TYPE *from = (TYPE *)base;\
+        TYPE *to = (TYPE *)tmp;\
+        TYPE *swap = NULL;\
+        size_t count[256];\
+        size_t offset = 0U;\
+        size_t digit_count = 0U;\
+\
+        if (2U > length) {\
+                return;\
+        }\
+\
+        for (unsigned int shift = 0U;\
+             shift < sizeof(UTYPE) * CHAR_BIT;\
+             shift += 8U) {\
+                memset(count, 0, sizeof count);\
+                for (size_t i = 0U; i < length; ++i) {\
+                        ++count[(key_encode_##NAME##_(from[i]) >> shift) &\
+                                0xFFU];\
+                }\
+                /* A digit shared by every key leaves the order alone. */\
+                if (length == count[(key_encode_##NAME##_(from[0]) >>\
+                                     shift) & 0xFFU]) {\
+                        continue;\
+                }\
+                offset = 0U;\
+                for (size_t d = 0U; d < 256U; ++d) {\
+                        digit_count = count[d];\
+                        count[d] = offset;\
+                        offset += digit_count;\
+                }\
+                for (size_t i = 0U; i < length; ++i) {\
+                        to[count[(key_encode_##NAME##_(from[i]) >> shift) &\
+                                 0xFFU]++] = from[i];\
+                }\
+                swap = from;\
+                from = to;\
+                to = swap;\
+        }\
+\
+        if ((TYPE *)base != from) {\
+                memcpy(base, from, sizeof(TYPE) * length);\
+        }\
+}\
+\
+static void key_merge_##NAME##_(void *dst,\
+                                const void *left,\
+                                const size_t left_length,\
+                                const void *right,\
+                                const size_t right_length)\
+{\
+        TYPE *const out = (TYPE *)dst;\
+        const TYPE *const l = (const TYPE *)left;\
+        const TYPE *const r = (const TYPE *)right;\
+        size_t i = 0U;\
+        size_t j = 0U;\
+        size_t k = 0U;\
+\
+        while (i < left_length && j < right_length) {\
+                if (key_encode_##NAME##_(l[i]) <=\
+                    key_encode_##NAME##_(r[j])) {\
+                        out[k++] = l[i++];\
+                } else {\
+                        out[k++] = r[j++];\
+                }\
+        }\
+        memcpy(out + k, l + i, sizeof(TYPE) * (left_length - i));\
+        k += left_length - i;\
+        memcpy(out + k, r + j, sizeof(TYPE) * (right_length - j));\
+}\
+\
+static size_t key_upper_bound_##NAME##_(const void *base,\
+                                        const size_t length,\
+                                        const void *key)\
+{\
+        const TYPE *const array = (const TYPE *)base;\
+        const UTYPE target = key_encode_##NAME##_(*(const TYPE *)key);\
+        size_t low = 0U;\
+        size_t high = length;\
+        size_t middle = 0U;\
+\
+        while (low < high) {\
+                middle = low + (high - low) / 2U;\
+                if (key_encode_##NAME##_(array[middle]) <= target) {\
+                        low = middle + 1U;\
+                } else {\
+                        high = middle;\
+                }\
+        }\
+        return low;\
+}\
+\
+static int key_compare_##NAME##_(const void *left, const void *right)\
+{\
+        const UTYPE l = key_encode_##NAME##_(*(const TYPE *)left);\
+        const UTYPE r = key_encode_##NAME##_(*(const TYPE *)right);\
+\
+        return (l > r) - (l < r);\
+}
+
+KEY_DEFINE(long, long, unsigned long, KEY_ENCODE_SIGNED_, KEY_FROM_LONG_)
+KEY_DEFINE(int32, int32_t, uint32_t, KEY_ENCODE_SIGNED_, KEY_FROM_32_)
+KEY_DEFINE(uint32, uint32_t, uint32_t, KEY_ENCODE_UNSIGNED_, KEY_FROM_32_)
+KEY_DEFINE(int64, int64_t, uint64_t, KEY_ENCODE_SIGNED_, KEY_FROM_64_)
+KEY_DEFINE(uint64, uint64_t, uint64_t, KEY_ENCODE_UNSIGNED_, KEY_FROM_64_)
+KEY_DEFINE(float, float, uint32_t, KEY_ENCODE_FLOAT_, KEY_FROM_FLOAT_)
+KEY_DEFINE(double, double, uint64_t, KEY_ENCODE_FLOAT_, KEY_FROM_DOUBLE_)
+
+#define KEY_KERNEL_(NAME, TYPE)\
+        {\
+                .name        = #NAME,\
+                .size        = sizeof(TYPE),\
+                .convert     = key_convert_##NAME##_,\
+                .sort        = key_sort_##NAME##_,\
+                .merge       = key_merge_##NAME##_,\
+                .upper_bound = key_upper_bound_##NAME##_,\
+                .compare     = key_compare_##NAME##_\
+        }
+
+static const struct key_kernel KEY_KERNEL[KEY_TYPE_COUNT] = {
+        [KEY_LONG]   = KEY_KERNEL_(long, long),
+        [KEY_INT32]  = KEY_KERNEL_(int32, int32_t),
+        [KEY_UINT32] = KEY_KERNEL_(uint32, uint32_t),
+        [KEY_INT64]  = KEY_KERNEL_(int64, int64_t),
+        [KEY_UINT64] = KEY_KERNEL_(uint64, uint64_t),
+        [KEY_FLOAT]  = KEY_KERNEL_(float, float),
+        [KEY_DOUBLE] = KEY_KERNEL_(double, double)
+};
+
+const struct key_kernel *key_kernel(const enum key_type type)
+{
+        if (KEY_TYPE_COUNT <= type) {
+                errno = EINVAL;
+                return NULL;
+        }
+        return &(KEY_KERNEL[type]);
+}
+
+/*
+ * NOTE:
+ * The MPI data types are not constant expressions with every MPI library,
+ * so they are looked up rather than kept in 'KEY_KERNEL'.
+ */
+MPI_Datatype key_datatype(const enum key_type type)
+{
+        switch (type) {
+        case KEY_LONG:
+                return MPI_LONG;
+        case KEY_INT32:
+                return MPI_INT32_T;
+        case KEY_UINT32:
+                return MPI_UINT32_T;
+        case KEY_INT64:
+                return MPI_INT64_T;
+        case KEY_UINT64:
+                return MPI_UINT64_T;
+        case KEY_FLOAT:
+                return MPI_FLOAT;
+        case KEY_DOUBLE:
+                return MPI_DOUBLE;
+        default:
+                return MPI_DATATYPE_NULL;
+        }
+}
+
+/*
+ * Converts the name of a key type (as returned by 'key_type_name') into
+ * one of 'enum key_type'.
+ */
+int key_type_convert(unsigned int *type, const char *const candidate)
+{
+        if (NULL == type || NULL == candidate) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (unsigned int i = KEY_LONG; i < KEY_TYPE_COUNT; ++i) {
+                if (0 == strcmp(KEY_KERNEL[i].name, candidate)) {
+                        *type = i;
+                        return 0;
+                }
+        }
+
+        errno = EINVAL;
+        return -1;
+}
+
+const char *key_type_name(const enum key_type type)
+{
+        if (KEY_TYPE_COUNT <= type) {
+                return "unknown";
+        }
+        return KEY_KERNEL[type].name;
+}
+
+/*
+ * Sorts the 'size' items of 'kernel' in 'block' of every process of 'comm'
+ * together by PSRS, in place, and describes the part of the result of this
+ * process in 'out'; the items are exchanged as 'datatype', whose extent
+ * must be 'kernel->size', and every buffer comes from 'arena'.  Collective
+ * over 'comm'.
+ *
+ * NOTE:
+ * This is the same algorithm as 'psort_start' with its phases run back to
+ * back: a local sort of the block and 'p' regular samples, pivots picked
+ * by root out of the sorted samples, partitions formed by searching for
+ * the pivots, then exchanged and merged.
+ *
+ * Only the size and 'compare' of 'kernel' are required: the local sort,
+ * the merge and the search fall back to 'qsort' and their counterparts by
+ * 'compare' where 'sort', 'merge' or 'upper_bound' is 'NULL', which is how
+ * the records of 'include/psrs/record.h' are sorted.
+ *
+ * A block may be smaller than the number of processes, even empty, as
+ * those given to 'psrs_sort' may: it then has fewer samples to offer, and
+ * too few samples overall leave the last partitions empty, as in
+ * 'pivots_bcast'.
+ *
+ * If there is no memory for a buffer on any process, every process
+ * returns -1 with 'errno' set to 'ENOMEM'; 'arena' may hold the buffers
+ * allocated so far.
+ */
+int key_sort(struct key_sorted *out,
+             MPI_Comm comm,
+             const struct key_kernel *kernel,
+             MPI_Datatype datatype,
+             void *block,
+             const int size,
+             struct arena *arena)
+{
+        int process = 0;
+        int id = 0;
+        int window = 0;
+        int begin = 0;
+        int total = 0;
+        int sample_size = 0;
+        int pivot_size = 0;
+        int failed = 0;
+        int any_failed = 0;
+        size_t item = 0U;
+        unsigned char *base = (unsigned char *)block;
+        unsigned char *tmp = NULL;
+        unsigned char *sample = NULL;
+        unsigned char *all_sample = NULL;
+        unsigned char *pivot = NULL;
+        unsigned char *recv = NULL;
+        int *count = NULL;
+
+        if (NULL == out || MPI_COMM_NULL == comm || NULL == kernel ||
+            NULL == kernel->compare || (NULL == block && 0 < size) ||
+            0 > size || NULL == arena) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Comm_size(comm, &process);
+        MPI_Comm_rank(comm, &id);
+        item = kernel->size;
+
+        /*
+         * 'count' holds the number of items sent to and received from each
+         * process, followed by where they go in either buffer; root also
+         * keeps the number of samples of every process and where they go in
+         * 'all_sample' past the end of it.
+         *
+         * Every process agrees on whether to go on before each collective
+         * that follows an allocation, so none of them is left waiting in a
+         * collective the others never reach.
+         */
+        failed = (NULL != kernel->sort &&
+                  0 > arena_alloc(arena, (void **)&tmp, item * size)) ||
+                 0 > arena_alloc(arena, (void **)&sample, item * process) ||
+                 0 > arena_alloc(arena, (void **)&pivot, item * process) ||
+                 0 > arena_alloc(arena,
+                                 (void **)&count,
+                                 6U * sizeof(int) * process) ||
+                 (0 == id &&
+                  0 > arena_alloc(arena,
+                                  (void **)&all_sample,
+                                  item * process * process));
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+        if (any_failed) {
+                errno = ENOMEM;
+                return -1;
+        }
+
+        if (NULL != kernel->sort) {
+                kernel->sort(base, tmp, size);
+        } else {
+                qsort(base, size, item, kernel->compare);
+        }
+        window = size / process;
+        for (int idx = 0;
+             idx < size && sample_size < process;
+             idx += window) {
+                memcpy(sample + item * sample_size++,
+                       base + item * idx,
+                       item);
+                if (0 == window) {
+                        break;
+                }
+        }
+
+        MPI_Gather(&sample_size, 1, MPI_INT,
+                   count + 4 * process, 1, MPI_INT,
+                   0, comm);
+        if (0 == id) {
+                for (int i = 0; i < process; ++i) {
+                        count[5 * process + i] = total;
+                        total += count[4 * process + i];
+                }
+        }
+        MPI_Gatherv(sample, sample_size, datatype,
+                    all_sample, count + 4 * process, count + 5 * process,
+                    datatype, 0, comm);
+        if (0 == id) {
+                qsort(all_sample, total, item, kernel->compare);
+                for (int i = process + process / 2;
+                     i < total && pivot_size < process - 1;
+                     i += process) {
+                        memcpy(pivot + item * pivot_size++,
+                               all_sample + item * i,
+                               item);
+                }
+                while (0 < total && pivot_size < process - 1) {
+                        memcpy(pivot + item * pivot_size++,
+                               all_sample + item * (total - 1),
+                               item);
+                }
+                total = 0;
+        }
+        MPI_Bcast(&pivot_size, 1, MPI_INT, 0, comm);
+        MPI_Bcast(pivot, pivot_size, datatype, 0, comm);
+
+        /* With no samples at all, every block is empty. */
+        for (int i = 0; i < process - 1; ++i) {
+                count[i] = i < pivot_size ?
+                           (int)key_upper_bound_(kernel,
+                                                 base + item * begin,
+                                                 size - begin,
+                                                 pivot + item * i) :
+                           0;
+                begin += count[i];
+        }
+        count[process - 1] = size - begin;
+        for (int i = 0, displ = 0; i < process; ++i) {
+                count[2 * process + i] = displ;
+                displ += count[i];
+        }
+
+        MPI_Alltoall(count, 1, MPI_INT,
+                     count + process, 1, MPI_INT,
+                     comm);
+        for (int i = 0; i < process; ++i) {
+                count[3 * process + i] = total;
+                total += count[process + i];
+        }
+
+        failed = 0 > arena_alloc(arena, (void **)&recv, item * total);
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+        if (any_failed) {
+                errno = ENOMEM;
+                return -1;
+        }
+        MPI_Alltoallv(base, count, count + 2 * process, datatype,
+                      recv, count + process, count + 3 * process, datatype,
+                      comm);
+
+        out->sent = (double)(size - count[id]) * item;
+        out->size = total;
+        key_merge_all_(out,
+                       kernel,
+                       recv,
+                       count + process,
+                       count + 3 * process,
+                       process,
+                       arena);
+        failed = NULL == out->head && 0 < total;
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+        if (any_failed) {
+                errno = ENOMEM;
+                return -1;
+        }
+        return 0;
+}
+
+/*
+ * Merges the sorted partitions received in 'recv' 2 at a time, as
+ * 'partition_merge' does, into 'out->head'; it is left 'NULL' if there is
+ * no memory for the merge buffers.
+ */
+static void key_merge_all_(struct key_sorted *out,
+                           const struct key_kernel *kernel,
+                           unsigned char *recv,
+                           const int recv_count[const],
+                           const int recv_displ[const],
+                           const int process,
+                           struct arena *arena)
+{
+        const size_t item = kernel->size;
+        int dump_idx = 0;
+        unsigned char *merge_buf[2] = { NULL, NULL };
+        unsigned char *running = recv;
+        int running_size = recv_count[0];
+
+        out->head = NULL;
+        for (int i = 1; i < process; ++i) {
+                if (0 == recv_count[i]) {
+                        continue;
+                }
+                if (0 == running_size) {
+                        running = recv + item * recv_displ[i];
+                        running_size = recv_count[i];
+                        continue;
+                }
+                if (NULL == merge_buf[dump_idx] &&
+                    0 > arena_alloc(arena,
+                                    (void **)&(merge_buf[dump_idx]),
+                                    item * out->size)) {
+                        return;
+                }
+                key_merge_(kernel,
+                           merge_buf[dump_idx],
+                           running,
+                           running_size,
+                           recv + item * recv_displ[i],
+                           recv_count[i]);
+                running = merge_buf[dump_idx];
+                running_size += recv_count[i];
+                dump_idx ^= 1;
+        }
+        out->head = running;
+}
+
+/*
+ * Merges 2 sorted arrays of items of 'kernel' into 'dst', taking from
+ * 'left' on a tie so the order of equal items is kept.
+ */
+static void key_merge_(const struct key_kernel *kernel,
+                       unsigned char *dst,
+                       const unsigned char *left,
+                       const size_t left_length,
+                       const unsigned char *right,
+                       const size_t right_length)
+{
+        const size_t item = kernel->size;
+        size_t i = 0U;
+        size_t j = 0U;
+
+        if (NULL != kernel->merge) {
+                kernel->merge(dst, left, left_length, right, right_length);
+                return;
+        }
+
+        while (i < left_length && j < right_length) {
+                if (0 > kernel->compare(right + item * j, left + item * i)) {
+                        memcpy(dst, right + item * j, item);
+                        ++j;
+                } else {
+                        memcpy(dst, left + item * i, item);
+                        ++i;
+                }
+                dst += item;
+        }
+        memcpy(dst, left + item * i, item * (left_length - i));
+        dst += item * (left_length - i);
+        memcpy(dst, right + item * j, item * (right_length - j));
+}
+
+/* Number of the sorted items of 'kernel' in 'base' no greater than 'key'. */
+static size_t key_upper_bound_(const struct key_kernel *kernel,
+                               const unsigned char *base,
+                               const size_t length,
+                               const unsigned char *key)
+{
+        size_t low = 0U;
+        size_t high = length;
+        size_t middle = 0U;
+
+        if (NULL != kernel->upper_bound) {
+                return kernel->upper_bound(base, length, key);
+        }
+
+        while (low < high) {
+                middle = low + (high - low) / 2U;
+                if (0 > kernel->compare(key, base + kernel->size * middle)) {
+                        high = middle;
+                } else {
+                        low = middle + 1U;
+                }
+        }
+        return low;
+}
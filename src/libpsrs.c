@@ -0,0 +1,445 @@
+#include "psrs/macro.h"
+#define LIBPSRS_ONLY
+#include "psrs/libpsrs.h"
+#undef LIBPSRS_ONLY
+
+#include "psrs/arena.h"
+#include "psrs/record.h"
+#include "psrs/sort.h"
+
+#include <errno.h>
+#include <limits.h>  /* INT_MAX, LONG_MAX */
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Sorts the 'n_local' elements of 'in' of every process of 'comm' as a
+ * single sequence distributed over all of them, and fills in 'out' of each
+ * process with its part of the result; this is collective over 'comm'.
+ *
+ * Nothing goes through root: every process sorts and samples its own block
+ * in place, root only picks the pivots, and the partitions are exchanged
+ * directly between the processes.
+ *
+ * NOTE:
+ * 'in' is sorted in place along the way.  'opts' may be 'NULL' for the
+ * defaults.  An invalid argument of any process fails the call on every
+ * process (with 'EINVAL'), as does a total beyond 'INT_MAX' elements
+ * (with 'EOVERFLOW'), since a partition travels in a single message, or
+ * a working memory none can be had for (with 'ENOMEM').  A failure once
+ * the sort is under way aborts the processes of 'comm' instead, as the
+ * others may be waiting for the failing one in the middle of a phase.
+ */
+int psrs_sort(MPI_Comm comm,
+              long *in,
+              const int64_t n_local,
+              struct psrs_result *const out,
+              const struct psrs_opts *const opts)
+{
+        static const struct psrs_opts DEFAULT_OPTS;
+        const struct psrs_opts *const option = NULL == opts ?
+                                               &DEFAULT_OPTS : opts;
+        const double begin = MPI_Wtime();
+        /* Neither is used by the caller; 'psort_start' fills them anyway. */
+        double elapsed[PHASE_COUNT];
+        double lap[SUBPHASE_COUNT];
+        int64_t total = 0;
+        int failed = 0;
+        int any_failed = 0;
+        size_t chunk_limit = option->mem_limit / sizeof(long);
+        size_t arena_size = 0U;
+        struct arena *reused = NULL;
+        struct process_arg arg;
+
+        if (0 > psrs_check_(comm, in, n_local, out, &total)) {
+                return -1;
+        }
+
+        if (0U != option->reuse) {
+                reused = out->arena;
+        }
+        memset(out, 0, sizeof(struct psrs_result));
+        memset(&arg, 0, sizeof(struct process_arg));
+        memset(elapsed, 0, sizeof elapsed);
+        memset(lap, 0, sizeof lap);
+
+        /* The messages of the sort never mix with those of the caller. */
+        MPI_Comm_dup(comm, &(arg.comm));
+        MPI_Comm_rank(arg.comm, &(arg.id));
+        MPI_Comm_size(arg.comm, &(arg.process));
+        arg.root = 0 == arg.id;
+        arg.barrier = 0U != option->barrier;
+        arg.distributed = true;
+        arg.head = in;
+        arg.size = (int)n_local;
+        arg.max_sample_size = arg.process;
+        arg.total_size = (int)total;
+        if (INT_MAX < chunk_limit) {
+                chunk_limit = INT_MAX;
+        }
+        if (0UL != option->mem_limit && 0U == chunk_limit) {
+                chunk_limit = 1U;
+        }
+        arg.chunk_limit = (int)chunk_limit;
+
+        /*
+         * Same estimate as 'parallel_sort', except that the block itself
+         * belongs to the caller: the received partitions and the 2 merge
+         * buffers, or the merged result and a single chunk in the
+         * memory-bounded mode.
+         */
+        arena_size = sizeof(long) * ((0U < chunk_limit ? 2U : 3U) *
+                                     (size_t)n_local +
+                                     (size_t)arg.process * arg.process +
+                                     2U * arg.process) +
+                     2U * (sizeof(struct part_blk) +
+                           arg.process * sizeof(struct partition)) +
+                     16U * ARENA_ALIGN;
+        if (NULL != reused) {
+                /* Grows by itself if this sort is larger than the last. */
+                failed = 0 > arena_reset(reused);
+                arg.arena = reused;
+                out->arena = reused;
+        } else {
+                failed = 0 > arena_init(&(arg.arena), arena_size);
+        }
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, arg.comm);
+        if (any_failed) {
+                /* A reused arena still belongs to 'out'. */
+                if (!failed && NULL == reused) {
+                        arena_destroy(&(arg.arena));
+                }
+                MPI_Comm_free(&(arg.comm));
+                errno = ENOMEM;
+                return -1;
+        }
+
+        /* There are no samples to pick the pivots from otherwise. */
+        if (0 < total) {
+                psort_start(elapsed, lap, NULL, &arg);
+        }
+
+        out->head = arg.merged;
+        out->size = arg.merged_size;
+        MPI_Exscan(&(out->size), &(out->offset), 1, MPI_INT64_T, MPI_SUM,
+                   arg.comm);
+        /* 'MPI_Exscan' leaves the one of the first process undefined. */
+        if (arg.root) {
+                out->offset = 0;
+        }
+        out->arena = arg.arena;
+        MPI_Comm_free(&(arg.comm));
+        out->elapsed = MPI_Wtime() - begin;
+        return 0;
+}
+
+/*
+ * Sorts many independent segments at once: element 'i' of 'in' belongs to
+ * segment 'segment[i]' (a non-negative number; the elements of a segment
+ * may be spread over any processes), and every segment is sorted on its
+ * own, all of them in a single pass of 'psrs_sort' rather than one each.
+ *
+ * The result is ordered by segment and then by key, so each segment is a
+ * contiguous run of the whole sorted sequence (possibly spanning several
+ * processes) and 'out->segment' tells which segment each element of
+ * 'out->head' belongs to.
+ *
+ * NOTE:
+ * A key and its segment are packed into a single 'long' for the sort, so
+ * every key must fit into 'int32_t' and 'long' must have 64 bits; any
+ * other argument fails the call on every process with 'EINVAL' or
+ * 'ENOTSUP' respectively, leaving 'in' as it is.  Otherwise the same as
+ * 'psrs_sort'.
+ */
+int psrs_sort_segments(MPI_Comm comm,
+                       long *in,
+                       const int32_t segment[],
+                       const int64_t n_local,
+                       struct psrs_result *const out,
+                       const struct psrs_opts *const opts)
+{
+        int invalid = NULL == segment && 0 < n_local;
+        int any_invalid = 0;
+        void *head = NULL;
+
+        if (MPI_COMM_NULL == comm) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        /* The same on every process, so they all fail together. */
+        if (LONG_MAX < INT64_MAX) {
+                errno = ENOTSUP;
+                return -1;
+        }
+
+        for (int64_t i = 0; !invalid && NULL != in && i < n_local; ++i) {
+                invalid = 0 > segment[i] ||
+                          INT32_MIN > in[i] || INT32_MAX < in[i];
+        }
+        MPI_Allreduce(&invalid, &any_invalid, 1, MPI_INT, MPI_MAX, comm);
+        if (any_invalid) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (int64_t i = 0; NULL != in && i < n_local; ++i) {
+                in[i] = psrs_segment_pack_(segment[i], in[i]);
+        }
+
+        if (0 > psrs_sort(comm, in, n_local, out, opts)) {
+                /* Nothing has moved when the sort does not even start. */
+                for (int64_t i = 0; NULL != in && i < n_local; ++i) {
+                        psrs_segment_unpack_(NULL, &in[i]);
+                }
+                return -1;
+        }
+
+        if (0 > arena_alloc(out->arena,
+                            &head,
+                            (size_t)out->size * sizeof(int32_t))) {
+                return -1;
+        }
+        out->segment = (int32_t *)head;
+        for (int64_t i = 0; i < out->size; ++i) {
+                psrs_segment_unpack_(&(out->segment[i]), &(out->head[i]));
+        }
+        return 0;
+}
+
+/*
+ * Sorts as 'psrs_sort' does, but stably, and tells in 'out->index' where
+ * every element of 'out->head' comes from: its index within the whole
+ * input, the blocks of all the processes one after another in rank order.
+ * Elements of equal keys come out in the order of these indices.
+ *
+ * NOTE:
+ * Every key travels along with its index (an 'int64_t' each, so twice as
+ * many bytes as 'psrs_sort' moves), and the local sort breaks ties by it;
+ * an index is as good as the (rank, local index) it stands for, and is
+ * what the caller wants back anyway.  'in' is left as it is, and every
+ * buffer of the result belongs to 'out->arena'.  'opts->mem_limit' does
+ * not apply: the partitions always travel whole.  Otherwise the same as
+ * 'psrs_sort'.
+ */
+int psrs_argsort(MPI_Comm comm,
+                 const long *in,
+                 const int64_t n_local,
+                 struct psrs_result *const out,
+                 const struct psrs_opts *const opts)
+{
+        const double begin = MPI_Wtime();
+        int process = 0;
+        int id = 0;
+        int64_t total = 0;
+        int64_t base = 0;
+        int failed = 0;
+        int any_failed = 0;
+        void *pair = NULL;
+        void *head = NULL;
+        void *index = NULL;
+        struct arena *reused = NULL;
+        struct arena *arena = NULL;
+        struct record_layout layout;
+        struct record_sorted sorted = { NULL, 0, 0.0 };
+        MPI_Comm dup = MPI_COMM_NULL;
+
+        if (0 > psrs_check_(comm, in, n_local, out, &total)) {
+                return -1;
+        }
+
+        if (NULL != opts && 0U != opts->reuse) {
+                reused = out->arena;
+        }
+        memset(out, 0, sizeof(struct psrs_result));
+
+        /* The messages of the sort never mix with those of the caller. */
+        MPI_Comm_dup(comm, &dup);
+        MPI_Comm_rank(dup, &id);
+        MPI_Comm_size(dup, &process);
+
+        /*
+         * The pairs, the received partitions and the 2 merge buffers of
+         * them, then the keys and the indices of the result.
+         */
+        if (NULL != reused) {
+                failed = 0 > arena_reset(reused);
+                arena = reused;
+                out->arena = reused;
+        } else {
+                failed = 0 > arena_init(&arena,
+                                        sizeof(int64_t) *
+                                        (10U * (size_t)n_local +
+                                         2U * (size_t)process * process +
+                                         8U * process) +
+                                        16U * ARENA_ALIGN);
+        }
+        if (!failed && 0 > record_layout_init(&layout, RECORD_PAYLOAD_MIN)) {
+                failed = 1;
+                if (NULL == reused) {
+                        arena_destroy(&arena);
+                }
+        }
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, dup);
+        if (any_failed) {
+                /* A reused arena still belongs to 'out'. */
+                if (!failed) {
+                        record_layout_destroy(&layout);
+                        if (NULL == reused) {
+                                arena_destroy(&arena);
+                        }
+                }
+                MPI_Comm_free(&dup);
+                errno = ENOMEM;
+                return -1;
+        }
+        out->arena = arena;
+
+        MPI_Exscan(&n_local, &base, 1, MPI_INT64_T, MPI_SUM, dup);
+        /* 'MPI_Exscan' leaves the one of the first process undefined. */
+        if (0 == id) {
+                base = 0;
+        }
+
+        /* A pair is a key followed by its index, as 'layout' tells. */
+        failed = 0 > arena_alloc(arena,
+                                 &pair,
+                                 layout.size * (size_t)n_local);
+        for (int64_t i = 0; !failed && i < n_local; ++i) {
+                const int64_t key = (int64_t)in[i];
+                const int64_t origin = base + i;
+
+                memcpy((unsigned char *)pair + layout.size * i,
+                       &key,
+                       sizeof(int64_t));
+                memcpy((unsigned char *)pair + layout.size * i +
+                       sizeof(int64_t),
+                       &origin,
+                       sizeof(int64_t));
+        }
+
+        /*
+         * Every process agrees on whether to go on both before and after
+         * the sort, so none of them is left waiting in a collective the
+         * others never reach.
+         */
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, dup);
+        if (!any_failed) {
+                /* There are no samples to pick the pivots from otherwise. */
+                failed = (0 < total && 0 > record_pair_sort(&sorted,
+                                                            dup,
+                                                            &layout,
+                                                            pair,
+                                                            (int)n_local,
+                                                            arena)) ||
+                         0 > arena_alloc(arena,
+                                         &head,
+                                         sizeof(long) * sorted.size) ||
+                         0 > arena_alloc(arena,
+                                         &index,
+                                         sizeof(int64_t) * sorted.size);
+                out->head = (long *)head;
+                out->index = (int64_t *)index;
+                for (int i = 0; !failed && i < sorted.size; ++i) {
+                        out->head[i] = (long)record_key(sorted.head +
+                                                        layout.size * i);
+                        memcpy(&(out->index[i]),
+                               sorted.head + layout.size * i +
+                               sizeof(int64_t),
+                               sizeof(int64_t));
+                }
+                MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX,
+                              dup);
+        }
+        record_layout_destroy(&layout);
+        if (any_failed) {
+                /* A reused arena still belongs to 'out'. */
+                memset(out, 0, sizeof(struct psrs_result));
+                if (NULL == reused) {
+                        arena_destroy(&arena);
+                }
+                out->arena = reused;
+                MPI_Comm_free(&dup);
+                errno = ENOMEM;
+                return -1;
+        }
+        out->size = sorted.size;
+
+        MPI_Exscan(&(out->size), &(out->offset), 1, MPI_INT64_T, MPI_SUM,
+                   dup);
+        if (0 == id) {
+                out->offset = 0;
+        }
+        MPI_Comm_free(&dup);
+        out->elapsed = MPI_Wtime() - begin;
+        return 0;
+}
+
+int psrs_result_destroy(struct psrs_result *const result)
+{
+        if (NULL == result) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (NULL != result->arena && 0 > arena_destroy(&(result->arena))) {
+                return -1;
+        }
+        memset(result, 0, sizeof(struct psrs_result));
+        return 0;
+}
+
+/*
+ * Agrees on whether the arguments of every process are valid, and sums up
+ * the total number of elements into 'total'.
+ */
+static int psrs_check_(MPI_Comm comm,
+                       const long *const in,
+                       const int64_t n_local,
+                       const struct psrs_result *const out,
+                       int64_t *const total)
+{
+        const int invalid = NULL == out || 0 > n_local ||
+                            (NULL == in && 0 < n_local);
+        const int64_t count = invalid ? 0 : n_local;
+        int any_invalid = 0;
+
+        if (MPI_COMM_NULL == comm) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Allreduce(&invalid, &any_invalid, 1, MPI_INT, MPI_MAX, comm);
+        MPI_Allreduce(&count, total, 1, MPI_INT64_T, MPI_SUM, comm);
+        if (any_invalid) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (INT_MAX < *total) {
+                errno = EOVERFLOW;
+                return -1;
+        }
+        return 0;
+}
+
+/*
+ * Packs 'key' (within 'int32_t') below 'segment', offset so the packed
+ * values order by segment first and by key next.
+ */
+static long psrs_segment_pack_(const int32_t segment, const long key)
+{
+        return (long)((uint64_t)segment << 32 |
+                      (uint64_t)(key - INT32_MIN));
+}
+
+/* Reverts 'psrs_segment_pack_' in place; 'segment' may be 'NULL'. */
+static void psrs_segment_unpack_(int32_t *const segment, long *const key)
+{
+        const uint64_t packed = (uint64_t)*key;
+
+        if (NULL != segment) {
+                *segment = (int32_t)(packed >> 32);
+        }
+        *key = (long)(packed & UINT32_MAX) + INT32_MIN;
+}
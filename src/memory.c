@@ -0,0 +1,84 @@
+#include "psrs/macro.h"
+#define MEMORY_ONLY
+#include "psrs/memory.h"
+#undef MEMORY_ONLY
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+
+/*
+ * Fills 'usage' (of 'MEMORY_STAT_SIZE' values, indexed by
+ * 'enum memory_stat') with the current state of 'arena' and of the whole
+ * process; every size is in bytes.
+ *
+ * NOTE:
+ * The resident set sizes are read from '/proc/self/status' where it exists;
+ * elsewhere the peak comes from 'getrusage' and the current one is reported
+ * as 0.
+ */
+int memory_read(double usage[const], const struct arena *const arena)
+{
+        struct rusage resource;
+
+        if (NULL == usage || NULL == arena) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        usage[MEMORY_ALLOCATED] = (double)arena->total;
+        usage[MEMORY_ALLOCATIONS] = (double)arena->count;
+        usage[MEMORY_LIVE] = (double)arena->used;
+        usage[MEMORY_RESERVED] = (double)arena->capacity;
+
+        if (0 == memory_status_read_(&(usage[MEMORY_RSS]),
+                                     &(usage[MEMORY_PEAK_RSS]))) {
+                return 0;
+        }
+
+        if (0 > getrusage(RUSAGE_SELF, &resource)) {
+                return -1;
+        }
+        usage[MEMORY_RSS] = 0;
+#ifdef __APPLE__
+        /* In bytes rather than kilobytes on macOS. */
+        usage[MEMORY_PEAK_RSS] = (double)resource.ru_maxrss;
+#else
+        usage[MEMORY_PEAK_RSS] = (double)resource.ru_maxrss * 1024;
+#endif
+        return 0;
+}
+
+/*
+ * Reads the "VmRSS" (current) and "VmHWM" (peak) fields of
+ * '/proc/self/status', which are in kilobytes.
+ */
+static int memory_status_read_(double *const rss, double *const peak)
+{
+        char line[256];
+        unsigned long value = 0UL;
+        int found = 0;
+        FILE *status = fopen("/proc/self/status", "r");
+
+        if (NULL == status) {
+                return -1;
+        }
+
+        while (2 > found && NULL != fgets(line, sizeof line, status)) {
+                if (1 == sscanf(line, "VmRSS: %lu kB", &value)) {
+                        *rss = (double)value * 1024;
+                        ++found;
+                } else if (1 == sscanf(line, "VmHWM: %lu kB", &value)) {
+                        *peak = (double)value * 1024;
+                        ++found;
+                }
+        }
+        fclose(status);
+
+        if (2 != found) {
+                errno = ENOTSUP;
+                return -1;
+        }
+        return 0;
+}
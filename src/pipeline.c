@@ -0,0 +1,412 @@
+#include "psrs/macro.h"
+#define PIPELINE_ONLY
+#include "psrs/pipeline.h"
+#undef PIPELINE_ONLY
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Sets up 'depth' slots on 'comm' for jobs of 'size' elements per process,
+ * which must be at least the number of processes so every process
+ * contributes as many regular samples; collective over 'comm'.
+ */
+int pipeline_init(struct pipeline **self,
+                  MPI_Comm comm,
+                  const unsigned int depth,
+                  const int size)
+{
+        struct pipeline *pipeline = NULL;
+        struct pipeline_slot *slot = NULL;
+        int process = 0;
+        int id = 0;
+        int failed = 0;
+        int any_failed = 0;
+
+        if (NULL == self || MPI_COMM_NULL == comm || 0U == depth) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Comm_size(comm, &process);
+        MPI_Comm_rank(comm, &id);
+
+        if (process > size) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        pipeline = (struct pipeline *)calloc(1U, sizeof(struct pipeline));
+        if (NULL == pipeline) {
+                return -1;
+        }
+
+        pipeline->depth = depth;
+        pipeline->id = id;
+        pipeline->process = process;
+        pipeline->size = size;
+        pipeline->slot = (struct pipeline_slot *)
+                         calloc(depth, sizeof(struct pipeline_slot));
+        pipeline->request = (MPI_Request *)
+                            malloc(depth * sizeof(MPI_Request));
+        failed = NULL == pipeline->slot || NULL == pipeline->request;
+
+        /* 'MPI_COMM_NULL' need not be all zeros. */
+        for (unsigned int i = 0U; !failed && i < depth; ++i) {
+                pipeline->slot[i].comm = MPI_COMM_NULL;
+        }
+
+        for (unsigned int i = 0U; !failed && i < depth; ++i) {
+                slot = &(pipeline->slot[i]);
+                pipeline->request[i] = MPI_REQUEST_NULL;
+                slot->stage = STAGE_FREE;
+                slot->arg.id = id;
+                slot->arg.process = process;
+                slot->arg.root = 0 == id;
+                slot->arg.size = size;
+                slot->arg.max_sample_size = process;
+                slot->arg.head = malloc(sizeof(long) * size);
+                slot->all_sample = malloc(sizeof(long) * process * process);
+                slot->send_count = malloc(sizeof(int) * process);
+                slot->send_displ = malloc(sizeof(int) * process);
+                slot->recv_count = malloc(sizeof(int) * process);
+                slot->recv_displ = malloc(sizeof(int) * process);
+                /*
+                 * The buffer the pieces of the local sort are merged
+                 * through, the partitions received and 2 buffers to merge
+                 * them in (about a block each), the samples and the
+                 * pivots, and the partitions formed and received.
+                 */
+                failed = NULL == slot->arg.head ||
+                         NULL == slot->all_sample ||
+                         NULL == slot->send_count ||
+                         NULL == slot->send_displ ||
+                         NULL == slot->recv_count ||
+                         NULL == slot->recv_displ ||
+                         0 > arena_init(&(slot->arg.arena),
+                                        sizeof(long) *
+                                        (4U * size + 2U * process) +
+                                        2U * sizeof(struct part_blk) +
+                                        2U * process *
+                                        sizeof(struct partition) +
+                                        8U * ARENA_ALIGN);
+        }
+
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+        if (any_failed) {
+                pipeline_destroy(&pipeline);
+                errno = ENOMEM;
+                return -1;
+        }
+
+        for (unsigned int i = 0U; i < depth; ++i) {
+                MPI_Comm_dup(comm, &(pipeline->slot[i].comm));
+                pipeline->slot[i].arg.comm = pipeline->slot[i].comm;
+        }
+
+        *self = pipeline;
+        return 0;
+}
+
+/*
+ * Sorts 'jobs' copies of 'block' (of the 'size' given to 'pipeline_init')
+ * as separate jobs, with up to 'depth' of them in flight at once, and
+ * records the seconds from the start to the end of each job on this
+ * process into 'latency'; collective over the communicator of 'self'.
+ *
+ * NOTE:
+ * The processes start the jobs in order, and each job runs through the
+ * phases of PSRS as usual: the local sort and the sampling, then the
+ * pivots, then the exchange and then the merge.  But instead of waiting for
+ * each collective, a process works on whatever other job is ready in the
+ * meantime, so for instance the local sort of a job overlaps the exchange
+ * of the one before it; it only blocks (in 'MPI_Waitany') when every job
+ * in flight is waiting for a collective.  With a 'depth' of 1 the very
+ * same code runs the jobs back to back.
+ *
+ * Most MPI implementations only move a collective along within an MPI
+ * call, so the local sort stops every 'PIPELINE_PIECE' elements to poll
+ * the collectives in flight (see 'pipeline_sort_'); otherwise the exchange
+ * of one job would not start moving until the local sort of the next one
+ * is over.
+ */
+int pipeline_run(struct pipeline *self,
+                 const long block[const],
+                 const unsigned int jobs,
+                 double latency[const])
+{
+        unsigned int started = 0U;
+        unsigned int done = 0U;
+        int index = MPI_UNDEFINED;
+        struct pipeline_slot *slot = NULL;
+
+        if (NULL == self || NULL == block || NULL == latency) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        while (done < jobs) {
+                slot = &(self->slot[started % self->depth]);
+                if (started < jobs && STAGE_FREE == slot->stage) {
+                        pipeline_start_(self, slot, block, started);
+                        started += 1U;
+                        continue;
+                }
+
+                MPI_Waitany(self->depth, self->request, &index,
+                            MPI_STATUS_IGNORE);
+                if (MPI_UNDEFINED == index) {
+                        errno = EDEADLK;
+                        return -1;
+                }
+                slot = &(self->slot[index]);
+                pipeline_advance_(self, slot, latency);
+                if (STAGE_FREE == slot->stage) {
+                        done += 1U;
+                }
+        }
+        return 0;
+}
+
+int pipeline_destroy(struct pipeline **self)
+{
+        struct pipeline *pipeline = NULL;
+        struct pipeline_slot *slot = NULL;
+
+        if (NULL == self || NULL == *self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        pipeline = *self;
+
+        for (unsigned int i = 0U;
+             NULL != pipeline->slot && i < pipeline->depth;
+             ++i) {
+                slot = &(pipeline->slot[i]);
+                if (MPI_COMM_NULL != slot->comm) {
+                        MPI_Comm_free(&(slot->comm));
+                }
+                if (NULL != slot->arg.arena) {
+                        arena_destroy(&(slot->arg.arena));
+                }
+                free(slot->recv_displ);
+                free(slot->recv_count);
+                free(slot->send_displ);
+                free(slot->send_count);
+                free(slot->all_sample);
+                free(slot->arg.head);
+        }
+        free(pipeline->request);
+        free(pipeline->slot);
+        free(pipeline);
+        *self = NULL;
+        return 0;
+}
+
+/*
+ * Starts the 'job'-th job in 'slot': sorts a fresh copy of 'block', picks
+ * its regular samples and sends them to root.
+ */
+static void pipeline_start_(struct pipeline *self,
+                            struct pipeline_slot *slot,
+                            const long block[const],
+                            const unsigned int job)
+{
+        slot->job = job;
+        slot->begin = MPI_Wtime();
+        if (0 > arena_reset(slot->arg.arena)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        memcpy(slot->arg.head, block, sizeof(long) * self->size);
+        pipeline_sort_(self, slot);
+        /* Every block has 'process' samples, as 'pipeline_init' ensures. */
+        local_sample(&(slot->sample), &(slot->arg));
+
+        slot->stage = STAGE_GATHER;
+        MPI_Igather(slot->sample.head, self->process, MPI_LONG,
+                    slot->all_sample, self->process, MPI_LONG,
+                    0, slot->comm, &(self->request[slot - self->slot]));
+}
+
+/*
+ * Does the work that follows the collective 'slot' waits for, which has
+ * just completed, and starts the next one; the job ends with the merge.
+ */
+static void pipeline_advance_(struct pipeline *self,
+                              struct pipeline_slot *slot,
+                              double latency[const])
+{
+        MPI_Request *const request = &(self->request[slot - self->slot]);
+        struct partition total_samples;
+
+        switch (slot->stage) {
+        case STAGE_GATHER:
+                if (slot->arg.root) {
+                        total_samples.head = slot->all_sample;
+                        total_samples.size = self->process * self->process;
+                        pivots_pick(&(slot->pivots),
+                                    &total_samples,
+                                    &(slot->arg));
+                } else {
+                        slot->pivots.size = self->process - 1;
+                        if (0 > arena_alloc(slot->arg.arena,
+                                            (void **)&(slot->pivots.head),
+                                            sizeof(long) *
+                                            slot->pivots.size)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                }
+                slot->stage = STAGE_BCAST;
+                MPI_Ibcast(slot->pivots.head, slot->pivots.size, MPI_LONG,
+                           0, slot->comm, request);
+                break;
+        case STAGE_BCAST:
+                if (0 > part_blk_init(&(slot->blk),
+                                      slot->arg.arena,
+                                      self->process)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                partition_form(slot->blk, &(slot->pivots), &(slot->arg));
+                for (int i = 0; i < self->process; ++i) {
+                        slot->send_count[i] = slot->blk->part[i].size;
+                        slot->send_displ[i] = (int)(slot->blk->part[i].head -
+                                                    slot->arg.head);
+                }
+                slot->stage = STAGE_COUNT;
+                MPI_Ialltoall(slot->send_count, 1, MPI_INT,
+                              slot->recv_count, 1, MPI_INT,
+                              slot->comm, request);
+                break;
+        case STAGE_COUNT:
+                slot->arg.merged_size = 0;
+                for (int i = 0; i < self->process; ++i) {
+                        slot->recv_displ[i] = slot->arg.merged_size;
+                        slot->arg.merged_size += slot->recv_count[i];
+                }
+                if (0 > arena_alloc(slot->arg.arena,
+                                    (void **)&(slot->recv),
+                                    sizeof(long) * slot->arg.merged_size)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                slot->stage = STAGE_EXCHANGE;
+                MPI_Ialltoallv(slot->arg.head, slot->send_count,
+                               slot->send_displ, MPI_LONG,
+                               slot->recv, slot->recv_count,
+                               slot->recv_displ, MPI_LONG,
+                               slot->comm, request);
+                break;
+        case STAGE_EXCHANGE:
+                pipeline_poll_(self);
+                pipeline_merge_(slot);
+                latency[slot->job] = MPI_Wtime() - slot->begin;
+                slot->stage = STAGE_FREE;
+                break;
+        default:
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+}
+
+/*
+ * Describes the partitions received as a 'part_blk' and merges them into
+ * 'slot->arg.merged' by 'partition_merge'.
+ */
+static void pipeline_merge_(struct pipeline_slot *slot)
+{
+        struct part_blk *received = NULL;
+        struct partition merged;
+
+        if (0 > part_blk_init(&received,
+                              slot->arg.arena,
+                              slot->arg.process)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        for (int i = 0; i < slot->arg.process; ++i) {
+                received->part[i].head = slot->recv + slot->recv_displ[i];
+                received->part[i].size = slot->recv_count[i];
+        }
+
+        partition_merge(&merged, received, &(slot->arg));
+        slot->arg.merged = merged.head;
+}
+
+/*
+ * Sorts the block of 'slot' as 'local_sort' does, but in pieces of
+ * 'PIPELINE_PIECE' elements that are then merged 2 at a time by
+ * 'array_merge', polling the collectives in flight after every piece and
+ * every merge.
+ */
+static void pipeline_sort_(struct pipeline *self,
+                           struct pipeline_slot *slot)
+{
+        const int size = self->size;
+        int lsize = 0;
+        int rsize = 0;
+        long *from = slot->arg.head;
+        long *to = NULL;
+        long *swap = NULL;
+        struct process_arg piece = slot->arg;
+
+        for (int i = 0; i < size; i += PIPELINE_PIECE) {
+                piece.head = slot->arg.head + i;
+                piece.size = size - i < PIPELINE_PIECE ?
+                             size - i : PIPELINE_PIECE;
+                local_sort(&piece);
+                pipeline_poll_(self);
+        }
+        if (PIPELINE_PIECE >= size) {
+                return;
+        }
+
+        if (0 > arena_alloc(slot->arg.arena,
+                            (void **)&to,
+                            sizeof(long) * size)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        for (int width = PIPELINE_PIECE;
+             width < size;
+             width = width > size / 2 ? size : 2 * width) {
+                for (int i = 0; i < size; i += lsize + rsize) {
+                        lsize = size - i < width ? size - i : width;
+                        rsize = size - i - lsize < width ?
+                                size - i - lsize : width;
+                        if (0 == rsize) {
+                                memcpy(to + i, from + i, sizeof(long) * lsize);
+                        } else if (0 > array_merge(to + i,
+                                                   from + i,
+                                                   lsize,
+                                                   from + i + lsize,
+                                                   rsize)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        pipeline_poll_(self);
+                }
+                swap = from;
+                from = to;
+                to = swap;
+        }
+        if (from != slot->arg.head) {
+                memcpy(slot->arg.head, from, sizeof(long) * size);
+        }
+}
+
+/*
+ * Lets the MPI library move the collectives in flight along without
+ * completing any of them: 'MPI_Request_get_status' leaves a request as it
+ * is, so 'MPI_Waitany' in 'pipeline_run' still sees it complete.
+ */
+static void pipeline_poll_(struct pipeline *self)
+{
+        int flag = 0;
+
+        for (unsigned int i = 0U; i < self->depth; ++i) {
+                if (MPI_REQUEST_NULL != self->request[i]) {
+                        MPI_Request_get_status(self->request[i],
+                                               &flag,
+                                               MPI_STATUS_IGNORE);
+                }
+        }
+}
@@ -0,0 +1,394 @@
+#include "psrs/macro.h"
+#define PLAN_ONLY
+#include "psrs/plan.h"
+#undef PLAN_ONLY
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Tags of the 2 kinds of messages, so neither ever matches the other. */
+enum {
+        PLAN_TAG_SAMPLE = 1,
+        PLAN_TAG_PART
+};
+
+/*
+ * Sets up the plan of a series of sorts on 'comm', where no process picks
+ * more than 'sample_max' regular samples; collective over 'comm'.
+ *
+ * NOTE:
+ * Only the receives of the samples on root are made up front; everything
+ * else is bound by the first run that needs it.
+ */
+int plan_init(struct plan **self, MPI_Comm comm, const int sample_max)
+{
+        struct plan *plan = NULL;
+        int process = 0;
+        int id = 0;
+        int peer_count = 0;
+        int failed = 0;
+        int any_failed = 0;
+
+        if (NULL == self || MPI_COMM_NULL == comm || 0 >= sample_max) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Comm_size(comm, &process);
+        MPI_Comm_rank(comm, &id);
+        peer_count = process - 1;
+
+        plan = (struct plan *)calloc(1U, sizeof(struct plan));
+        failed = NULL == plan;
+
+        if (!failed) {
+                plan->comm = comm;
+                plan->id = id;
+                plan->process = process;
+                plan->sample_max = sample_max;
+                plan->count = MPI_REQUEST_NULL;
+                plan->sample = malloc(sizeof(long) * sample_max);
+                plan->gather = malloc(sizeof(MPI_Request) * process);
+                plan->send_count = calloc(process, sizeof(int));
+                plan->recv_count = calloc(process, sizeof(int));
+                plan->send_head = calloc(process, sizeof(long *));
+                plan->send_bound = calloc(process, sizeof(int));
+                plan->recv_bound = calloc(process, sizeof(int));
+                plan->exchange = malloc(sizeof(MPI_Request) *
+                                        (2U * peer_count + 1U));
+                plan->status = malloc(sizeof(MPI_Status) *
+                                      (peer_count + 1U));
+                if (0 == id) {
+                        plan->all_sample = malloc(sizeof(long) *
+                                                  sample_max * process);
+                }
+                failed = NULL == plan->sample || NULL == plan->gather ||
+                         NULL == plan->send_count ||
+                         NULL == plan->recv_count ||
+                         NULL == plan->send_head ||
+                         NULL == plan->send_bound ||
+                         NULL == plan->recv_bound ||
+                         NULL == plan->exchange || NULL == plan->status ||
+                         (0 == id && NULL == plan->all_sample);
+        }
+
+        for (int i = 0; NULL != plan && i < process; ++i) {
+                if (NULL != plan->gather) {
+                        plan->gather[i] = MPI_REQUEST_NULL;
+                }
+        }
+        for (int i = 0; NULL != plan && i < 2 * peer_count; ++i) {
+                if (NULL != plan->exchange) {
+                        plan->exchange[i] = MPI_REQUEST_NULL;
+                }
+        }
+
+        MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+        if (any_failed) {
+                if (NULL != plan) {
+                        plan_destroy(&plan);
+                }
+                errno = ENOMEM;
+                return -1;
+        }
+
+        /* Root keeps its own samples where they are. */
+        for (int i = 1; 0 == id && i < process; ++i) {
+                MPI_Recv_init(plan->all_sample + (size_t)i * sample_max,
+                              sample_max,
+                              MPI_LONG,
+                              i,
+                              PLAN_TAG_SAMPLE,
+                              comm,
+                              &(plan->gather[i - 1]));
+        }
+
+#if MPI_VERSION >= 4
+        MPI_Alltoall_init(plan->send_count, 1, MPI_INT,
+                          plan->recv_count, 1, MPI_INT,
+                          comm, MPI_INFO_NULL, &(plan->count));
+#endif
+
+        *self = plan;
+        return 0;
+}
+
+/*
+ * Gathers the 'local_samples' of every process into 'total_samples' on
+ * root, as 'samples_gather' does; 'total_samples->head' points into the
+ * plan until the next call.  Collective over the communicator of 'self'.
+ */
+int plan_gather(struct plan *self,
+                struct partition *const total_samples,
+                const struct partition *const local_samples)
+{
+        int peer_count = 0;
+        int received = 0;
+        long *slot = NULL;
+
+        if (NULL == self || NULL == total_samples || NULL == local_samples ||
+            self->sample_max < local_samples->size) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        peer_count = self->process - 1;
+
+        memset(total_samples, 0, sizeof(struct partition));
+
+        if (0 != self->id) {
+                if (MPI_REQUEST_NULL == self->gather[0] ||
+                    local_samples->size != self->sample_bound) {
+                        if (MPI_REQUEST_NULL != self->gather[0]) {
+                                MPI_Request_free(&(self->gather[0]));
+                        }
+                        MPI_Send_init(self->sample,
+                                      local_samples->size,
+                                      MPI_LONG,
+                                      0,
+                                      PLAN_TAG_SAMPLE,
+                                      self->comm,
+                                      &(self->gather[0]));
+                        self->sample_bound = local_samples->size;
+                }
+                memcpy(self->sample,
+                       local_samples->head,
+                       sizeof(long) * local_samples->size);
+                MPI_Start(&(self->gather[0]));
+                MPI_Wait(&(self->gather[0]), MPI_STATUS_IGNORE);
+                return 0;
+        }
+
+        memcpy(self->all_sample,
+               local_samples->head,
+               sizeof(long) * local_samples->size);
+        total_samples->head = self->all_sample;
+        total_samples->size = local_samples->size;
+
+        if (0 == peer_count) {
+                return 0;
+        }
+
+        MPI_Startall(peer_count, self->gather);
+        MPI_Waitall(peer_count, self->gather, self->status);
+
+        /* The samples of each process are moved up against the previous. */
+        for (int i = 1; i <= peer_count; ++i) {
+                MPI_Get_count(&(self->status[i - 1]), MPI_LONG, &received);
+                slot = self->all_sample + (size_t)i * self->sample_max;
+                memmove(self->all_sample + total_samples->size,
+                        slot,
+                        sizeof(long) * received);
+                total_samples->size += received;
+        }
+        return 0;
+}
+
+/*
+ * Exchanges the partitions of 'blk' as 'partition_exchange' does, and
+ * describes the ones received in 'blk_copy': the partition a process keeps
+ * is referenced in place, and every other one points into the plan until
+ * the next call.  Collective over the communicator of 'self'.
+ *
+ * NOTE:
+ * The sends are bound to the partitions within the block of this process,
+ * so they are only reused if the block is at the same address again,
+ * which is the case for a block from an arena reset between the runs.
+ */
+int plan_exchange(struct plan *self,
+                  struct part_blk *const blk_copy,
+                  const struct part_blk *const blk)
+{
+        int peer_count = 0;
+        MPI_Request *send = NULL;
+        int peer = 0;
+        int received = 0;
+        size_t offset = 0U;
+
+        if (NULL == self || NULL == blk_copy || NULL == blk ||
+            self->process != blk->size || self->process != blk_copy->size) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        peer_count = self->process - 1;
+        send = self->exchange + peer_count;
+
+        for (int i = 0; i < self->process; ++i) {
+                self->send_count[i] = i == self->id ? 0 : blk->part[i].size;
+        }
+
+#if MPI_VERSION >= 4
+        MPI_Start(&(self->count));
+        MPI_Wait(&(self->count), MPI_STATUS_IGNORE);
+#else
+        MPI_Alltoall(self->send_count, 1, MPI_INT,
+                     self->recv_count, 1, MPI_INT,
+                     self->comm);
+#endif
+
+        if (0 > plan_recv_grow_(self)) {
+                return -1;
+        }
+
+        for (int i = 0; i < self->process; ++i) {
+                if (i == self->id) {
+                        continue;
+                }
+                peer = plan_peer_(self, i);
+                if (MPI_REQUEST_NULL != send[peer] &&
+                    blk->part[i].head == self->send_head[i] &&
+                    blk->part[i].size == self->send_bound[i]) {
+                        continue;
+                }
+                if (MPI_REQUEST_NULL != send[peer]) {
+                        MPI_Request_free(&(send[peer]));
+                }
+                MPI_Send_init(blk->part[i].head,
+                              blk->part[i].size,
+                              MPI_LONG,
+                              i,
+                              PLAN_TAG_PART,
+                              self->comm,
+                              &(send[peer]));
+                self->send_head[i] = blk->part[i].head;
+                self->send_bound[i] = blk->part[i].size;
+        }
+
+        if (0 < peer_count) {
+                MPI_Startall(2 * peer_count, self->exchange);
+                MPI_Waitall(peer_count, self->exchange, self->status);
+                MPI_Waitall(peer_count, send, MPI_STATUSES_IGNORE);
+        }
+
+        for (int i = 0; i < self->process; ++i) {
+                if (i == self->id) {
+                        blk_copy->part[i] = blk->part[i];
+                        continue;
+                }
+                MPI_Get_count(&(self->status[plan_peer_(self, i)]),
+                              MPI_LONG,
+                              &received);
+                if (received != self->recv_count[i]) {
+                        errno = EPROTO;
+                        return -1;
+                }
+                blk_copy->part[i].head = self->recv + offset;
+                blk_copy->part[i].size = received;
+                offset += self->recv_bound[i];
+        }
+        return 0;
+}
+
+int plan_destroy(struct plan **self)
+{
+        struct plan *plan = NULL;
+
+        if (NULL == self || NULL == *self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        plan = *self;
+
+        for (int i = 0; NULL != plan->gather && i < plan->process; ++i) {
+                if (MPI_REQUEST_NULL != plan->gather[i]) {
+                        MPI_Request_free(&(plan->gather[i]));
+                }
+        }
+        for (int i = 0;
+             NULL != plan->exchange && i < 2 * (plan->process - 1);
+             ++i) {
+                if (MPI_REQUEST_NULL != plan->exchange[i]) {
+                        MPI_Request_free(&(plan->exchange[i]));
+                }
+        }
+        if (MPI_REQUEST_NULL != plan->count) {
+                MPI_Request_free(&(plan->count));
+        }
+        free(plan->status);
+        free(plan->exchange);
+        free(plan->recv);
+        free(plan->recv_bound);
+        free(plan->send_bound);
+        free(plan->send_head);
+        free(plan->recv_count);
+        free(plan->send_count);
+        free(plan->gather);
+        free(plan->all_sample);
+        free(plan->sample);
+        free(plan);
+        *self = NULL;
+        return 0;
+}
+
+/* Index of process 'rank' among the others, which leave this one out. */
+static int plan_peer_(const struct plan *self, const int rank)
+{
+        return rank < self->id ? rank : rank - 1;
+}
+
+/*
+ * Binds the receives again if any partition to be received is larger than
+ * the room it has, growing the buffer along with it if need be; every
+ * receive then has room for the largest partition it has seen so far.
+ */
+static int plan_recv_grow_(struct plan *self)
+{
+        bool grow = false;
+        size_t total = 0U;
+        size_t offset = 0U;
+        long *recv = NULL;
+        MPI_Request *request = NULL;
+
+        for (int i = 0; i < self->process; ++i) {
+                if (i == self->id) {
+                        continue;
+                }
+                request = &(self->exchange[plan_peer_(self, i)]);
+                if (MPI_REQUEST_NULL == *request ||
+                    self->recv_count[i] > self->recv_bound[i]) {
+                        grow = true;
+                }
+                if (self->recv_count[i] > self->recv_bound[i]) {
+                        self->recv_bound[i] = self->recv_count[i];
+                }
+                total += self->recv_bound[i];
+        }
+
+        if (!grow) {
+                return 0;
+        }
+
+        if (self->recv_capacity < total) {
+                /* Nothing received before is needed any more. */
+                recv = malloc(sizeof(long) * total);
+                if (NULL == recv) {
+                        return -1;
+                }
+                free(self->recv);
+                self->recv = recv;
+                self->recv_capacity = total;
+        }
+
+        for (int i = 0; i < self->process; ++i) {
+                if (i == self->id) {
+                        continue;
+                }
+                request = &(self->exchange[plan_peer_(self, i)]);
+                if (MPI_REQUEST_NULL != *request) {
+                        MPI_Request_free(request);
+                }
+                MPI_Recv_init(self->recv + offset,
+                              self->recv_bound[i],
+                              MPI_LONG,
+                              i,
+                              PLAN_TAG_PART,
+                              self->comm,
+                              request);
+                offset += self->recv_bound[i];
+        }
+        return 0;
+}
@@ -4,11 +4,16 @@
 #undef PSRS_PSRS_ONLY
 
 #include "psrs/convert.h"
+#include "psrs/generator.h"
+#include "psrs/key.h"
+#include "psrs/record.h"
 #include "psrs/sort.h"
 
+#include <ctype.h>       /* toupper() */
 #include <errno.h>
 #include <getopt.h>      /* getopt_long() */
 #include <inttypes.h>    /* uintmax_t */
+#include <limits.h>      /* CHAR_MAX, ULONG_MAX */
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -47,7 +52,9 @@ int main(int argc, char *argv[])
          */
         MPI_Init(&argc, &argv);
         int rank;
-        struct cli_arg arg = { .binary = false };
+        struct cli_arg arg = {
+                .barrier = true, .binary = false, .trace_file = NULL
+        };
 
         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
@@ -69,19 +76,61 @@ int main(int argc, char *argv[])
         for (int i = 0; i < arg.process; ++i) {
                 if (rank == i) {
                         printf("Process #%d\n", rank);
-                        printf("Binary: %u\n"
+                        printf("Argsort: %u\n"
+                               "Barrier: %u\n"
+                               "Binary: %u\n"
+                               "Cold: %u\n"
+                               "Comm: %u\n"
+                               "Counter: %u\n"
+                               "Dist: %u\n"
+                               "Format: %u\n"
+                               "Group: %u\n"
                                "Length: %d\n"
+                               "Mem Limit: %lu\n"
+                               "Memory: %u\n"
+                               "Outlier: %u\n"
+                               "Persistent: %u\n"
                                "Phase: %u\n"
+                               "Pin: %u\n"
+                               "Pipeline: %u\n"
+                               "Record: %u\n"
                                "Run: %u\n"
                                "Seed: %u\n"
+                               "Segment: %u\n"
+                               "Serve: %u\n"
+                               "Sweep: %u\n"
+                               "Trace: %u\n"
+                               "Type: %u\n"
                                "Process: %d\n"
+                               "Warmup: %u\n"
                                "Window: %u\n",
+                               arg.argsort,
+                               arg.barrier,
                                arg.binary,
+                               arg.cold,
+                               arg.comm,
+                               arg.counter,
+                               arg.dist,
+                               arg.format,
+                               arg.group,
                                arg.length,
+                               arg.mem_limit,
+                               arg.memory,
+                               arg.outlier,
+                               arg.persistent,
                                arg.phase,
+                               arg.pin,
+                               arg.pipeline,
+                               arg.record_count,
                                arg.run,
                                arg.seed,
+                               arg.segment,
+                               arg.serve,
+                               arg.sweep,
+                               arg.trace,
+                               arg.type,
                                arg.process,
+                               arg.warmup,
                                arg.window);
                         puts("-----------------------");
                 }
@@ -113,6 +162,36 @@ int main(int argc, char *argv[])
 
 static int argument_parse(struct cli_arg *result, int argc, char *argv[])
 {
+        /*
+         * Options without a short form are identified by values beyond the
+         * range of 'char'.
+         */
+        enum {
+                OPT_NO_PHASE_BARRIERS = CHAR_MAX + 1,
+                OPT_TRACE,
+                OPT_COUNTERS,
+                OPT_FORMAT,
+                OPT_DIST,
+                OPT_SWEEP,
+                OPT_SWEEP_LENGTHS,
+                OPT_SWEEP_DISTS,
+                OPT_SWEEP_PROCS,
+                OPT_WARMUP,
+                OPT_COLD,
+                OPT_PIN,
+                OPT_REJECT_OUTLIERS,
+                OPT_COMM,
+                OPT_MEMORY,
+                OPT_MEM_LIMIT,
+                OPT_GROUPS,
+                OPT_SERVE,
+                OPT_SEGMENTS,
+                OPT_PIPELINE,
+                OPT_PERSISTENT,
+                OPT_TYPE,
+                OPT_RECORDS,
+                OPT_ARGSORT
+        };
         /* NOTE: All the flags followed by an extra colon require arguments. */
         static const char *const OPT_STR = ":bhl:pr:s:w:";
         static const struct option OPTS[] = {
@@ -123,6 +202,45 @@ static int argument_parse(struct cli_arg *result, int argc, char *argv[])
                 {"run",      required_argument, NULL, 'r'},
                 {"seed",     required_argument, NULL, 's'},
                 {"window",   required_argument, NULL, 'w'},
+                {
+                        "no-phase-barriers",
+                        no_argument,
+                        NULL,
+                        OPT_NO_PHASE_BARRIERS
+                },
+                {"trace",    required_argument, NULL, OPT_TRACE},
+                {"counters", no_argument,       NULL, OPT_COUNTERS},
+                {"format",   required_argument, NULL, OPT_FORMAT},
+                {"dist",     required_argument, NULL, OPT_DIST},
+                {"sweep",    no_argument,       NULL, OPT_SWEEP},
+                {
+                        "sweep-lengths",
+                        required_argument,
+                        NULL,
+                        OPT_SWEEP_LENGTHS
+                },
+                {"sweep-dists", required_argument, NULL, OPT_SWEEP_DISTS},
+                {"sweep-procs", required_argument, NULL, OPT_SWEEP_PROCS},
+                {"warmup",   required_argument, NULL, OPT_WARMUP},
+                {"cold",     no_argument,       NULL, OPT_COLD},
+                {"pin",      no_argument,       NULL, OPT_PIN},
+                {
+                        "reject-outliers",
+                        no_argument,
+                        NULL,
+                        OPT_REJECT_OUTLIERS
+                },
+                {"comm",     no_argument,       NULL, OPT_COMM},
+                {"memory",   no_argument,       NULL, OPT_MEMORY},
+                {"mem-limit", required_argument, NULL, OPT_MEM_LIMIT},
+                {"groups",   required_argument, NULL, OPT_GROUPS},
+                {"serve",    required_argument, NULL, OPT_SERVE},
+                {"segments", required_argument, NULL, OPT_SEGMENTS},
+                {"pipeline", required_argument, NULL, OPT_PIPELINE},
+                {"persistent", no_argument,     NULL, OPT_PERSISTENT},
+                {"type",     required_argument, NULL, OPT_TYPE},
+                {"records",  required_argument, NULL, OPT_RECORDS},
+                {"argsort",  no_argument,       NULL, OPT_ARGSORT},
                 {
                         .name    = NULL,
                         .has_arg = 0,
@@ -157,15 +275,77 @@ static int argument_parse(struct cli_arg *result, int argc, char *argv[])
                 return -1;
         }
 
+        /*
+         * By default, all the processes are synchronized between phases.
+         */
+        result->barrier = true;
         /*
          * By default, output average sorting time(s) in human readable form.
          */
         result->binary = false;
+        /*
+         * By default, the caches are left as they are between runs (warm),
+         * no process is pinned, every run within the moving window counts,
+         * and no run is thrown away up front.
+         */
+        result->cold = false;
+        result->pin = false;
+        result->outlier = false;
+        result->warmup = 0U;
+        /*
+         * By default, every run sends the samples and the partitions
+         * afresh.
+         */
+        result->persistent = false;
+        /*
+         * By default, no hardware performance counter is read, and no MPI
+         * call is accounted.
+         */
+        result->counter = false;
+        result->comm = false;
+        result->memory = false;
+        /*
+         * By default, the memory is not bounded.
+         */
+        result->mem_limit = 0UL;
+        /*
+         * By default, the values to be sorted are uniformly random.
+         */
+        result->dist = DIST_UNIFORM;
+        result->type = KEY_LONG;
+        /*
+         * By default, output the result as human readable table(s).
+         */
+        result->format = FORMAT_TEXT;
+        /*
+         * By default, all the processes sort a single array together.
+         */
+        result->group = 0U;
+        result->segment = 0U;
+        result->pipeline = 0U;
+        result->record_count = 0U;
+        result->argsort = false;
         /*
          * By default, output a single total sorting time.
          * Output per-phase sorting time (phase 1 to 4) if set to 'true'.
          */
         result->phase = false;
+        /*
+         * By default, only the single case given by the length, the
+         * distribution and the number of processes launched is sorted;
+         * an empty list of the sweep falls back to that single value.
+         */
+        result->sweep = false;
+        result->sweep_length_count = 0U;
+        result->sweep_dist_count = 0U;
+        result->sweep_process_count = 0U;
+        /*
+         * By default, no trace is written.
+         */
+        result->trace = false;
+        result->trace_file = NULL;
+        result->serve = false;
+        result->serve_path = NULL;
 
         while (-1 != (opt = getopt_long(argc, argv, OPT_STR, OPTS, NULL))) {
                 /*
@@ -227,6 +407,176 @@ static int argument_parse(struct cli_arg *result, int argc, char *argv[])
                         check[WINDOW] = true;
                         break;
                 }
+                case OPT_NO_PHASE_BARRIERS:
+                        result->barrier = false;
+                        break;
+                case OPT_COUNTERS:
+                        result->counter = true;
+                        break;
+                case OPT_COMM:
+                        result->comm = true;
+                        break;
+                case OPT_MEMORY:
+                        result->memory = true;
+                        break;
+                case OPT_GROUPS:
+                        if (0 > unsigned_convert(&result->group, optarg) ||
+                            0U == result->group) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Groups must be a positive "
+                                           "number");
+                        }
+                        break;
+                case OPT_SEGMENTS:
+                        if (0 > unsigned_convert(&result->segment, optarg) ||
+                            0U == result->segment) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Segments must be a positive "
+                                           "number");
+                        }
+                        break;
+                case OPT_PIPELINE:
+                        if (0 > unsigned_convert(&result->pipeline,
+                                                 optarg) ||
+                            0U == result->pipeline) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Pipeline depth must be a "
+                                           "positive number");
+                        }
+                        break;
+                case OPT_MEM_LIMIT: {
+                        size_t limit = 0U;
+
+                        if (0 > sizet_convert(&limit, optarg) ||
+                            ULONG_MAX < limit || sizeof(long) > limit) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Memory limit must be a number of "
+                                           "bytes that holds 1 element");
+                        }
+                        result->mem_limit = (unsigned long)limit;
+                        break;
+                }
+                case OPT_FORMAT:
+                        if (0 == strcmp("text", optarg)) {
+                                result->format = FORMAT_TEXT;
+                        } else if (0 == strcmp("json", optarg)) {
+                                result->format = FORMAT_JSON;
+                        } else if (0 == strcmp("csv", optarg)) {
+                                result->format = FORMAT_CSV;
+                        } else {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Format must be one of text, "
+                                           "json or csv");
+                        }
+                        break;
+                case OPT_TRACE:
+                        result->trace = true;
+                        result->trace_file = optarg;
+                        break;
+                case OPT_SERVE:
+                        result->serve = true;
+                        result->serve_path = optarg;
+                        break;
+                case OPT_DIST:
+                        if (0 > array_dist_convert(&result->dist, optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Distribution must be one of "
+                                           "uniform, sorted, reverse or "
+                                           "few-unique");
+                        }
+                        break;
+                case OPT_TYPE:
+                        if (0 > key_type_convert(&result->type, optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Type must be one of long, "
+                                           "int32, uint32, int64, uint64, "
+                                           "float or double");
+                        }
+                        break;
+                case OPT_SWEEP:
+                        result->sweep = true;
+                        break;
+                case OPT_WARMUP: {
+                        if (0 > unsigned_convert(&result->warmup, optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Warmup is too large or not valid");
+                        }
+                        break;
+                }
+                case OPT_COLD:
+                        result->cold = true;
+                        break;
+                case OPT_PIN:
+                        result->pin = true;
+                        break;
+                case OPT_REJECT_OUTLIERS:
+                        result->outlier = true;
+                        break;
+                case OPT_PERSISTENT:
+                        result->persistent = true;
+                        break;
+                case OPT_ARGSORT:
+                        result->argsort = true;
+                        break;
+                case OPT_SWEEP_LENGTHS:
+                        if (0 > argument_list_parse(
+                                        result->sweep_length,
+                                        &result->sweep_length_count,
+                                        optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Sweep lengths must be a list of "
+                                           "at most 16 lengths");
+                        }
+                        /* '-l' is then only needed as the default. */
+                        if (false == check[LENGTH]) {
+                                result->length = result->sweep_length[0];
+                        }
+                        check[LENGTH] = true;
+                        result->sweep = true;
+                        break;
+                case OPT_RECORDS:
+                        if (0 > argument_list_parse(result->record,
+                                                    &result->record_count,
+                                                    optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Records must be a list of at "
+                                           "most 16 payload sizes");
+                        }
+                        break;
+                case OPT_SWEEP_DISTS:
+                        if (0 > argument_dist_list_parse(
+                                        result->sweep_dist,
+                                        &result->sweep_dist_count,
+                                        optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Sweep distributions must be a "
+                                           "list of at most 16 distributions");
+                        }
+                        result->sweep = true;
+                        break;
+                case OPT_SWEEP_PROCS:
+                        if (0 > argument_list_parse(
+                                        result->sweep_process,
+                                        &result->sweep_process_count,
+                                        optarg)) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Sweep processes must be a list of "
+                                           "at most 16 numbers");
+                        }
+                        result->sweep = true;
+                        break;
                 case '?':
                         usage_show(program_name,
                                    EXIT_FAILURE,
@@ -272,15 +622,107 @@ static int argument_parse(struct cli_arg *result, int argc, char *argv[])
                            EXIT_FAILURE,
                            "Length is larger than (SIZE_MAX / sizeof(long))");
         }
-        free(program_name);
 
         MPI_Comm_size(MPI_COMM_WORLD, &(result->process));
 
-        if (0 != result->length % result->process) {
+        if (result->sweep) {
+                if (0U == result->sweep_length_count) {
+                        result->sweep_length[0] = result->length;
+                        result->sweep_length_count = 1U;
+                }
+                if (0U == result->sweep_dist_count) {
+                        result->sweep_dist[0] = result->dist;
+                        result->sweep_dist_count = 1U;
+                }
+                if (0U == result->sweep_process_count) {
+                        result->sweep_process[0] = result->process;
+                        result->sweep_process_count = 1U;
+                }
+        } else {
+                result->sweep_length[0] = result->length;
+                result->sweep_process[0] = result->process;
+                result->sweep_length_count = 1U;
+                result->sweep_process_count = 1U;
+        }
+
+        for (unsigned int i = 0U; i < result->sweep_process_count; ++i) {
+                if (0 >= result->sweep_process[i] ||
+                    result->process < result->sweep_process[i]) {
+                        usage_show(program_name,
+                                   EXIT_FAILURE,
+                                   "Sweep processes must be between 1 and "
+                                   "the number of processes launched");
+                }
+        }
+
+        for (unsigned int i = 0U; i < result->sweep_length_count; ++i) {
+                if (0 >= result->sweep_length[i] ||
+                    (SIZE_MAX / sizeof(long)) <
+                    (size_t)result->sweep_length[i]) {
+                        usage_show(program_name,
+                                   EXIT_FAILURE,
+                                   "Sweep lengths must be positive and "
+                                   "no larger than (SIZE_MAX / sizeof(long))");
+                }
+                for (unsigned int j = 0U;
+                     j < result->sweep_process_count;
+                     ++j) {
+                        if (0 != result->sweep_length[i] %
+                                 result->sweep_process[j]) {
+                                usage_show(program_name,
+                                           EXIT_FAILURE,
+                                           "Length is not divisible by the "
+                                           "number of process(es)");
+                        }
+                }
+        }
+
+        argument_conflict_check(result, program_name);
+
+        if (0U != result->segment &&
+            ((unsigned int)result->length < result->segment ||
+             0 != result->length % (int)result->segment)) {
                 usage_show(program_name,
                            EXIT_FAILURE,
                            "Length is not divisible by the number of "
-                           "process(es)");
+                           "segments");
+        }
+
+        for (unsigned int i = 0U; i < result->record_count; ++i) {
+                if ((int)RECORD_PAYLOAD_MIN > result->record[i] ||
+                    (int)RECORD_PAYLOAD_MAX < result->record[i] ||
+                    0 != result->record[i] % (int)RECORD_PAYLOAD_MIN) {
+                        usage_show(program_name,
+                                   EXIT_FAILURE,
+                                   "Records must be payload sizes that are "
+                                   "multiples of 8 between 8 and 120");
+                }
+        }
+
+        /* Each process picks a regular sample for every process. */
+        if (KEY_LONG != result->type &&
+            result->length / result->process < result->process) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Type needs a block of at least one element "
+                           "per process");
+        }
+
+        /* Each process picks a regular sample for every process. */
+        if (0U != result->pipeline &&
+            result->length / result->process < result->process) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Pipeline needs a block of at least one element "
+                           "per process");
+        }
+
+        if (0U != result->group &&
+            0 != result->process % (int)result->group) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Number of process(es) is not divisible by "
+                           "the number of groups");
         }
 
         if (result->phase && 1 >= result->process) {
@@ -289,9 +731,206 @@ static int argument_parse(struct cli_arg *result, int argc, char *argv[])
                            "Phase can not be used when there is "
                            "only one process");
         }
+
+        if (result->binary && FORMAT_TEXT != result->format) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Binary can not be used along with "
+                           "json or csv format");
+        }
+
+        if (result->counter && 1 >= result->process) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Counters can not be used when there is "
+                           "only one process");
+        }
+
+        if (result->comm && 1 >= result->process) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Comm can not be used when there is "
+                           "only one process");
+        }
+
+        if (result->memory && 1 >= result->process) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Memory can not be used when there is "
+                           "only one process");
+        }
+
+        if (0UL != result->mem_limit && 1 >= result->process) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Memory limit can not be used when there is "
+                           "only one process");
+        }
+
+#ifndef PSRS_PMPI
+        if (result->comm) {
+                usage_show(program_name,
+                           EXIT_FAILURE,
+                           "Comm needs the PMPI layer; "
+                           "rebuild with -DPSRS_PMPI=ON");
+        }
+#endif
+        /* Every check above may still show it along with the usage. */
+        free(program_name);
         return 0;
 }
 
+/*
+ * Whether each option of 'enum cli_option' is given in 'arg', as a mask of
+ * 'CLI_BIT's.
+ */
+static unsigned long argument_option_given(const struct cli_arg *arg)
+{
+        const bool given[CLI_OPTION_COUNT] = {
+                [CLI_SWEEP]      = arg->sweep,
+                [CLI_BINARY]     = arg->binary,
+                [CLI_TRACE]      = arg->trace,
+                [CLI_PHASE]      = arg->phase,
+                [CLI_COUNTERS]   = arg->counter,
+                [CLI_COMM]       = arg->comm,
+                [CLI_MEMORY]     = arg->memory,
+                [CLI_COLD]       = arg->cold,
+                [CLI_GROUPS]     = 0U != arg->group,
+                [CLI_SERVE]      = arg->serve,
+                [CLI_SEGMENTS]   = 0U != arg->segment,
+                [CLI_PIPELINE]   = 0U != arg->pipeline,
+                [CLI_PERSISTENT] = arg->persistent,
+                [CLI_TYPE]       = KEY_LONG != arg->type,
+                [CLI_RECORDS]    = 0U != arg->record_count,
+                [CLI_ARGSORT]    = arg->argsort,
+                [CLI_MEM_LIMIT]  = 0UL != arg->mem_limit
+        };
+        unsigned long mask = 0UL;
+
+        for (int i = 0; i < CLI_OPTION_COUNT; ++i) {
+                mask |= given[i] ? CLI_BIT(i) : 0UL;
+        }
+        return mask;
+}
+
+/*
+ * Shows the usage of 'name' and exits if 'arg' gives any 2 options of
+ * 'enum cli_option' that can not be used along with each other.
+ */
+static void argument_conflict_check(const struct cli_arg *arg,
+                                    const char *name)
+{
+        /*
+         * Every mode below reports only what it measures itself, none of
+         * the per-run details of a single sort.
+         */
+        static const unsigned long SINGLE_SORT =
+                CLI_BIT(CLI_SWEEP) | CLI_BIT(CLI_BINARY) |
+                CLI_BIT(CLI_TRACE) | CLI_BIT(CLI_PHASE) |
+                CLI_BIT(CLI_COUNTERS) | CLI_BIT(CLI_COMM) |
+                CLI_BIT(CLI_MEMORY) | CLI_BIT(CLI_COLD);
+        /* The options each one can not be used along with. */
+        const struct {
+                const char *name;
+                unsigned long conflict;
+        } OPTION[CLI_OPTION_COUNT] = {
+                [CLI_SWEEP]      = { "sweep",      0UL },
+                [CLI_BINARY]     = { "binary",     CLI_BIT(CLI_SWEEP) },
+                [CLI_TRACE]      = { "trace",      CLI_BIT(CLI_SWEEP) },
+                [CLI_PHASE]      = { "phase",      0UL },
+                [CLI_COUNTERS]   = { "counters",   0UL },
+                [CLI_COMM]       = { "comm",       0UL },
+                [CLI_MEMORY]     = { "memory",     0UL },
+                [CLI_COLD]       = { "cold",       0UL },
+                /*
+                 * A batch of sorts only reports the time of every sort and
+                 * the throughput of all of them.
+                 */
+                [CLI_GROUPS]     = { "groups",     SINGLE_SORT },
+                /*
+                 * A service reports the queueing and the time of every job,
+                 * each of which is sorted only once.
+                 */
+                [CLI_SERVE]      = {
+                        "serve",
+                        SINGLE_SORT | CLI_BIT(CLI_GROUPS)
+                },
+                /* Segments only report the time of sorting all of them. */
+                [CLI_SEGMENTS]   = {
+                        "segments",
+                        SINGLE_SORT | CLI_BIT(CLI_GROUPS) | CLI_BIT(CLI_SERVE)
+                },
+                /*
+                 * A pipeline only reports the jobs per second and their
+                 * latency.
+                 */
+                [CLI_PIPELINE]   = {
+                        "pipeline",
+                        SINGLE_SORT | CLI_BIT(CLI_GROUPS) |
+                        CLI_BIT(CLI_SERVE) | CLI_BIT(CLI_SEGMENTS) |
+                        CLI_BIT(CLI_MEM_LIMIT)
+                },
+                /*
+                 * Only the runs of a single sort reuse their requests; the
+                 * PMPI layer does not account for the persistent ones.
+                 */
+                [CLI_PERSISTENT] = {
+                        "persistent",
+                        CLI_BIT(CLI_COMM) | CLI_BIT(CLI_GROUPS) |
+                        CLI_BIT(CLI_SERVE) | CLI_BIT(CLI_SEGMENTS) |
+                        CLI_BIT(CLI_PIPELINE) | CLI_BIT(CLI_MEM_LIMIT)
+                },
+                /*
+                 * Keys of other types, records and an argsort only report
+                 * the time of a whole sort, and none of them is combined
+                 * with another.
+                 */
+                [CLI_TYPE]       = {
+                        "type",
+                        SINGLE_SORT | CLI_BIT(CLI_GROUPS) |
+                        CLI_BIT(CLI_SERVE) | CLI_BIT(CLI_SEGMENTS) |
+                        CLI_BIT(CLI_PIPELINE) | CLI_BIT(CLI_PERSISTENT) |
+                        CLI_BIT(CLI_MEM_LIMIT)
+                },
+                [CLI_RECORDS]    = {
+                        "records",
+                        SINGLE_SORT | CLI_BIT(CLI_GROUPS) |
+                        CLI_BIT(CLI_SERVE) | CLI_BIT(CLI_SEGMENTS) |
+                        CLI_BIT(CLI_PIPELINE) | CLI_BIT(CLI_PERSISTENT) |
+                        CLI_BIT(CLI_TYPE) | CLI_BIT(CLI_MEM_LIMIT)
+                },
+                [CLI_ARGSORT]    = {
+                        "argsort",
+                        SINGLE_SORT | CLI_BIT(CLI_GROUPS) |
+                        CLI_BIT(CLI_SERVE) | CLI_BIT(CLI_SEGMENTS) |
+                        CLI_BIT(CLI_PIPELINE) | CLI_BIT(CLI_PERSISTENT) |
+                        CLI_BIT(CLI_TYPE) | CLI_BIT(CLI_RECORDS) |
+                        CLI_BIT(CLI_MEM_LIMIT)
+                },
+                [CLI_MEM_LIMIT]  = { "mem-limit",  0UL }
+        };
+        const unsigned long given = argument_option_given(arg);
+        char msg[64];
+
+        for (int i = 0; i < CLI_OPTION_COUNT; ++i) {
+                if (!(given & CLI_BIT(i))) {
+                        continue;
+                }
+                for (int j = 0; j < CLI_OPTION_COUNT; ++j) {
+                        if (!(given & OPTION[i].conflict & CLI_BIT(j))) {
+                                continue;
+                        }
+                        snprintf(msg,
+                                 sizeof msg,
+                                 "%s can not be used along with %s",
+                                 OPTION[i].name,
+                                 OPTION[j].name);
+                        msg[0] = (char)toupper((unsigned char)msg[0]);
+                        usage_show(name, EXIT_FAILURE, msg);
+                }
+        }
+}
+
 static void argument_bcast(struct cli_arg *arg)
 {
         /*
@@ -299,22 +938,156 @@ static void argument_bcast(struct cli_arg *arg)
          * the first barrier is mainly waiting for root process.
          * */
         MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->argsort), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->barrier), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->binary), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->cold), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->comm), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->counter), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->dist), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->format), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->group), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->length), 1, MPI_INT, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->mem_limit), 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->memory), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->outlier), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->persistent), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->phase), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->pin), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->pipeline), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(arg->record, SWEEP_MAX, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->record_count), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->run), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->seed), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->segment), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->serve), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->sweep), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(arg->sweep_length, SWEEP_MAX, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->sweep_length_count),
+                  1,
+                  MPI_UNSIGNED,
+                  0,
+                  MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(arg->sweep_dist, SWEEP_MAX, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->sweep_dist_count),
+                  1,
+                  MPI_UNSIGNED,
+                  0,
+                  MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(arg->sweep_process, SWEEP_MAX, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->sweep_process_count),
+                  1,
+                  MPI_UNSIGNED,
+                  0,
+                  MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->trace), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->type), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->process), 1, MPI_INT, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Bcast(&(arg->warmup), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
         MPI_Bcast(&(arg->window), 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
         MPI_Barrier(MPI_COMM_WORLD);
 }
 
+/*
+ * Parses the comma-separated list of integers 'candidate' into 'list' of
+ * at most 'SWEEP_MAX' items.
+ */
+static int argument_list_parse(int list[const],
+                               unsigned int *const count,
+                               const char *const candidate)
+{
+        char *token[SWEEP_MAX];
+        char *str = NULL;
+        int retval = 0;
+
+        if (NULL == list || NULL == count || NULL == candidate) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (NULL == (str = strdup(candidate))) {
+                return -1;
+        }
+
+        if (0 > token_split(str, token, count, SWEEP_MAX) || 0U == *count) {
+                retval = -1;
+        }
+
+        for (unsigned int i = 0U; 0 == retval && i < *count; ++i) {
+                retval = int_convert(&list[i], token[i]);
+        }
+
+        free(str);
+        return retval;
+}
+
+/*
+ * Same as 'argument_list_parse' except that the items are names of
+ * 'enum array_dist'.
+ */
+static int argument_dist_list_parse(unsigned int list[const],
+                                    unsigned int *const count,
+                                    const char *const candidate)
+{
+        char *token[SWEEP_MAX];
+        char *str = NULL;
+        int retval = 0;
+
+        if (NULL == list || NULL == count || NULL == candidate) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (NULL == (str = strdup(candidate))) {
+                return -1;
+        }
+
+        if (0 > token_split(str, token, count, SWEEP_MAX) || 0U == *count) {
+                retval = -1;
+        }
+
+        for (unsigned int i = 0U; 0 == retval && i < *count; ++i) {
+                retval = array_dist_convert(&list[i], token[i]);
+        }
+
+        free(str);
+        return retval;
+}
+
 static void usage_show(const char *name, int status, const char *msg)
 {
         if (NULL != msg) {
@@ -331,12 +1104,99 @@ static void usage_show(const char *name, int status, const char *msg)
                 "[-p]\n"
                 "[-r NUMBER_OF_RUNS]\n"
                 "[-s SEED]\n"
-                "[-w MOVING_WINDOW_SIZE]\n\n"
+                "[-w MOVING_WINDOW_SIZE]\n"
+                "[--no-phase-barriers]\n"
+                "[--trace FILE]\n"
+                "[--counters]\n"
+                "[--format FORMAT]\n"
+                "[--dist DIST]\n"
+                "[--sweep]\n"
+                "[--sweep-lengths LIST]\n"
+                "[--sweep-dists LIST]\n"
+                "[--sweep-procs LIST]\n"
+                "[--warmup NUMBER_OF_RUNS]\n"
+                "[--cold]\n"
+                "[--pin]\n"
+                "[--reject-outliers]\n"
+                "[--comm]\n"
+                "[--memory]\n"
+                "[--mem-limit BYTES]\n"
+                "[--groups NUMBER_OF_GROUPS]\n"
+                "[--serve FIFO]\n"
+                "[--segments NUMBER_OF_SEGMENTS]\n"
+                "[--pipeline DEPTH]\n"
+                "[--persistent]\n"
+                "[--type TYPE]\n"
+                "[--records LIST]\n"
+                "[--argsort]\n\n"
 
                 "[" ANSI_COLOR_BLUE "Optional Arguments" ANSI_COLOR_RESET "]\n"
                 "-b, --binary\tgive binary output instead of text\n"
                 "-h, --help\tshow this help message and exit\n"
-                "-p, --phase\tshow per-phase sorting time instead of total\n\n"
+                "-p, --phase\tshow per-phase sorting time instead of total\n"
+                "--no-phase-barriers\n"
+                "\t\tdo not synchronize processes between phases\n"
+                "--trace FILE\twrite a timeline of every process into FILE\n"
+                "\t\tin Chrome trace format (for Perfetto)\n"
+                "--counters\tshow hardware performance counters per phase\n"
+                "--format FORMAT\n"
+                "\t\toutput format: text (default), json or csv;\n"
+                "\t\tjson and csv include the run metadata and every run\n"
+                "--dist DIST\tdistribution of the values to be sorted:\n"
+                "\t\tuniform (default), sorted, reverse or few-unique\n"
+                "--sweep\t\tsort every combination of the sweep lists below\n"
+                "\t\tin one launch and report all of them together\n"
+                "--sweep-lengths LIST\n"
+                "\t\tcomma-separated lengths (default: -l)\n"
+                "--sweep-dists LIST\n"
+                "\t\tcomma-separated distributions (default: --dist)\n"
+                "--sweep-procs LIST\n"
+                "\t\tcomma-separated numbers of processes, each no more\n"
+                "\t\tthan the one launched (default: all of them)\n"
+                "--warmup NUMBER_OF_RUNS\n"
+                "\t\truns thrown away before the measured ones\n"
+                "--cold\t\tflush the caches before every run\n"
+                "--pin\t\tpin every process to a CPU of its own\n"
+                "--reject-outliers\n"
+                "\t\tleave out runs whose modified z-score (by the\n"
+                "\t\tmedian absolute deviation) exceeds 3.5\n"
+                "--comm\t\tshow calls, bytes and blocking time of every\n"
+                "\t\tMPI function per phase (needs PSRS_PMPI)\n"
+                "--memory\tshow allocations and resident set size of\n"
+                "\t\tevery process per phase\n"
+                "--mem-limit BYTES\n"
+                "\t\treceive at most BYTES at once while exchanging\n"
+                "\t\tpartitions, merging as they arrive\n"
+                "--groups NUMBER_OF_GROUPS\n"
+                "\t\tsplit the processes into groups that each sort a\n"
+                "\t\ttable of their own concurrently, and show the\n"
+                "\t\tsorts per second of all of them\n"
+                "--serve FIFO\tstay up and sort every job written into FIFO\n"
+                "\t\tas \"LENGTH [SEED [DIST]]\" until \"quit\", with -l\n"
+                "\t\tas the size to allocate for, -r as the most jobs\n"
+                "\t\tand --warmup jobs left out of the statistics\n"
+                "--segments NUMBER_OF_SEGMENTS\n"
+                "\t\tsort the array as independent segments of equal\n"
+                "\t\tlength, in a single pass and one after another,\n"
+                "\t\tand show the segments per second of both\n"
+                "--pipeline DEPTH\n"
+                "\t\tsort -r jobs with up to DEPTH of them in flight,\n"
+                "\t\toverlapping their phases, and back to back, and\n"
+                "\t\tshow the jobs per second of both\n"
+                "--persistent\tmake the requests of the sample gather and\n"
+                "\t\tthe partition exchange once and restart them\n"
+                "\t\tevery run\n"
+                "--type TYPE\ttype of the keys: long (default), int32,\n"
+                "\t\tuint32, int64, uint64, float or double; any but\n"
+                "\t\tlong is radix sorted, and float and double are\n"
+                "\t\tordered -NaN < -inf < -0.0 < +0.0 < +inf < +NaN\n"
+                "--records LIST\tsort records of a 64-bit key and a payload\n"
+                "\t\tof each comma-separated size (multiples of 8, up\n"
+                "\t\tto 120 bytes), carrying the payloads along and\n"
+                "\t\tfetching them after the keys, and show both\n"
+                "--argsort\tsort stably, returning the original index of\n"
+                "\t\tevery element along with it, and show the cost\n"
+                "\t\tover the unstable sort\n\n"
 
                 "[" ANSI_COLOR_BLUE "Required Arguments" ANSI_COLOR_RESET "]\n"
                 "-l, --length\tlength of the array to be sorted\n"
@@ -0,0 +1,389 @@
+#include "psrs/macro.h"
+#define RECORD_ONLY
+#include "psrs/record.h"
+#undef RECORD_ONLY
+
+#include "psrs/key.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Bytes of a (key, origin) pair of 'RECORD_PERMUTE'. */
+#define RECORD_PAIR_SIZE (2U * sizeof(int64_t))
+
+static const char *const RECORD_STRATEGY_NAME[RECORD_STRATEGY_COUNT] = {
+        "carry",
+        "permute"
+};
+
+/*
+ * Sets up the layout of records with 'payload' bytes after their key,
+ * which must be a multiple of 'RECORD_PAYLOAD_MIN' no greater than
+ * 'RECORD_PAYLOAD_MAX'; the data types it holds are committed, so it must
+ * be passed to 'record_layout_destroy' once done with.
+ *
+ * NOTE:
+ * The data type of a record is resized to the size of a record, so it
+ * describes consecutive records of an array whatever the alignment of its
+ * members would have made its extent.
+ */
+int record_layout_init(struct record_layout *self, const size_t payload)
+{
+        int length[2] = { 1, 0 };
+        MPI_Aint displ[2] = { 0, (MPI_Aint)sizeof(int64_t) };
+        MPI_Datatype member[2] = { MPI_INT64_T, MPI_BYTE };
+        MPI_Datatype record = MPI_DATATYPE_NULL;
+
+        if (NULL == self || RECORD_PAYLOAD_MIN > payload ||
+            RECORD_PAYLOAD_MAX < payload ||
+            0U != payload % RECORD_PAYLOAD_MIN) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        self->payload = payload;
+        self->size = sizeof(int64_t) + payload;
+        length[1] = (int)payload;
+
+        MPI_Type_create_struct(2, length, displ, member, &record);
+        MPI_Type_create_resized(record,
+                                0,
+                                (MPI_Aint)self->size,
+                                &(self->datatype));
+        MPI_Type_free(&record);
+        MPI_Type_commit(&(self->datatype));
+
+        MPI_Type_contiguous((int)payload, MPI_BYTE, &(self->payload_type));
+        MPI_Type_commit(&(self->payload_type));
+
+        MPI_Type_contiguous(2, MPI_INT64_T, &(self->pair_type));
+        MPI_Type_commit(&(self->pair_type));
+        return 0;
+}
+
+int record_layout_destroy(struct record_layout *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Type_free(&(self->pair_type));
+        MPI_Type_free(&(self->payload_type));
+        MPI_Type_free(&(self->datatype));
+        self->payload = 0U;
+        self->size = 0U;
+        return 0;
+}
+
+/* The key of 'record', which may not be aligned for an 'int64_t'. */
+int64_t record_key(const unsigned char *record)
+{
+        int64_t key = 0;
+
+        memcpy(&key, record, sizeof(int64_t));
+        return key;
+}
+
+const char *record_strategy_name(const enum record_strategy strategy)
+{
+        if (RECORD_STRATEGY_COUNT <= strategy) {
+                return "unknown";
+        }
+        return RECORD_STRATEGY_NAME[strategy];
+}
+
+/*
+ * Sorts the 'size' records of 'layout' in 'block' of every process of
+ * 'comm' together by their keys, moving their payloads as 'strategy'
+ * tells, and describes the part of the result of this process in 'out';
+ * every buffer comes from 'arena'.  Collective over 'comm'.
+ *
+ * NOTE:
+ * 'RECORD_CARRY' sorts 'block' in place, while 'RECORD_PERMUTE' leaves it
+ * as it is since the payloads are fetched from there at the end.  Records
+ * of equal keys may end up in any order with the former, but keep the
+ * order of their origins with the latter (see 'record_pair_sort').
+ */
+int record_sort(struct record_sorted *out,
+                MPI_Comm comm,
+                const struct record_layout *layout,
+                const enum record_strategy strategy,
+                unsigned char *block,
+                const int size,
+                struct arena *arena)
+{
+        int id = 0;
+        int64_t origin = 0;
+        unsigned char *pair = NULL;
+        struct record_sorted sorted = { NULL, 0, 0.0 };
+
+        if (NULL == out || MPI_COMM_NULL == comm || NULL == layout ||
+            RECORD_STRATEGY_COUNT <= strategy || NULL == block ||
+            0 > size || NULL == arena) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        memset(out, 0, sizeof(struct record_sorted));
+
+        if (RECORD_CARRY == strategy) {
+                return record_psrs_(out,
+                                    comm,
+                                    layout->size,
+                                    layout->datatype,
+                                    record_compare_,
+                                    block,
+                                    size,
+                                    arena);
+        }
+
+        MPI_Comm_rank(comm, &id);
+        if (0 > arena_alloc(arena, (void **)&pair, RECORD_PAIR_SIZE * size)) {
+                return -1;
+        }
+
+        /* The origin is the rank in its upper half, the index in the lower. */
+        for (int i = 0; i < size; ++i) {
+                origin = (int64_t)id * ((int64_t)1 << 32) + i;
+                memcpy(pair + RECORD_PAIR_SIZE * i,
+                       block + layout->size * i,
+                       sizeof(int64_t));
+                memcpy(pair + RECORD_PAIR_SIZE * i + sizeof(int64_t),
+                       &origin,
+                       sizeof(int64_t));
+        }
+
+        if (0 > record_pair_sort(&sorted, comm, layout, pair, size, arena)) {
+                return -1;
+        }
+        return record_fetch_(out, comm, layout, &sorted, block, arena);
+}
+
+/*
+ * Sorts the 'size' (key, origin) pairs in 'pair' of every process of
+ * 'comm' together by their keys, stably: pairs of equal keys come out in
+ * the order of their origins, which must all differ and must grow with the
+ * rank of the process a pair is on.  The pairs of 'layout' have a key
+ * followed by an 'int64_t' origin, and every buffer comes from 'arena';
+ * collective over 'comm'.
+ *
+ * NOTE:
+ * The pairs are sorted by their keys and then their origins throughout,
+ * pivots included, so equal keys split between partitions only along
+ * their origins; within a partition they arrive in the order of the ranks
+ * they come from, and the merge takes from the earlier one on a tie.
+ */
+int record_pair_sort(struct record_sorted *out,
+                     MPI_Comm comm,
+                     const struct record_layout *layout,
+                     unsigned char *pair,
+                     const int size,
+                     struct arena *arena)
+{
+        if (NULL == out || MPI_COMM_NULL == comm || NULL == layout ||
+            (NULL == pair && 0 < size) || 0 > size || NULL == arena) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        memset(out, 0, sizeof(struct record_sorted));
+        return record_psrs_(out,
+                            comm,
+                            RECORD_PAIR_SIZE,
+                            layout->pair_type,
+                            record_origin_compare_,
+                            pair,
+                            size,
+                            arena);
+}
+
+/* Compares 2 records (or pairs) by their keys, as for 'qsort'. */
+static int record_compare_(const void *left, const void *right)
+{
+        const int64_t left_key = record_key(left);
+        const int64_t right_key = record_key(right);
+
+        return (left_key > right_key) - (left_key < right_key);
+}
+
+/* Compares 2 pairs by their keys and then their origins, as for 'qsort'. */
+static int record_origin_compare_(const void *left, const void *right)
+{
+        const unsigned char *const left_pair = left;
+        const unsigned char *const right_pair = right;
+        const int retval = record_compare_(left, right);
+        int64_t left_origin = 0;
+        int64_t right_origin = 0;
+
+        if (0 != retval) {
+                return retval;
+        }
+        memcpy(&left_origin, left_pair + sizeof(int64_t), sizeof(int64_t));
+        memcpy(&right_origin, right_pair + sizeof(int64_t), sizeof(int64_t));
+        return (left_origin > right_origin) - (left_origin < right_origin);
+}
+
+/*
+ * Sorts the 'size' records of 'item' bytes in 'block' across 'comm' by
+ * 'key_sort', with 'compare' as the order; the records are exchanged as
+ * 'datatype', whose extent must be 'item'.
+ */
+static int record_psrs_(struct record_sorted *out,
+                        MPI_Comm comm,
+                        const size_t item,
+                        MPI_Datatype datatype,
+                        int (*compare)(const void *, const void *),
+                        unsigned char *block,
+                        const int size,
+                        struct arena *arena)
+{
+        const struct key_kernel kernel = {
+                .name    = "record",
+                .size    = item,
+                .compare = compare
+        };
+        struct key_sorted sorted = { NULL, 0, 0.0 };
+
+        if (0 > key_sort(&sorted, comm, &kernel, datatype,
+                         block, size, arena)) {
+                return -1;
+        }
+        out->head = sorted.head;
+        out->size = sorted.size;
+        out->sent += sorted.sent;
+        return 0;
+}
+
+/*
+ * Asks the process each of the sorted 'pairs' comes from for its payload,
+ * and puts together the records of 'layout' they belong to in 'out', in
+ * the order of the pairs; 'block' holds the records of this process as
+ * they were before the sort.
+ *
+ * NOTE:
+ * The requests are grouped by the process they go to, so the payloads
+ * come back grouped likewise; 'slot' remembers where each one lands.
+ */
+static int record_fetch_(struct record_sorted *out,
+                         MPI_Comm comm,
+                         const struct record_layout *layout,
+                         const struct record_sorted *pairs,
+                         const unsigned char *block,
+                         struct arena *arena)
+{
+        const size_t payload = layout->payload;
+        const int size = pairs->size;
+        int process = 0;
+        int id = 0;
+        int owner = 0;
+        int asked = 0;
+        int64_t origin = 0;
+        int *count = NULL;
+        int *next = NULL;
+        int32_t *slot = NULL;
+        int32_t *request = NULL;
+        int32_t *ask = NULL;
+        unsigned char *reply = NULL;
+        unsigned char *fetched = NULL;
+        unsigned char *record = NULL;
+
+        MPI_Comm_size(comm, &process);
+        MPI_Comm_rank(comm, &id);
+
+        /*
+         * 'count' holds the number of requests sent to and received from
+         * each process followed by where they go in either buffer, just as
+         * in 'key_sort'; 'next' is where the next request to each one
+         * goes.
+         */
+        if (0 > arena_alloc(arena,
+                            (void **)&count,
+                            5U * sizeof(int) * process) ||
+            0 > arena_alloc(arena,
+                            (void **)&slot,
+                            sizeof(int32_t) * size) ||
+            0 > arena_alloc(arena,
+                            (void **)&request,
+                            sizeof(int32_t) * size) ||
+            0 > arena_alloc(arena,
+                            (void **)&fetched,
+                            payload * size) ||
+            0 > arena_alloc(arena,
+                            (void **)&(out->head),
+                            layout->size * size)) {
+                return -1;
+        }
+        next = count + 4 * process;
+        memset(count, 0, sizeof(int) * process);
+
+        for (int j = 0; j < size; ++j) {
+                memcpy(&origin,
+                       pairs->head + RECORD_PAIR_SIZE * j + sizeof(int64_t),
+                       sizeof(int64_t));
+                ++count[(int)(origin / ((int64_t)1 << 32))];
+        }
+        for (int i = 0, displ = 0; i < process; ++i) {
+                count[2 * process + i] = displ;
+                next[i] = displ;
+                displ += count[i];
+        }
+        for (int j = 0; j < size; ++j) {
+                memcpy(&origin,
+                       pairs->head + RECORD_PAIR_SIZE * j + sizeof(int64_t),
+                       sizeof(int64_t));
+                owner = (int)(origin / ((int64_t)1 << 32));
+                slot[j] = next[owner]++;
+                request[slot[j]] = (int32_t)(origin % ((int64_t)1 << 32));
+        }
+
+        MPI_Alltoall(count, 1, MPI_INT,
+                     count + process, 1, MPI_INT,
+                     comm);
+        for (int i = 0; i < process; ++i) {
+                count[3 * process + i] = asked;
+                asked += count[process + i];
+        }
+
+        if (0 > arena_alloc(arena,
+                            (void **)&ask,
+                            sizeof(int32_t) * asked) ||
+            0 > arena_alloc(arena, (void **)&reply, payload * asked)) {
+                return -1;
+        }
+        MPI_Alltoallv(request, count, count + 2 * process, MPI_INT32_T,
+                      ask, count + process, count + 3 * process, MPI_INT32_T,
+                      comm);
+
+        for (int a = 0; a < asked; ++a) {
+                memcpy(reply + payload * a,
+                       block + layout->size * ask[a] + sizeof(int64_t),
+                       payload);
+        }
+        MPI_Alltoallv(reply,
+                      count + process,
+                      count + 3 * process,
+                      layout->payload_type,
+                      fetched,
+                      count,
+                      count + 2 * process,
+                      layout->payload_type,
+                      comm);
+
+        for (int j = 0; j < size; ++j) {
+                record = out->head + layout->size * j;
+                memcpy(record,
+                       pairs->head + RECORD_PAIR_SIZE * j,
+                       sizeof(int64_t));
+                memcpy(record + sizeof(int64_t),
+                       fetched + payload * slot[j],
+                       payload);
+        }
+
+        out->size = size;
+        out->sent = pairs->sent +
+                    (double)(size - count[id]) * sizeof(int32_t) +
+                    (double)(asked - count[process + id]) * payload;
+        return 0;
+}
@@ -0,0 +1,1547 @@
+#include "psrs/macro.h"
+#define REPORT_ONLY
+#include "psrs/report.h"
+#undef REPORT_ONLY
+
+#include "psrs/generator.h"
+#include "psrs/key.h"
+#include "psrs/record.h"
+
+#include <errno.h>
+#include <math.h>    /* isfinite() */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Build configuration recorded by CMake; see 'src/CMakeLists.txt'.
+ */
+#ifndef PSRS_BUILD_TYPE
+#define PSRS_BUILD_TYPE "unknown"
+#endif
+
+#ifndef PSRS_C_FLAGS
+#define PSRS_C_FLAGS "unknown"
+#endif
+
+#if defined(__clang__)
+#define PSRS_COMPILER "Clang " __clang_version__
+#elif defined(__GNUC__)
+#define PSRS_COMPILER "GCC " __VERSION__
+#elif defined(__VERSION__)
+#define PSRS_COMPILER __VERSION__
+#else
+#define PSRS_COMPILER "unknown"
+#endif
+
+/* Field names used by both the JSON and the CSV output. */
+static const char *const STAT_KEY[SORT_STAT_SIZE] = {
+        [MEAN]      = "mean",
+        [STDEV]     = "stdev",
+        [MIN]       = "min",
+        [MAX]       = "max",
+        [MEDIAN]    = "median",
+        [P90]       = "p90",
+        [P99]       = "p99",
+        [CI95_LOW]  = "ci95_low",
+        [CI95_HIGH] = "ci95_high"
+};
+
+static const char *const RANK_STAT_KEY[RANK_STAT_SIZE] = {
+        [RANK_MIN] = "min",
+        [RANK_AVG] = "avg",
+        [RANK_MAX] = "max"
+};
+
+static const char *const PHASE_KEY[PHASE_COUNT] = {
+        [PHASE1] = "phase1",
+        [PHASE2] = "phase2",
+        [PHASE3] = "phase3",
+        [PHASE4] = "phase4"
+};
+
+static const char *const SUBPHASE_KEY[SUBPHASE_COUNT] = {
+        [SUB_SCATTER]       = "scatter",
+        [SUB_LOCAL_SORT]    = "local_sort",
+        [SUB_SAMPLING]      = "sampling",
+        [SUB_GATHER]        = "sample_gather",
+        [SUB_PIVOT]         = "pivot_selection",
+        [SUB_PARTITION]     = "partition_forming",
+        [SUB_EXCHANGE]      = "exchange",
+        [SUB_MERGE]         = "merge",
+        [SUB_RESULT_GATHER] = "result_gather"
+};
+
+static const char *const COUNTER_KEY[COUNTER_COUNT] = {
+        [COUNTER_CYCLES]        = "cycles",
+        [COUNTER_INSTRUCTIONS]  = "instructions",
+        [COUNTER_BRANCH_MISSES] = "branch_misses",
+        [COUNTER_LLC_MISSES]    = "llc_misses",
+        [COUNTER_DTLB_MISSES]   = "dtlb_misses"
+};
+
+static const char *const MEMORY_KEY[MEMORY_STAT_SIZE] = {
+        [MEMORY_ALLOCATED]   = "allocated",
+        [MEMORY_ALLOCATIONS] = "allocations",
+        [MEMORY_LIVE]        = "live",
+        [MEMORY_RESERVED]    = "reserved",
+        [MEMORY_RSS]         = "rss",
+        [MEMORY_PEAK_RSS]    = "peak_rss"
+};
+
+static const char *const COMM_KEY[COMM_FUNC_COUNT] = {
+        [COMM_SEND]     = "MPI_Send",
+        [COMM_SSEND]    = "MPI_Ssend",
+        [COMM_RECV]     = "MPI_Recv",
+        [COMM_BARRIER]  = "MPI_Barrier",
+        [COMM_BCAST]    = "MPI_Bcast",
+        [COMM_SCATTER]  = "MPI_Scatter",
+        [COMM_GATHER]   = "MPI_Gather",
+        [COMM_GATHERV]  = "MPI_Gatherv",
+        [COMM_ALLTOALL] = "MPI_Alltoall",
+        [COMM_REDUCE]   = "MPI_Reduce"
+};
+
+static const char *const COMM_STAT_KEY[COMM_STAT_SIZE] = {
+        [COMM_CALLS]          = "calls",
+        [COMM_BYTES_SENT]     = "bytes_sent",
+        [COMM_BYTES_RECEIVED] = "bytes_received",
+        [COMM_TIME]           = "time"
+};
+
+static const char *const SERVE_KEY[SERVE_TIME_COUNT] = {
+        [SERVE_WAIT]    = "wait",
+        [SERVE_SETUP]   = "setup",
+        [SERVE_SORT]    = "sort",
+        [SERVE_LATENCY] = "latency"
+};
+
+static const char *const PIPELINE_KEY[PIPELINE_MODE_COUNT] = {
+        [PIPELINE_SERIAL]  = "serial",
+        [PIPELINE_OVERLAP] = "pipelined"
+};
+
+static const char *const FORMAT_KEY[] = {
+        [FORMAT_TEXT] = "text",
+        [FORMAT_JSON] = "json",
+        [FORMAT_CSV]  = "csv"
+};
+
+static const char *const CACHE_KEY[] = {
+        [false] = "warm",
+        [true]  = "cold"
+};
+
+/*
+ * Collective over 'comm': every process contributes its host name and CPU
+ * affinity, while
+ * the rest of the description is only filled in on rank 0.
+ */
+int report_meta_init(struct report_meta *self, MPI_Comm comm)
+{
+        int rank = 0;
+        int length = 0;
+        char host[MPI_MAX_PROCESSOR_NAME];
+        char affinity[AFFINITY_SIZE];
+        bool seen = false;
+
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        memset(self, 0, sizeof(struct report_meta));
+        memset(host, 0, sizeof host);
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &(self->process));
+        MPI_Get_processor_name(host, &length);
+        /* Reported as "n/a" where the affinity can not be read. */
+        affinity_get(affinity, sizeof affinity);
+
+        if (0 == rank) {
+                self->host = malloc(self->process * sizeof(*self->host));
+                self->affinity = malloc(self->process *
+                                        sizeof(*self->affinity));
+                if (NULL == self->host || NULL == self->affinity) {
+                        free(self->host);
+                        free(self->affinity);
+                        return -1;
+                }
+        }
+
+        MPI_Gather(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                   self->host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                   0, comm);
+        MPI_Gather(affinity, AFFINITY_SIZE, MPI_CHAR,
+                   self->affinity, AFFINITY_SIZE, MPI_CHAR,
+                   0, comm);
+
+        if (0 != rank) {
+                return 0;
+        }
+
+        /* O(p^2), which is negligible next to the sort itself. */
+        for (int i = 0; i < self->process; ++i) {
+                seen = false;
+                for (int j = 0; j < i && !seen; ++j) {
+                        seen = !strcmp(self->host[i], self->host[j]);
+                }
+                self->node += !seen;
+        }
+
+        report_cpu_read_(self->cpu, sizeof self->cpu);
+        MPI_Get_library_version(self->mpi, &length);
+        /* Some libraries end the string with a line feed. */
+        self->mpi[strcspn(self->mpi, "\n")] = '\0';
+        return 0;
+}
+
+int report_meta_destroy(struct report_meta *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        free(self->host);
+        free(self->affinity);
+        self->host = NULL;
+        self->affinity = NULL;
+        return 0;
+}
+
+/*
+ * Writes 'result' as a single JSON object; every duration is in seconds,
+ * and imbalance is the ratio of the maximum to the average across
+ * processes (1 means perfectly balanced).
+ */
+int report_json_write(FILE *stream,
+                      const struct sort_result *result,
+                      const struct cli_arg *arg,
+                      const struct report_meta *meta)
+{
+        const bool parallel = 1 < arg->process;
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        json_header_write_(stream, arg, meta);
+
+        /* How the runs are measured, and how many of them are dropped. */
+        fprintf(stream,
+                "  \"methodology\": {\"warmup\": %u, \"cache\": \"%s\", "
+                "\"pinning\": %s, \"persistent\": %s, "
+                "\"outlier_rejection\": %s, ",
+                arg->warmup, CACHE_KEY[arg->cold != 0U],
+                arg->pin ? "true" : "false",
+                arg->persistent ? "true" : "false",
+                arg->outlier ? "\"mad\"" : "null");
+        fprintf(stream, "\"mad_limit\": %g, ", OUTLIER_LIMIT);
+        if (0UL != arg->mem_limit) {
+                fprintf(stream,
+                        "\"mem_limit\": %lu, \"mem_bound\": %.0f, ",
+                        arg->mem_limit, result->mem_bound);
+        } else {
+                fputs("\"mem_limit\": null, \"mem_bound\": null, ", stream);
+        }
+        fputs("\"rejected\": {", stream);
+        if (parallel) {
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        fprintf(stream, "\"%s\": %u, ",
+                                PHASE_KEY[i], result->rejected[i]);
+                }
+        }
+        fprintf(stream, "\"total\": %u}, \"affinity\": [",
+                result->rejected[PHASE_COUNT]);
+        for (int i = 0; i < meta->process; ++i) {
+                fputs(i ? ", " : "", stream);
+                json_string_write_(stream, meta->affinity[i]);
+        }
+        fputs("]},\n", stream);
+
+        fputs("  \"total\": ", stream);
+        json_stats_write_(stream, result->total);
+        fputs(",\n", stream);
+
+        if (parallel) {
+                fputs("  \"phases\": {", stream);
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        fprintf(stream, "%s\n    \"%s\": ",
+                                i ? "," : "", PHASE_KEY[i]);
+                        json_stats_write_(stream, result->phase[i]);
+                }
+                fputs("\n  },\n", stream);
+
+                fputs("  \"subphases\": {", stream);
+                for (int i = SUB_SCATTER; i < SUBPHASE_COUNT; ++i) {
+                        fprintf(stream, "%s\n    \"%s\": {",
+                                i ? "," : "", SUBPHASE_KEY[i]);
+                        for (int j = RANK_MIN; j < RANK_STAT_SIZE; ++j) {
+                                fprintf(stream, "\"%s\": %.9g, ",
+                                        RANK_STAT_KEY[j],
+                                        result->subphase[i][j]);
+                        }
+                        fprintf(stream, "\"imbalance\": %.9g}",
+                                0 < result->subphase[i][RANK_AVG] ?
+                                result->subphase[i][RANK_MAX] /
+                                result->subphase[i][RANK_AVG] : 1.0);
+                }
+                fputs("\n  },\n", stream);
+
+                fputs("  \"load\": {", stream);
+                for (int j = RANK_MIN; j < RANK_STAT_SIZE; ++j) {
+                        fprintf(stream, "\"%s\": %.9g, ",
+                                RANK_STAT_KEY[j], result->load[j]);
+                }
+                fprintf(stream, "\"imbalance\": %.9g},\n",
+                        0 < result->load[RANK_AVG] ?
+                        result->load[RANK_MAX] / result->load[RANK_AVG] :
+                        1.0);
+        }
+
+        if (parallel && arg->counter) {
+                fputs("  \"counters\": {", stream);
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        fprintf(stream, "%s\n    \"%s\": {",
+                                i ? "," : "", PHASE_KEY[i]);
+                        for (int j = COUNTER_CYCLES; j < COUNTER_COUNT; ++j) {
+                                fprintf(stream, "%s\"%s\": ",
+                                        j ? ", " : "", COUNTER_KEY[j]);
+                                /* Unavailable counters are 'null'. */
+                                if (!(result->counter_available & 1U << j)) {
+                                        fputs("null", stream);
+                                        continue;
+                                }
+                                fprintf(stream,
+                                        "{\"min\": %.0f, \"avg\": %.0f, "
+                                        "\"max\": %.0f}",
+                                        result->counter[i][j][RANK_MIN],
+                                        result->counter[i][j][RANK_AVG],
+                                        result->counter[i][j][RANK_MAX]);
+                        }
+                        fputs("}", stream);
+                }
+                fputs("\n  },\n", stream);
+        }
+
+        /* Sizes are in bytes. */
+        if (parallel && arg->memory) {
+                fputs("  \"memory\": {", stream);
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        fprintf(stream, "%s\n    \"%s\": {",
+                                i ? "," : "", PHASE_KEY[i]);
+                        for (int j = MEMORY_ALLOCATED;
+                             j < MEMORY_STAT_SIZE;
+                             ++j) {
+                                fprintf(stream,
+                                        "%s\"%s\": {\"min\": %.0f, "
+                                        "\"avg\": %.0f, \"max\": %.0f}",
+                                        j ? ", " : "", MEMORY_KEY[j],
+                                        result->memory[i][j][RANK_MIN],
+                                        result->memory[i][j][RANK_AVG],
+                                        result->memory[i][j][RANK_MAX]);
+                        }
+                        fputs("}", stream);
+                }
+                fputs("\n  },\n", stream);
+        }
+
+        /* Functions no process calls within a phase are left out. */
+        if (parallel && arg->comm) {
+                fputs("  \"communication\": {", stream);
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        fprintf(stream, "%s\n    \"%s\": {",
+                                i ? "," : "", PHASE_KEY[i]);
+                        fprintf(stream,
+                                "\n      \"mpi_share\": {\"min\": %.9g, "
+                                "\"avg\": %.9g, \"max\": %.9g}",
+                                result->comm_share[i][RANK_MIN],
+                                result->comm_share[i][RANK_AVG],
+                                result->comm_share[i][RANK_MAX]);
+                        for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                                const double (*stat)[RANK_STAT_SIZE] =
+                                        result->comm[i][j];
+
+                                if (0 >= stat[COMM_CALLS][RANK_MAX]) {
+                                        continue;
+                                }
+                                fprintf(stream, ",\n      \"%s\": {",
+                                        COMM_KEY[j]);
+                                for (int s = COMM_CALLS;
+                                     s < COMM_STAT_SIZE;
+                                     ++s) {
+                                        fprintf(stream,
+                                                "%s\"%s\": {\"min\": %.9g, "
+                                                "\"avg\": %.9g, "
+                                                "\"max\": %.9g}",
+                                                s ? ", " : "",
+                                                COMM_STAT_KEY[s],
+                                                stat[s][RANK_MIN],
+                                                stat[s][RANK_AVG],
+                                                stat[s][RANK_MAX]);
+                                }
+                                fputs("}", stream);
+                        }
+                        fputs("}", stream);
+                }
+                fputs("\n  },\n", stream);
+        }
+
+        fputs("  \"samples\": [", stream);
+        for (unsigned int i = 0U; i < result->sample_count; ++i) {
+                fprintf(stream, "%s\n    {", i ? "," : "");
+                if (parallel) {
+                        for (int j = PHASE1; j < PHASE_COUNT; ++j) {
+                                fprintf(stream, "\"%s\": %.9g, ",
+                                        PHASE_KEY[j], result->sample[i][j]);
+                        }
+                }
+                fprintf(stream, "\"total\": %.9g}",
+                        result->sample[i][PHASE_COUNT]);
+        }
+        fputs("\n  ]\n}\n", stream);
+        return 0;
+}
+
+/*
+ * Writes 'result' in a "long" CSV layout with a fixed header, one value per
+ * line, so new fields never shift existing columns:
+ *
+ * section,name,field,value
+ */
+int report_csv_write(FILE *stream,
+                     const struct sort_result *result,
+                     const struct cli_arg *arg,
+                     const struct report_meta *meta)
+{
+        const bool parallel = 1 < arg->process;
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        csv_header_write_(stream, arg, meta);
+
+        fprintf(stream, "methodology,warmup,,%u\n", arg->warmup);
+        fprintf(stream, "methodology,cache,,%s\n",
+                CACHE_KEY[arg->cold != 0U]);
+        fprintf(stream, "methodology,pinning,,%u\n", arg->pin);
+        fprintf(stream, "methodology,persistent,,%u\n", arg->persistent);
+        fprintf(stream, "methodology,outlier_rejection,,%s\n",
+                arg->outlier ? "mad" : "none");
+        fprintf(stream, "methodology,mad_limit,,%g\n", OUTLIER_LIMIT);
+        fprintf(stream, "methodology,mem_limit,,%lu\n", arg->mem_limit);
+        fprintf(stream, "methodology,mem_bound,,%.0f\n", result->mem_bound);
+        if (parallel) {
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        fprintf(stream, "methodology,rejected,%s,%u\n",
+                                PHASE_KEY[i], result->rejected[i]);
+                }
+        }
+        fprintf(stream, "methodology,rejected,total,%u\n",
+                result->rejected[PHASE_COUNT]);
+        for (int i = 0; i < meta->process; ++i) {
+                fprintf(stream, "methodology,affinity,%d,", i);
+                csv_string_write_(stream, meta->affinity[i]);
+                fputs("\n", stream);
+        }
+
+        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                fprintf(stream, "total,total,%s,%.9g\n",
+                        STAT_KEY[j], result->total[j]);
+        }
+
+        if (parallel) {
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, "phase,%s,%s,%.9g\n",
+                                        PHASE_KEY[i], STAT_KEY[j],
+                                        result->phase[i][j]);
+                        }
+                }
+                for (int i = SUB_SCATTER; i < SUBPHASE_COUNT; ++i) {
+                        for (int j = RANK_MIN; j < RANK_STAT_SIZE; ++j) {
+                                fprintf(stream, "subphase,%s,%s,%.9g\n",
+                                        SUBPHASE_KEY[i], RANK_STAT_KEY[j],
+                                        result->subphase[i][j]);
+                        }
+                        fprintf(stream, "subphase,%s,imbalance,%.9g\n",
+                                SUBPHASE_KEY[i],
+                                0 < result->subphase[i][RANK_AVG] ?
+                                result->subphase[i][RANK_MAX] /
+                                result->subphase[i][RANK_AVG] : 1.0);
+                }
+                for (int j = RANK_MIN; j < RANK_STAT_SIZE; ++j) {
+                        fprintf(stream, "load,elements,%s,%.9g\n",
+                                RANK_STAT_KEY[j], result->load[j]);
+                }
+                fprintf(stream, "load,elements,imbalance,%.9g\n",
+                        0 < result->load[RANK_AVG] ?
+                        result->load[RANK_MAX] / result->load[RANK_AVG] :
+                        1.0);
+        }
+
+        /* Unavailable counters are left out altogether. */
+        if (parallel && arg->counter) {
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int j = COUNTER_CYCLES; j < COUNTER_COUNT; ++j) {
+                                if (!(result->counter_available & 1U << j)) {
+                                        continue;
+                                }
+                                for (int k = RANK_MIN;
+                                     k < RANK_STAT_SIZE;
+                                     ++k) {
+                                        fprintf(stream,
+                                                "counter,%s.%s,%s,%.0f\n",
+                                                PHASE_KEY[i], COUNTER_KEY[j],
+                                                RANK_STAT_KEY[k],
+                                                result->counter[i][j][k]);
+                                }
+                        }
+                }
+        }
+
+        if (parallel && arg->memory) {
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int j = MEMORY_ALLOCATED;
+                             j < MEMORY_STAT_SIZE;
+                             ++j) {
+                                for (int k = RANK_MIN;
+                                     k < RANK_STAT_SIZE;
+                                     ++k) {
+                                        fprintf(stream,
+                                                "memory,%s.%s,%s,%.0f\n",
+                                                PHASE_KEY[i], MEMORY_KEY[j],
+                                                RANK_STAT_KEY[k],
+                                                result->memory[i][j][k]);
+                                }
+                        }
+                }
+        }
+
+        if (parallel && arg->comm) {
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                                fprintf(stream, "comm,%s,mpi_share.%s,%.9g\n",
+                                        PHASE_KEY[i],
+                                        RANK_STAT_KEY[k],
+                                        result->comm_share[i][k]);
+                        }
+                        for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                                const double (*stat)[RANK_STAT_SIZE] =
+                                        result->comm[i][j];
+
+                                if (0 >= stat[COMM_CALLS][RANK_MAX]) {
+                                        continue;
+                                }
+                                for (int s = COMM_CALLS;
+                                     s < COMM_STAT_SIZE;
+                                     ++s) {
+                                        for (int k = RANK_MIN;
+                                             k < RANK_STAT_SIZE;
+                                             ++k) {
+                                                fprintf(stream,
+                                                        "comm,%s.%s,%s.%s,"
+                                                        "%.9g\n",
+                                                        PHASE_KEY[i],
+                                                        COMM_KEY[j],
+                                                        COMM_STAT_KEY[s],
+                                                        RANK_STAT_KEY[k],
+                                                        stat[s][k]);
+                                        }
+                                }
+                        }
+                }
+        }
+
+        for (unsigned int i = 0U; i < result->sample_count; ++i) {
+                if (parallel) {
+                        for (int j = PHASE1; j < PHASE_COUNT; ++j) {
+                                fprintf(stream, "sample,%u,%s,%.9g\n",
+                                        i, PHASE_KEY[j],
+                                        result->sample[i][j]);
+                        }
+                }
+                fprintf(stream, "sample,%u,total,%.9g\n",
+                        i, result->sample[i][PHASE_COUNT]);
+        }
+        return 0;
+}
+
+/*
+ * Writes whatever precedes the first case of a sweep: a header line for
+ * the text and CSV formats, or the opening of the enclosing object for JSON.
+ */
+int report_sweep_begin(FILE *stream, const struct cli_arg *arg)
+{
+        if (NULL == stream || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                fprintf(stream,
+                        "{\n\"schema\": %d,\n\"sweep\": [\n",
+                        REPORT_SCHEMA);
+                break;
+        case FORMAT_CSV:
+                fputs("case,section,name,field,value\n", stream);
+                break;
+        default:
+                /* Same columns as the text output of a single case. */
+                fputs("Processes, Length, Distribution, Mean, "
+                      "Standard Deviation, Min, Max, Median, P90, P99, "
+                      "CI95 Low, CI95 High\n",
+                      stream);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the 'id'-th case of a sweep (counting from 0): a full record as
+ * written by 'report_json_write' for JSON, the rows of 'report_csv_write'
+ * with 'id' prepended as the "case" column for CSV, or a single row of the
+ * total sorting time for the text format.
+ */
+int report_sweep_write(FILE *stream,
+                       const unsigned int id,
+                       const struct sort_result *result,
+                       const struct cli_arg *arg,
+                       const struct report_meta *meta)
+{
+        char *buffer = NULL;
+        char *line = NULL;
+        char *save = NULL;
+        size_t size = 0U;
+        FILE *record = NULL;
+        int retval = 0;
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                fputs(0U == id ? "" : ",\n", stream);
+                return report_json_write(stream, result, arg, meta);
+        case FORMAT_CSV:
+                /*
+                 * NOTE:
+                 * The record is written into memory first so that the header
+                 * line can be dropped and every row prefixed.
+                 */
+                if (NULL == (record = open_memstream(&buffer, &size))) {
+                        return -1;
+                }
+                retval = report_csv_write(record, result, arg, meta);
+                if (0 != fclose(record) || 0 > retval) {
+                        free(buffer);
+                        return -1;
+                }
+                /* The 1st line is the header. */
+                strtok_r(buffer, "\n", &save);
+                while (NULL != (line = strtok_r(NULL, "\n", &save))) {
+                        fprintf(stream, "%u,%s\n", id, line);
+                }
+                free(buffer);
+                return 0;
+        default:
+                fprintf(stream,
+                        "%d, %d, %s",
+                        arg->process,
+                        arg->length,
+                        array_dist_name(arg->dist));
+                for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                        fprintf(stream, ", %f", result->total[j]);
+                }
+                fputs("\n", stream);
+                return 0;
+        }
+}
+
+/* Closes what 'report_sweep_begin' opens. */
+int report_sweep_end(FILE *stream, const struct cli_arg *arg)
+{
+        if (NULL == stream || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (FORMAT_JSON == arg->format) {
+                fputs("]\n}\n", stream);
+        }
+        return 0;
+}
+
+/*
+ * Writes the outcome of a batch of sorts by groups of processes: the
+ * statistics of a single sort of each group, and the throughput of all the
+ * groups together.
+ */
+int report_batch_write(FILE *stream,
+                       const struct batch_result *result,
+                       const struct cli_arg *arg,
+                       const struct report_meta *meta)
+{
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fprintf(stream,
+                        "  \"batch\": {\"groups\": %u, "
+                        "\"processes_per_group\": %d, \"sorts\": %u, "
+                        "\"seconds\": %.9g, \"sorts_per_second\": %.9g, "
+                        "\"group\": [",
+                        result->group, result->group_process, result->sorts,
+                        result->wall, result->throughput);
+                for (unsigned int i = 0U; i < result->group; ++i) {
+                        fprintf(stream, "%s\n    {\"rejected\": %u, "
+                                "\"time\": ",
+                                i ? "," : "", result->rejected[i]);
+                        json_stats_write_(stream, result->stats[i]);
+                        fputc('}', stream);
+                }
+                fputs("\n  ]}\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                fprintf(stream, "batch,total,groups,%u\n", result->group);
+                fprintf(stream, "batch,total,processes_per_group,%d\n",
+                        result->group_process);
+                fprintf(stream, "batch,total,sorts,%u\n", result->sorts);
+                fprintf(stream, "batch,total,seconds,%.9g\n", result->wall);
+                fprintf(stream, "batch,total,sorts_per_second,%.9g\n",
+                        result->throughput);
+                for (unsigned int i = 0U; i < result->group; ++i) {
+                        fprintf(stream, "batch,group%u,rejected,%u\n",
+                                i, result->rejected[i]);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, "batch,group%u,%s,%.9g\n",
+                                        i, STAT_KEY[j], result->stats[i][j]);
+                        }
+                }
+                break;
+        default:
+                fputs("Group, Processes, Mean, Standard Deviation, Min, Max, "
+                      "Median, P90, P99, CI95 Low, CI95 High\n",
+                      stream);
+                for (unsigned int i = 0U; i < result->group; ++i) {
+                        fprintf(stream, "%u, %d", i, result->group_process);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, ", %f", result->stats[i][j]);
+                        }
+                        fputc('\n', stream);
+                }
+                fputs("\nGroups, Sorts, Seconds, Sorts per Second\n", stream);
+                fprintf(stream, "%u, %u, %f, %f\n",
+                        result->group, result->sorts,
+                        result->wall, result->throughput);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the outcome of sorting the array as independent segments: the
+ * statistics of the time to sort all of them in a single pass and one
+ * after another, along with the segments per second of each (by the mean
+ * time) and how many times faster the single pass is.
+ */
+int report_segment_write(FILE *stream,
+                         const struct segment_result *result,
+                         const struct cli_arg *arg,
+                         const struct report_meta *meta)
+{
+        const char *const KEY[] = { "batched", "serial" };
+        const double *stats[2];
+        unsigned int rejected[2];
+        double speedup = 0;
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        stats[0] = result->batched;
+        stats[1] = result->serial;
+        rejected[0] = result->batched_rejected;
+        rejected[1] = result->serial_rejected;
+        speedup = result->serial[MEAN] / result->batched[MEAN];
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fprintf(stream,
+                        "  \"segments\": {\"count\": %u, "
+                        "\"length\": %d, \"speedup\": %.9g",
+                        result->segment, result->segment_length, speedup);
+                for (int i = 0; i < 2; ++i) {
+                        fprintf(stream,
+                                ",\n    \"%s\": {\"rejected\": %u, "
+                                "\"segments_per_second\": %.9g, "
+                                "\"time\": ",
+                                KEY[i], rejected[i],
+                                result->segment / stats[i][MEAN]);
+                        json_stats_write_(stream, stats[i]);
+                        fputc('}', stream);
+                }
+                fputs("\n  }\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                fprintf(stream, "segments,total,count,%u\n",
+                        result->segment);
+                fprintf(stream, "segments,total,length,%d\n",
+                        result->segment_length);
+                fprintf(stream, "segments,total,speedup,%.9g\n", speedup);
+                for (int i = 0; i < 2; ++i) {
+                        fprintf(stream, "segments,%s,rejected,%u\n",
+                                KEY[i], rejected[i]);
+                        fprintf(stream,
+                                "segments,%s,segments_per_second,%.9g\n",
+                                KEY[i], result->segment / stats[i][MEAN]);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, "segments,%s,%s,%.9g\n",
+                                        KEY[i], STAT_KEY[j], stats[i][j]);
+                        }
+                }
+                break;
+        default:
+                fputs("Way, Segments, Segment Length, Mean, Standard "
+                      "Deviation, Min, Max, Median, P90, P99, CI95 Low, "
+                      "CI95 High, Segments per Second\n",
+                      stream);
+                for (int i = 0; i < 2; ++i) {
+                        fprintf(stream, "%s, %u, %d",
+                                KEY[i], result->segment,
+                                result->segment_length);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, ", %f", stats[i][j]);
+                        }
+                        fprintf(stream, ", %f\n",
+                                result->segment / stats[i][MEAN]);
+                }
+                fprintf(stream, "\nSpeedup of Batched over Serial\n%f\n",
+                        speedup);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the outcome of running the same jobs back to back and pipelined:
+ * the jobs per second and the statistics of the latency of a job of each,
+ * and how many times more jobs per second the pipeline sustains.
+ */
+int report_pipeline_write(FILE *stream,
+                          const struct pipeline_result *result,
+                          const struct cli_arg *arg,
+                          const struct report_meta *meta)
+{
+        double speedup = 0;
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        speedup = result->throughput[PIPELINE_OVERLAP] /
+                  result->throughput[PIPELINE_SERIAL];
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fprintf(stream,
+                        "  \"pipeline\": {\"depth\": %u, \"jobs\": %u, "
+                        "\"speedup\": %.9g",
+                        result->depth, result->jobs, speedup);
+                for (int i = PIPELINE_SERIAL; i < PIPELINE_MODE_COUNT; ++i) {
+                        fprintf(stream,
+                                ",\n    \"%s\": {\"seconds\": %.9g, "
+                                "\"jobs_per_second\": %.9g, "
+                                "\"rejected\": %u, \"latency\": ",
+                                PIPELINE_KEY[i], result->wall[i],
+                                result->throughput[i], result->rejected[i]);
+                        json_stats_write_(stream, result->latency[i]);
+                        fputc('}', stream);
+                }
+                fputs("\n  }\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                fprintf(stream, "pipeline,total,depth,%u\n", result->depth);
+                fprintf(stream, "pipeline,total,jobs,%u\n", result->jobs);
+                fprintf(stream, "pipeline,total,speedup,%.9g\n", speedup);
+                for (int i = PIPELINE_SERIAL; i < PIPELINE_MODE_COUNT; ++i) {
+                        fprintf(stream, "pipeline,%s,seconds,%.9g\n",
+                                PIPELINE_KEY[i], result->wall[i]);
+                        fprintf(stream, "pipeline,%s,jobs_per_second,%.9g\n",
+                                PIPELINE_KEY[i], result->throughput[i]);
+                        fprintf(stream, "pipeline,%s,rejected,%u\n",
+                                PIPELINE_KEY[i], result->rejected[i]);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream,
+                                        "pipeline,%s,latency.%s,%.9g\n",
+                                        PIPELINE_KEY[i], STAT_KEY[j],
+                                        result->latency[i][j]);
+                        }
+                }
+                break;
+        default:
+                fputs("Mode, Depth, Jobs, Seconds, Jobs per Second, "
+                      "Latency Mean, Standard Deviation, Min, Max, Median, "
+                      "P90, P99, CI95 Low, CI95 High\n",
+                      stream);
+                for (int i = PIPELINE_SERIAL; i < PIPELINE_MODE_COUNT; ++i) {
+                        fprintf(stream, "%s, %u, %u, %f, %f",
+                                PIPELINE_KEY[i],
+                                PIPELINE_SERIAL == i ? 1U : result->depth,
+                                result->jobs, result->wall[i],
+                                result->throughput[i]);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, ", %f",
+                                        result->latency[i][j]);
+                        }
+                        fputc('\n', stream);
+                }
+                fprintf(stream, "\nSpeedup of Pipelined over Serial\n%f\n",
+                        speedup);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the outcome of sorting keys of a type other than 'long': the
+ * statistics of the time of a sort, the keys per second, and the bytes a
+ * process sends while exchanging partitions.
+ */
+int report_key_write(FILE *stream,
+                     const struct key_result *result,
+                     const struct cli_arg *arg,
+                     const struct report_meta *meta)
+{
+        const char *name = NULL;
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        name = key_type_name(result->type);
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fprintf(stream,
+                        "  \"key\": {\"type\": \"%s\", \"bytes\": %zu, "
+                        "\"keys_per_second\": %.9g, "
+                        "\"bytes_sent\": %.9g, \"bytes_sent_max\": %.9g, "
+                        "\"rejected\": %u, \"time\": ",
+                        name, result->size, result->throughput,
+                        result->sent, result->sent_max, result->rejected);
+                json_stats_write_(stream, result->time);
+                fputs("}\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                fprintf(stream, "key,%s,bytes,%zu\n", name, result->size);
+                fprintf(stream, "key,%s,keys_per_second,%.9g\n",
+                        name, result->throughput);
+                fprintf(stream, "key,%s,bytes_sent,%.9g\n",
+                        name, result->sent);
+                fprintf(stream, "key,%s,bytes_sent_max,%.9g\n",
+                        name, result->sent_max);
+                fprintf(stream, "key,%s,rejected,%u\n",
+                        name, result->rejected);
+                for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                        fprintf(stream, "key,%s,time.%s,%.9g\n",
+                                name, STAT_KEY[j], result->time[j]);
+                }
+                break;
+        default:
+                fputs("Type, Key Bytes, Keys per Second, Bytes Sent, "
+                      "Bytes Sent Max, Mean, Standard Deviation, Min, Max, "
+                      "Median, P90, P99, CI95 Low, CI95 High\n",
+                      stream);
+                fprintf(stream, "%s, %zu, %f, %.0f, %.0f",
+                        name, result->size, result->throughput,
+                        result->sent, result->sent_max);
+                for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                        fprintf(stream, ", %f", result->time[j]);
+                }
+                fputc('\n', stream);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the outcome of sorting records of every payload size by either
+ * strategy: the statistics of the time of a sort, the records per second,
+ * the bytes a process sends over all the exchanges of a sort, and how much
+ * faster fetching the payloads after the keys is than carrying them.
+ */
+int report_record_write(FILE *stream,
+                        const struct record_result *result,
+                        const struct cli_arg *arg,
+                        const struct report_meta *meta)
+{
+        double speedup[SWEEP_MAX];
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta ||
+            SWEEP_MAX < result->count) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (unsigned int i = 0U; i < result->count; ++i) {
+                speedup[i] = result->time[i][RECORD_CARRY][MEAN] /
+                             result->time[i][RECORD_PERMUTE][MEAN];
+        }
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fputs("  \"records\": [", stream);
+                for (unsigned int i = 0U; i < result->count; ++i) {
+                        fprintf(stream,
+                                "%s\n    {\"payload\": %d, \"bytes\": %zu, "
+                                "\"speedup\": %.9g",
+                                0U == i ? "" : ",",
+                                result->payload[i], result->size[i],
+                                speedup[i]);
+                        for (int s = RECORD_CARRY;
+                             s < RECORD_STRATEGY_COUNT;
+                             ++s) {
+                                fprintf(stream,
+                                        ",\n     \"%s\": "
+                                        "{\"records_per_second\": %.9g, "
+                                        "\"bytes_sent\": %.9g, "
+                                        "\"rejected\": %u, \"time\": ",
+                                        record_strategy_name(s),
+                                        result->throughput[i][s],
+                                        result->sent[i][s],
+                                        result->rejected[i][s]);
+                                json_stats_write_(stream, result->time[i][s]);
+                                fputc('}', stream);
+                        }
+                        fputc('}', stream);
+                }
+                fputs("\n  ]\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                for (unsigned int i = 0U; i < result->count; ++i) {
+                        fprintf(stream, "record,%d,bytes,%zu\n",
+                                result->payload[i], result->size[i]);
+                        fprintf(stream, "record,%d,speedup,%.9g\n",
+                                result->payload[i], speedup[i]);
+                        for (int s = RECORD_CARRY;
+                             s < RECORD_STRATEGY_COUNT;
+                             ++s) {
+                                fprintf(stream,
+                                        "record,%d,%s.records_per_second,"
+                                        "%.9g\n",
+                                        result->payload[i],
+                                        record_strategy_name(s),
+                                        result->throughput[i][s]);
+                                fprintf(stream,
+                                        "record,%d,%s.bytes_sent,%.9g\n",
+                                        result->payload[i],
+                                        record_strategy_name(s),
+                                        result->sent[i][s]);
+                                fprintf(stream,
+                                        "record,%d,%s.rejected,%u\n",
+                                        result->payload[i],
+                                        record_strategy_name(s),
+                                        result->rejected[i][s]);
+                                for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                        fprintf(stream,
+                                                "record,%d,%s.time.%s,%.9g\n",
+                                                result->payload[i],
+                                                record_strategy_name(s),
+                                                STAT_KEY[j],
+                                                result->time[i][s][j]);
+                                }
+                        }
+                }
+                break;
+        default:
+                fputs("Payload, Strategy, Record Bytes, Records per Second, "
+                      "Bytes Sent, Mean, Standard Deviation, Min, Max, "
+                      "Median, P90, P99, CI95 Low, CI95 High\n",
+                      stream);
+                for (unsigned int i = 0U; i < result->count; ++i) {
+                        for (int s = RECORD_CARRY;
+                             s < RECORD_STRATEGY_COUNT;
+                             ++s) {
+                                fprintf(stream, "%d, %s, %zu, %f, %.0f",
+                                        result->payload[i],
+                                        record_strategy_name(s),
+                                        result->size[i],
+                                        result->throughput[i][s],
+                                        result->sent[i][s]);
+                                for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                        fprintf(stream, ", %f",
+                                                result->time[i][s][j]);
+                                }
+                                fputc('\n', stream);
+                        }
+                }
+                fputs("\nPayload, Speedup of Permute over Carry\n", stream);
+                for (unsigned int i = 0U; i < result->count; ++i) {
+                        fprintf(stream, "%d, %f\n",
+                                result->payload[i], speedup[i]);
+                }
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the outcome of sorting the array unstably and stably along with
+ * the indices: the statistics of the time of a sort of each, the elements
+ * per second, and how many times longer the latter takes.
+ */
+int report_argsort_write(FILE *stream,
+                         const struct argsort_result *result,
+                         const struct cli_arg *arg,
+                         const struct report_meta *meta)
+{
+        const char *const KEY[ARGSORT_MODE_COUNT] = { "sort", "argsort" };
+
+        if (NULL == stream || NULL == result || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fprintf(stream, "  \"argsort\": {\"overhead\": %.9g",
+                        result->overhead);
+                for (int i = ARGSORT_SORT; i < ARGSORT_MODE_COUNT; ++i) {
+                        fprintf(stream,
+                                ",\n    \"%s\": {\"rejected\": %u, "
+                                "\"elements_per_second\": %.9g, "
+                                "\"time\": ",
+                                KEY[i], result->rejected[i],
+                                result->throughput[i]);
+                        json_stats_write_(stream, result->time[i]);
+                        fputc('}', stream);
+                }
+                fputs("\n  }\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                fprintf(stream, "argsort,total,overhead,%.9g\n",
+                        result->overhead);
+                for (int i = ARGSORT_SORT; i < ARGSORT_MODE_COUNT; ++i) {
+                        fprintf(stream, "argsort,%s,rejected,%u\n",
+                                KEY[i], result->rejected[i]);
+                        fprintf(stream,
+                                "argsort,%s,elements_per_second,%.9g\n",
+                                KEY[i], result->throughput[i]);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, "argsort,%s,%s,%.9g\n",
+                                        KEY[i], STAT_KEY[j],
+                                        result->time[i][j]);
+                        }
+                }
+                break;
+        default:
+                fputs("Way, Length, Mean, Standard Deviation, Min, Max, "
+                      "Median, P90, P99, CI95 Low, CI95 High, Elements per "
+                      "Second\n",
+                      stream);
+                for (int i = ARGSORT_SORT; i < ARGSORT_MODE_COUNT; ++i) {
+                        fprintf(stream, "%s, %d", KEY[i], arg->length);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, ", %f", result->time[i][j]);
+                        }
+                        fprintf(stream, ", %f\n", result->throughput[i]);
+                }
+                fprintf(stream, "\nOverhead of Argsort over Sort\n%f\n",
+                        result->overhead);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes whatever precedes the first job of a service: the header line of
+ * the records for the text and CSV formats, or the parameters and the
+ * opening of the records for JSON.
+ */
+int report_serve_begin(FILE *stream,
+                       const struct cli_arg *arg,
+                       const struct report_meta *meta)
+{
+        if (NULL == stream || NULL == arg || NULL == meta) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                json_header_write_(stream, arg, meta);
+                fputs("  \"jobs\": [", stream);
+                break;
+        case FORMAT_CSV:
+                csv_header_write_(stream, arg, meta);
+                break;
+        default:
+                fputs("Job, Length, Seed, Distribution, Queued, Wait, "
+                      "Setup, Sort, Latency\n",
+                      stream);
+                break;
+        }
+        return 0;
+}
+
+/* Writes the record of a single job as soon as it is served. */
+int report_serve_write(FILE *stream,
+                       const struct serve_record *record,
+                       const struct cli_arg *arg)
+{
+        double time[SERVE_TIME_COUNT];
+
+        if (NULL == stream || NULL == record || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        time[SERVE_WAIT] = record->wait;
+        time[SERVE_SETUP] = record->setup;
+        time[SERVE_SORT] = record->sort;
+        time[SERVE_LATENCY] = record->latency;
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                fprintf(stream,
+                        "%s\n    {\"id\": %u, \"length\": %d, "
+                        "\"seed\": %u, \"dist\": \"%s\", \"queued\": %u",
+                        0U == record->job.id ? "" : ",",
+                        record->job.id, record->job.length,
+                        record->job.seed,
+                        array_dist_name(record->job.dist), record->queued);
+                for (int i = SERVE_WAIT; i < SERVE_TIME_COUNT; ++i) {
+                        fprintf(stream, ", \"%s\": %.9g",
+                                SERVE_KEY[i], time[i]);
+                }
+                fputc('}', stream);
+                break;
+        case FORMAT_CSV:
+                fprintf(stream, "job,%u,length,%d\n",
+                        record->job.id, record->job.length);
+                fprintf(stream, "job,%u,seed,%u\n",
+                        record->job.id, record->job.seed);
+                fprintf(stream, "job,%u,dist,%s\n",
+                        record->job.id, array_dist_name(record->job.dist));
+                fprintf(stream, "job,%u,queued,%u\n",
+                        record->job.id, record->queued);
+                for (int i = SERVE_WAIT; i < SERVE_TIME_COUNT; ++i) {
+                        fprintf(stream, "job,%u,%s,%.9g\n",
+                                record->job.id, SERVE_KEY[i], time[i]);
+                }
+                break;
+        default:
+                fprintf(stream, "%u, %d, %u, %s, %u",
+                        record->job.id, record->job.length,
+                        record->job.seed,
+                        array_dist_name(record->job.dist), record->queued);
+                for (int i = SERVE_WAIT; i < SERVE_TIME_COUNT; ++i) {
+                        fprintf(stream, ", %f", time[i]);
+                }
+                fputc('\n', stream);
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Writes the summary of a service once it stops, and closes what
+ * 'report_serve_begin' opens; the statistics are left out if no job is
+ * measured.
+ */
+int report_serve_end(FILE *stream,
+                     const struct serve_result *result,
+                     const struct cli_arg *arg)
+{
+        bool measured = false;
+
+        if (NULL == stream || NULL == result || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        measured = 0U < result->measured;
+
+        switch (arg->format) {
+        case FORMAT_JSON:
+                fprintf(stream,
+                        "\n  ],\n  \"summary\": {\"jobs\": %u, "
+                        "\"measured\": %u, \"queued_max\": %u, "
+                        "\"busy_seconds\": %.9g, \"jobs_per_second\": ",
+                        result->jobs, result->measured, result->queued_max,
+                        result->busy);
+                if (measured) {
+                        fprintf(stream, "%.9g", result->throughput);
+                } else {
+                        fputs("null", stream);
+                }
+                for (int i = SERVE_WAIT; measured && i < SERVE_TIME_COUNT;
+                     ++i) {
+                        fprintf(stream, ", \"%s\": ", SERVE_KEY[i]);
+                        json_stats_write_(stream, result->time[i]);
+                }
+                fputs("}\n}\n", stream);
+                break;
+        case FORMAT_CSV:
+                fprintf(stream, "summary,total,jobs,%u\n", result->jobs);
+                fprintf(stream, "summary,total,measured,%u\n",
+                        result->measured);
+                fprintf(stream, "summary,total,queued_max,%u\n",
+                        result->queued_max);
+                fprintf(stream, "summary,total,busy_seconds,%.9g\n",
+                        result->busy);
+                if (!measured) {
+                        break;
+                }
+                fprintf(stream, "summary,total,jobs_per_second,%.9g\n",
+                        result->throughput);
+                for (int i = SERVE_WAIT; i < SERVE_TIME_COUNT; ++i) {
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, "summary,%s,%s,%.9g\n",
+                                        SERVE_KEY[i], STAT_KEY[j],
+                                        result->time[i][j]);
+                        }
+                }
+                break;
+        default:
+                fputs("\nJobs, Measured, Most Queued, Busy Seconds, "
+                      "Jobs per Second\n",
+                      stream);
+                fprintf(stream, "%u, %u, %u, %f, %f\n",
+                        result->jobs, result->measured, result->queued_max,
+                        result->busy, measured ? result->throughput : 0);
+                if (!measured) {
+                        break;
+                }
+                fputs("\nTime, Mean, Standard Deviation, Min, Max, Median, "
+                      "P90, P99, CI95 Low, CI95 High\n",
+                      stream);
+                for (int i = SERVE_WAIT; i < SERVE_TIME_COUNT; ++i) {
+                        fprintf(stream, "%s", SERVE_KEY[i]);
+                        for (int j = MEAN; j < SORT_STAT_SIZE; ++j) {
+                                fprintf(stream, ", %f", result->time[i][j]);
+                        }
+                        fputc('\n', stream);
+                }
+                break;
+        }
+        return 0;
+}
+
+/*
+ * Copies the "model name" entry of '/proc/cpuinfo' into 'cpu', which is
+ * left as "unknown" on systems without it.
+ */
+static void report_cpu_read_(char cpu[const], const size_t size)
+{
+        static const char KEY[] = "model name";
+        char line[512];
+        char *value = NULL;
+        FILE *cpuinfo = fopen("/proc/cpuinfo", "r");
+
+        snprintf(cpu, size, "%s", "unknown");
+
+        if (NULL == cpuinfo) {
+                return;
+        }
+
+        while (NULL != fgets(line, sizeof line, cpuinfo)) {
+                if (strncmp(line, KEY, sizeof KEY - 1U) ||
+                    NULL == (value = strchr(line, ':'))) {
+                        continue;
+                }
+                value += strspn(value + 1, " \t") + 1;
+                value[strcspn(value, "\n")] = '\0';
+                snprintf(cpu, size, "%s", value);
+                break;
+        }
+        fclose(cpuinfo);
+}
+
+static void json_string_write_(FILE *stream, const char *str)
+{
+        fputc('"', stream);
+        for (; '\0' != *str; ++str) {
+                if ('"' == *str || '\\' == *str) {
+                        fprintf(stream, "\\%c", *str);
+                } else if ((unsigned char)*str < 0x20) {
+                        fprintf(stream, "\\u%04x", (unsigned char)*str);
+                } else {
+                        fputc(*str, stream);
+                }
+        }
+        fputc('"', stream);
+}
+
+static void json_stats_write_(FILE *stream, const double stats[const])
+{
+        fputc('{', stream);
+        for (int i = MEAN; i < SORT_STAT_SIZE; ++i) {
+                fprintf(stream, "%s\"%s\": ", i ? ", " : "", STAT_KEY[i]);
+                /* JSON has no representation of NaN or infinity. */
+                if (isfinite(stats[i])) {
+                        fprintf(stream, "%.9g", stats[i]);
+                } else {
+                        fputs("null", stream);
+                }
+        }
+        fputc('}', stream);
+}
+
+/* Quotes 'str' as a single CSV field (RFC 4180). */
+static void csv_string_write_(FILE *stream, const char *str)
+{
+        fputc('"', stream);
+        for (; '\0' != *str; ++str) {
+                if ('"' == *str) {
+                        fputc('"', stream);
+                }
+                fputc(*str, stream);
+        }
+        fputc('"', stream);
+}
+
+/*
+ * Writes the opening of a JSON report up to the mode it is of: the schema,
+ * every parameter of the launch and the environment it runs in, which are
+ * the same whatever the mode.
+ */
+static void json_header_write_(FILE *stream,
+                               const struct cli_arg *arg,
+                               const struct report_meta *meta)
+{
+        fprintf(stream, "{\n  \"schema\": %d,\n", REPORT_SCHEMA);
+
+        fprintf(stream,
+                "  \"parameters\": {\"length\": %d, \"run\": %u, "
+                "\"warmup\": %u, \"seed\": %u, \"window\": %u, "
+                "\"dist\": \"%s\", \"phase\": %s, "
+                "\"barrier\": %s, \"counters\": %s, \"comm\": %s, "
+                "\"memory\": %s, \"mem_limit\": %lu, \"format\": \"%s\", "
+                "\"trace\": ",
+                arg->length, arg->run, arg->warmup, arg->seed, arg->window,
+                array_dist_name(arg->dist),
+                arg->phase ? "true" : "false",
+                arg->barrier ? "true" : "false",
+                arg->counter ? "true" : "false",
+                arg->comm ? "true" : "false",
+                arg->memory ? "true" : "false",
+                arg->mem_limit, FORMAT_KEY[arg->format]);
+        if (arg->trace) {
+                json_string_write_(stream, arg->trace_file);
+        } else {
+                fputs("null", stream);
+        }
+        fprintf(stream,
+                ", \"type\": \"%s\", \"groups\": %u, \"segments\": %u, "
+                "\"pipeline\": %u, \"records\": [",
+                key_type_name(arg->type), arg->group, arg->segment,
+                arg->pipeline);
+        for (unsigned int i = 0U; i < arg->record_count; ++i) {
+                fprintf(stream, "%s%d", i ? ", " : "", arg->record[i]);
+        }
+        fprintf(stream, "], \"argsort\": %s, \"serve\": %s},\n",
+                arg->argsort ? "true" : "false",
+                arg->serve ? "true" : "false");
+
+        fprintf(stream,
+                "  \"environment\": {\"processes\": %d, \"nodes\": %d, "
+                "\"hosts\": [",
+                meta->process, meta->node);
+        for (int i = 0; i < meta->process; ++i) {
+                fputs(i ? ", " : "", stream);
+                json_string_write_(stream, meta->host[i]);
+        }
+        fputs("], \"cpu\": ", stream);
+        json_string_write_(stream, meta->cpu);
+        fputs(", \"compiler\": ", stream);
+        json_string_write_(stream, PSRS_COMPILER);
+        fputs(", \"build_type\": ", stream);
+        json_string_write_(stream, PSRS_BUILD_TYPE);
+        fputs(", \"c_flags\": ", stream);
+        json_string_write_(stream, PSRS_C_FLAGS);
+        fputs(", \"mpi\": ", stream);
+        json_string_write_(stream, meta->mpi);
+        fputs("},\n", stream);
+}
+
+/* The CSV counterpart of 'json_header_write_', header line included. */
+static void csv_header_write_(FILE *stream,
+                              const struct cli_arg *arg,
+                              const struct report_meta *meta)
+{
+        fputs("section,name,field,value\n", stream);
+        fprintf(stream, "meta,schema,,%d\n", REPORT_SCHEMA);
+
+        fprintf(stream, "parameter,length,,%d\n", arg->length);
+        fprintf(stream, "parameter,run,,%u\n", arg->run);
+        fprintf(stream, "parameter,warmup,,%u\n", arg->warmup);
+        fprintf(stream, "parameter,seed,,%u\n", arg->seed);
+        fprintf(stream, "parameter,window,,%u\n", arg->window);
+        fprintf(stream, "parameter,dist,,%s\n", array_dist_name(arg->dist));
+        fprintf(stream, "parameter,phase,,%u\n", arg->phase);
+        fprintf(stream, "parameter,barrier,,%u\n", arg->barrier);
+        fprintf(stream, "parameter,counters,,%u\n", arg->counter);
+        fprintf(stream, "parameter,comm,,%u\n", arg->comm);
+        fprintf(stream, "parameter,memory,,%u\n", arg->memory);
+        fprintf(stream, "parameter,mem_limit,,%lu\n", arg->mem_limit);
+        fprintf(stream, "parameter,format,,%s\n", FORMAT_KEY[arg->format]);
+        fputs("parameter,trace,,", stream);
+        csv_string_write_(stream, arg->trace ? arg->trace_file : "");
+        fputs("\n", stream);
+        fprintf(stream, "parameter,type,,%s\n", key_type_name(arg->type));
+        fprintf(stream, "parameter,groups,,%u\n", arg->group);
+        fprintf(stream, "parameter,segments,,%u\n", arg->segment);
+        fprintf(stream, "parameter,pipeline,,%u\n", arg->pipeline);
+        for (unsigned int i = 0U; i < arg->record_count; ++i) {
+                fprintf(stream, "parameter,records,%u,%d\n",
+                        i, arg->record[i]);
+        }
+        fprintf(stream, "parameter,argsort,,%u\n", arg->argsort);
+        fprintf(stream, "parameter,serve,,%u\n", arg->serve);
+
+        fprintf(stream, "environment,processes,,%d\n", meta->process);
+        fprintf(stream, "environment,nodes,,%d\n", meta->node);
+        for (int i = 0; i < meta->process; ++i) {
+                fprintf(stream, "environment,host,%d,", i);
+                csv_string_write_(stream, meta->host[i]);
+                fputs("\n", stream);
+        }
+        fputs("environment,cpu,,", stream);
+        csv_string_write_(stream, meta->cpu);
+        fputs("\nenvironment,compiler,,", stream);
+        csv_string_write_(stream, PSRS_COMPILER);
+        fputs("\nenvironment,build_type,,", stream);
+        csv_string_write_(stream, PSRS_BUILD_TYPE);
+        fputs("\nenvironment,c_flags,,", stream);
+        csv_string_write_(stream, PSRS_C_FLAGS);
+        fputs("\nenvironment,mpi,,", stream);
+        csv_string_write_(stream, meta->mpi);
+        fputs("\n", stream);
+}
@@ -1,26 +1,30 @@
 #include "psrs/macro.h"
-#define RING_ONLY
 #include "psrs/ring.h"
-#undef RING_ONLY
 
 #include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 int ring_init(struct ring **self,
               const size_t length,
+              const size_t size,
               ring_alloc_t alloc,
               ring_free_t clean)
 {
         struct ring *ring = NULL;
-        struct ring_node *ring_node = NULL;
 
-        if (NULL == self || 0U == length) {
+        if (NULL == self || 0U == length || 0U == size) {
                 errno = EINVAL;
                 return -1;
         }
 
+        if (SIZE_MAX / size < length) {
+                errno = EOVERFLOW;
+                return -1;
+        }
+
         if (NULL == alloc && NULL == clean) {
                 alloc = malloc;
                 clean = free;
@@ -38,246 +42,126 @@ int ring_init(struct ring **self,
         }
 
         /*
-         * From this point on, all the 'ring_node's in a 'ring' is
-         * empty-initialized - the data field for each 'ring_node' is to be
-         * filled (or overwritten) later through 'ring_add' call.
+         * All the slots are allocated up front in a single block;
+         * they are filled (or overwritten) later through 'ring_add' call.
          */
-        if (0 > ring_node_init_(&ring_node, alloc)) {
+        ring->data = (unsigned char *)alloc(length * size);
+
+        if (NULL == ring->data) {
                 clean(ring);
                 return -1;
         }
 
-        /* Initializes the 'ring' structure and the 1st 'ring_node'. */
         ring->length = length;
+        ring->size = size;
+        ring->pos = 0U;
+        ring->count = 0U;
         ring->alloc = alloc;
         ring->clean = clean;
-        ring->head = ring_node;
-        ring->pos = ring_node;
-        /* Create a self-loop for the 1st 'ring_node'. */
-        ring->pos->next = ring->head;
-
-        /*
-         * Then initializes all the rest 'ring_node's while maintaining
-         * the circular property - 'next' field of the last 'ring_node'
-         * structure must point to the head 'ring_node'.
-         */
-        for (size_t i = 1U; i < length; ++i) {
-                if (0 > ring_node_init_(&ring_node, alloc)) {
-                        ring_destroy(&ring);
-                        return -1;
-                }
-                ring->pos->next = ring_node;
-                ring->pos = ring->pos->next;
-                ring->pos->next = ring->head;
-        }
 
-        ring->pos = ring->head;
         *self = ring;
-
-        return 0;
-}
-
-int ring_add(struct ring *self, const void *data, const size_t size)
-{
-        struct ring_node *ring_node = NULL;
-
-        if (NULL == self || NULL == data || 0U == size) {
-                errno = EINVAL;
-                return -1;
-        }
-
-        ring_node = self->pos;
-
-        if (0 >
-            ring_node_fill_(ring_node, data, size, self->alloc, self->clean)) {
-                return -1;
-        }
-
-        self->pos = self->pos->next;
-
-        return 0;
-}
-
-int ring_length(const struct ring *self, size_t *length)
-{
-        if (NULL == self || NULL == length) {
-                errno = EINVAL;
-                return -1;
-        }
-
-        *length = self->length;
         return 0;
 }
 
-int ring_destroy(struct ring **self)
+/*
+ * NOTE:
+ * If the ring is already full and 'evicted' is not NULL, the element about
+ * to be overwritten (the oldest one) is copied into 'evicted' first;
+ * otherwise 'evicted' is left untouched.
+ */
+int ring_add(struct ring *self, const void *data, void *evicted)
 {
-        struct ring *ring = NULL;
-        struct ring_node *ring_node = NULL;
-        struct ring_node *head_addr = NULL;
-        ring_free_t clean = NULL;
+        unsigned char *slot = NULL;
 
-        if (NULL == self) {
+        if (NULL == self || NULL == data) {
                 errno = EINVAL;
                 return -1;
         }
 
-        ring = *self;
-        clean = ring->clean;
-        head_addr = ring->head;
+        slot = self->data + self->pos * self->size;
 
-        for (ring_node = ring->head->next; ring->length != 0; --ring->length) {
-                /*
-                 * NOTE:
-                 * The 'length' of ring is in range [1, ∞], so 'ring->head'
-                 * must be a non-NULL value regardless of the 'length'.
-                 * Then there is no way for the following function call to
-                 * fail - return value is unchecked in this case.
-                 */
-                ring_node_destroy_(&(ring->head), clean);
-
-                if (head_addr != ring_node) {
-                        ring->head = ring_node;
-                        ring_node = ring->head->next;
+        if (self->count == self->length) {
+                if (NULL != evicted) {
+                        memcpy(evicted, slot, self->size);
                 }
+        } else {
+                self->count++;
         }
 
-        clean(ring);
-        *self = NULL;
-        return 0;
-}
+        memcpy(slot, data, self->size);
 
-int ring_iter_init(struct ring_iter **self, const struct ring *circle)
-{
-        struct ring_iter *ring_iter = NULL;
-
-        if (NULL == self || NULL == circle) {
-                errno = EINVAL;
-                return -1;
+        if (++self->pos == self->length) {
+                self->pos = 0U;
         }
-
-        ring_iter = (struct ring_iter *)malloc(sizeof(struct ring_iter));
-
-        if (NULL == ring_iter) {
-                return -1;
-        }
-
-        ring_iter->pos = circle->head;
-
-        *self = ring_iter;
         return 0;
 }
 
-int ring_iter_walk(struct ring_iter *self, void **data)
+/*
+ * Copies the 'index'-th element into 'data', where index 0 denotes the
+ * oldest element still held and 'count - 1' the most recently added one.
+ */
+int ring_get(const struct ring *self, const size_t index, void *data)
 {
-        struct ring_iter *ring_iter = NULL;
+        size_t slot = 0U;
 
         if (NULL == self || NULL == data) {
                 errno = EINVAL;
                 return -1;
         }
 
-        ring_iter = self;
-
-        *data = ring_iter->pos->data;
-        ring_iter->pos = ring_iter->pos->next;
-
-        return 0;
-}
-
-int ring_iter_destroy(struct ring_iter **self)
-{
-        if (NULL == self) {
-                errno = EINVAL;
+        if (index >= self->count) {
+                errno = ERANGE;
                 return -1;
         }
 
-        free(*self);
-        *self = NULL;
+        /* The oldest element sits at 'pos' once the ring wrapped around. */
+        if (self->count == self->length) {
+                slot = (self->pos + index) % self->length;
+        } else {
+                slot = index;
+        }
+
+        memcpy(data, self->data + slot * self->size, self->size);
         return 0;
 }
 
-static int ring_node_init_(struct ring_node **self, ring_alloc_t alloc)
+int ring_length(const struct ring *self, size_t *length)
 {
-        struct ring_node *ring_node = NULL;
-
-        if (NULL == self) {
+        if (NULL == self || NULL == length) {
                 errno = EINVAL;
                 return -1;
         }
 
-        if (NULL == alloc) {
-                alloc = malloc;
-        }
-
-        ring_node = (struct ring_node *)alloc(sizeof(struct ring_node));
-
-        if (NULL == ring_node) {
-                return -1;
-        }
-
-        ring_node->data = NULL;
-        ring_node->next = NULL;
-        *self = ring_node;
-
+        *length = self->length;
         return 0;
 }
 
-static int ring_node_fill_(struct ring_node *self,
-                           const void *data,
-                           const size_t size,
-                           ring_alloc_t alloc,
-                           ring_free_t clean)
+int ring_count(const struct ring *self, size_t *count)
 {
-        void *temp = NULL;
-
-        if (NULL == self || NULL == data || 0U == size) {
+        if (NULL == self || NULL == count) {
                 errno = EINVAL;
                 return -1;
         }
 
-        if (NULL == alloc && NULL == clean) {
-                alloc = malloc;
-                clean = free;
-        } else if (NULL != alloc && NULL != clean) {
-                ;
-        } else {
-                errno = EINVAL;
-                return -1;
-        }
-
-        if (NULL != self->data) {
-                clean(self->data);
-        }
-
-        temp = alloc(size);
-
-        if (NULL == temp) {
-                return -1;
-        }
-
-        self->data = temp;
-        memcpy(self->data, data, size);
+        *count = self->count;
         return 0;
 }
 
-static int ring_node_destroy_(struct ring_node **self, ring_free_t clean)
+int ring_destroy(struct ring **self)
 {
-        struct ring_node *ring_node = NULL;
+        struct ring *ring = NULL;
+        ring_free_t clean = NULL;
 
-        if (NULL == self) {
+        if (NULL == self || NULL == *self) {
                 errno = EINVAL;
                 return -1;
         }
 
-        if (NULL == clean) {
-                clean = free;
-        }
-
-        ring_node = *self;
-
-        clean(ring_node->data);
-        clean(ring_node);
+        ring = *self;
+        clean = ring->clean;
 
+        clean(ring->data);
+        clean(ring);
         *self = NULL;
         return 0;
 }
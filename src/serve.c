@@ -0,0 +1,352 @@
+#include "psrs/macro.h"
+#define SERVE_ONLY
+#include "psrs/serve.h"
+#undef SERVE_ONLY
+
+#include "psrs/convert.h"
+#include "psrs/generator.h"
+
+#include <mpi.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Number of jobs the queue holds before it first grows. */
+#define SERVE_QUEUE_INIT 64U
+
+/*
+ * NOTE:
+ * The FIFO at 'path' is created if nothing exists there yet; anything else
+ * than a FIFO is refused with 'EEXIST'.  The FIFO is opened lazily, by the
+ * first 'serve_queue_next' call, since opening it blocks until a writer
+ * opens it as well.
+ */
+int serve_queue_init(struct serve_queue **self,
+                     const char *const path,
+                     const unsigned int seed,
+                     const unsigned int dist)
+{
+        struct serve_queue *queue = NULL;
+        struct stat status;
+        unsigned int created = 0U;
+
+        if (NULL == self || NULL == path || DIST_COUNT <= dist) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (0 == stat(path, &status)) {
+                if (!S_ISFIFO(status.st_mode)) {
+                        errno = EEXIST;
+                        return -1;
+                }
+        } else if (ENOENT != errno || 0 > mkfifo(path, 0600)) {
+                return -1;
+        } else {
+                created = 1U;
+        }
+
+        queue = (struct serve_queue *)calloc(1U, sizeof(struct serve_queue));
+
+        if (NULL != queue) {
+                queue->job = (struct serve_job *)
+                             malloc(SERVE_QUEUE_INIT *
+                                    sizeof(struct serve_job));
+        }
+
+        if (NULL == queue || NULL == queue->job) {
+                free(queue);
+                if (created) {
+                        unlink(path);
+                }
+                return -1;
+        }
+
+        queue->path = path;
+        queue->fd = -1;
+        queue->created = created;
+        queue->seed = seed;
+        queue->dist = dist;
+        queue->capacity = SERVE_QUEUE_INIT;
+
+        *self = queue;
+        return 0;
+}
+
+/*
+ * Takes the job that arrived first off 'self' into 'job', waiting for one
+ * if the queue is empty; returns 1 if there is one, or 0 once the service
+ * is stopped and every job before "quit" is taken.
+ *
+ * NOTE:
+ * Whatever is already written into the FIFO is read first without waiting,
+ * so a job that arrives while another one is served is stamped when that
+ * one ends: its 'arrival' is late by at most the time of a single job.
+ */
+int serve_queue_next(struct serve_queue *self, struct serve_job *job)
+{
+        int retval = 0;
+
+        if (NULL == self || NULL == job) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (;;) {
+                do {
+                        retval = serve_queue_read_(self, 0);
+                } while (0 < retval);
+
+                if (0 > retval) {
+                        return -1;
+                }
+
+                if (0U < self->count) {
+                        *job = self->job[self->head];
+                        self->head = (self->head + 1U) % self->capacity;
+                        self->count -= 1U;
+                        return 1;
+                }
+
+                if (self->stopped) {
+                        return 0;
+                }
+
+                if (0 > serve_queue_read_(self, -1)) {
+                        return -1;
+                }
+        }
+}
+
+int serve_queue_destroy(struct serve_queue **self)
+{
+        struct serve_queue *queue = NULL;
+
+        if (NULL == self || NULL == *self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        queue = *self;
+
+        if (0 <= queue->fd) {
+                close(queue->fd);
+        }
+        if (queue->created) {
+                unlink(queue->path);
+        }
+        free(queue->job);
+        free(queue);
+        *self = NULL;
+        return 0;
+}
+
+/*
+ * Reads from the FIFO once, waiting at most 'timeout' milliseconds for
+ * something to read (forever if it is negative, including for a writer to
+ * open the FIFO); returns 1 if anything is read and 0 otherwise.
+ *
+ * NOTE:
+ * Once every writer closes the FIFO it is closed as well, and opened again
+ * when the next job is waited for.
+ */
+static int serve_queue_read_(struct serve_queue *self, const int timeout)
+{
+        char data[4096];
+        ssize_t size = 0;
+        int ready = 0;
+        struct pollfd fifo;
+
+        if (self->stopped) {
+                return 0;
+        }
+
+        if (0 > self->fd) {
+                if (0 <= timeout) {
+                        return 0;
+                }
+                do {
+                        self->fd = open(self->path, O_RDONLY);
+                } while (0 > self->fd && EINTR == errno);
+                if (0 > self->fd) {
+                        return -1;
+                }
+        }
+
+        fifo.fd = self->fd;
+        fifo.events = POLLIN;
+        fifo.revents = 0;
+        do {
+                ready = poll(&fifo, 1U, timeout);
+        } while (0 > ready && EINTR == errno);
+
+        if (0 >= ready) {
+                return ready;
+        }
+
+        do {
+                size = read(self->fd, data, sizeof data);
+        } while (0 > size && EINTR == errno);
+
+        if (0 > size) {
+                return -1;
+        }
+
+        if (0 == size) {
+                /* The last line may go without its newline. */
+                if (0U < self->line_size || self->discard) {
+                        serve_queue_scan_(self, "\n", 1U, MPI_Wtime());
+                }
+                close(self->fd);
+                self->fd = -1;
+                return 0;
+        }
+
+        serve_queue_scan_(self, data, (size_t)size, MPI_Wtime());
+        return 1;
+}
+
+/*
+ * Appends 'size' bytes of 'data' to the current line, parsing every line
+ * completed along the way as read at 'arrival'.
+ */
+static void serve_queue_scan_(struct serve_queue *self,
+                              const char *data,
+                              size_t size,
+                              const double arrival)
+{
+        const char *end = NULL;
+        size_t span = 0U;
+
+        while (0U < size && !self->stopped) {
+                end = memchr(data, '\n', size);
+                span = NULL == end ? size : (size_t)(end - data);
+
+                if (!self->discard &&
+                    SERVE_LINE_MAX - 1U - self->line_size < span) {
+                        fprintf(stderr,
+                                "serve: job descriptor longer than %u "
+                                "bytes ignored\n",
+                                SERVE_LINE_MAX - 1U);
+                        self->discard = 1U;
+                }
+                if (!self->discard) {
+                        memcpy(self->line + self->line_size, data, span);
+                        self->line_size += span;
+                }
+
+                if (NULL == end) {
+                        return;
+                }
+
+                if (!self->discard) {
+                        self->line[self->line_size] = '\0';
+                        serve_line_parse_(self, self->line, arrival);
+                }
+                self->line_size = 0U;
+                self->discard = 0U;
+                data = end + 1;
+                size -= span + 1U;
+        }
+}
+
+/* Queues the job described by 'line', or stops the service on "quit". */
+static int serve_line_parse_(struct serve_queue *self,
+                             char *line,
+                             const double arrival)
+{
+        static const char *const DELIM = " \t\r";
+        /* "LENGTH [SEED [DIST]]", plus one to tell if there are more. */
+        char *token[4] = { NULL };
+        char *save = NULL;
+        bool valid = true;
+        struct serve_job job;
+
+        token[0] = strtok_r(line, DELIM, &save);
+
+        if (NULL == token[0] || '#' == token[0][0]) {
+                return 0;
+        }
+
+        if (0 == strcmp("quit", token[0])) {
+                self->stopped = 1U;
+                return 0;
+        }
+
+        for (size_t i = 1U; i < 4U && NULL != token[i - 1U]; ++i) {
+                token[i] = strtok_r(NULL, DELIM, &save);
+        }
+
+        memset(&job, 0, sizeof job);
+        job.seed = self->seed;
+        job.dist = self->dist;
+        job.arrival = arrival;
+
+        valid = 0 == int_convert(&job.length, token[0]) &&
+                0 < job.length &&
+                (SIZE_MAX / sizeof(long)) >= (size_t)job.length;
+        if (valid && NULL != token[1]) {
+                valid = 0 == unsigned_convert(&job.seed, token[1]) &&
+                        0U != job.seed;
+        }
+        if (valid && NULL != token[2]) {
+                valid = 0 == array_dist_convert(&job.dist, token[2]);
+        }
+        if (!valid || NULL != token[3]) {
+                fputs("serve: job descriptor ignored, expected "
+                      "\"LENGTH [SEED [DIST]]\" or \"quit\"\n",
+                      stderr);
+                errno = EINVAL;
+                return -1;
+        }
+
+        job.id = self->next_id;
+        if (0 > serve_queue_push_(self, &job)) {
+                fprintf(stderr, "serve: job %u dropped: %s\n",
+                        job.id, strerror(errno));
+                return -1;
+        }
+        self->next_id += 1U;
+        return 0;
+}
+
+/* Appends 'job' to the ring, doubling it if it is full. */
+static int serve_queue_push_(struct serve_queue *self,
+                             const struct serve_job *job)
+{
+        struct serve_job *ring = NULL;
+
+        if (self->count == self->capacity) {
+                if (SIZE_MAX / 2U / sizeof(struct serve_job) <
+                    self->capacity) {
+                        errno = EOVERFLOW;
+                        return -1;
+                }
+                ring = (struct serve_job *)
+                       malloc(2U * self->capacity * sizeof(struct serve_job));
+                if (NULL == ring) {
+                        return -1;
+                }
+                /* Unrolled, so the oldest job is at the front again. */
+                for (size_t i = 0U; i < self->count; ++i) {
+                        ring[i] = self->job[(self->head + i) %
+                                            self->capacity];
+                }
+                free(self->job);
+                self->job = ring;
+                self->head = 0U;
+                self->capacity *= 2U;
+        }
+
+        self->job[(self->head + self->count) % self->capacity] = *job;
+        self->count += 1U;
+        return 0;
+}
@@ -3,14 +3,24 @@
 #include "psrs/sort.h"
 #undef PSRS_SORT_ONLY
 
+#include "psrs/affinity.h"
+#include "psrs/arena.h"
 #include "psrs/generator.h"
-#include "psrs/list.h"
+#include "psrs/key.h"
+#include "psrs/libpsrs.h"
+#include "psrs/pipeline.h"
+#include "psrs/plan.h"
 #include "psrs/psrs.h"
+#include "psrs/record.h"
+#include "psrs/report.h"
 #include "psrs/stats.h"
 #include "psrs/timing.h"
+#include "psrs/trace.h"
 
 #include <errno.h>
 #include <math.h>    /* ceil() */
+#include <limits.h>  /* INT_MAX */
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,331 +29,2812 @@ void sort_launch(const struct cli_arg *const arg)
 {
         int rank = 0;
         /*
-         * For one-process sequential sort and non-phased version of PSRS,
-         * the outputs are the same: an array with the member 'MEAN'
-         * along with 'STDEV' are stored.
+         * For one-process sequential sort only the statistics of the total
+         * sorting time are filled in; PSRS fills in the statistics of each
+         * phase as well.
          *
          * NOTE:
-         * Refer to the definition of 'enum sort_stat' in 'include/psrs/sort.h'
-         * for details.
-         */
-        double ssort_data[SORT_STAT_SIZE];
-        double psort_data[SORT_STAT_SIZE];
-
-        /*
-         * For a per-phase sorting time, the output is simply the time taken
-         * for each separate phase.
-         * The array is indexed with 'PHASE1' up to 'PHASE4'.
-         *
-         * NOTE:
-         * Refer to the definition of 'enum psrs_phase' in
+         * Refer to the definition of 'struct sort_result' in
          * 'include/psrs/sort.h' for details.
          */
-        double psort_per_phase_data[PHASE_COUNT];
+        struct sort_result result;
+        struct report_meta meta;
 
         if (NULL == arg || 0 == arg->process) {
                 errno = EINVAL;
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
+        /* Pinned once and for all, so every case of a sweep is as well. */
+        if (arg->pin && 0 > affinity_pin(MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        if (arg->sweep) {
+                sweep_launch(arg);
+                return;
+        }
+
+        if (0U != arg->group) {
+                batch_launch(arg);
+                return;
+        }
+
+        if (arg->serve) {
+                serve_launch(arg);
+                return;
+        }
+
+        if (0U != arg->segment) {
+                segment_launch(arg);
+                return;
+        }
+
+        if (0U != arg->pipeline) {
+                pipeline_launch(arg);
+                return;
+        }
+
+        if (KEY_LONG != arg->type) {
+                key_launch(arg);
+                return;
+        }
+
+        if (0U != arg->record_count) {
+                record_launch(arg);
+                return;
+        }
+
+        if (arg->argsort) {
+                argsort_launch(arg);
+                return;
+        }
+
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
+        result.sample_count = arg->run;
+        result.sample = calloc(arg->run, sizeof(*result.sample));
+        if (NULL == result.sample) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /*
+         * The text format only reports the affinity of the processes along
+         * with the methodology.
+         */
+        if ((FORMAT_TEXT != arg->format || methodology_given(arg)) &&
+            0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
         /*
          * If only 1 process is involved, use standard quick sort.
          *
-         * NOTE: Average and standard deviation is calculated by
-         * 'sequential_sort' directly, so simply gather the result.
+         * NOTE: Statistics are calculated by 'sequential_sort' directly,
+         * so simply gather the result.
          */
         if (1 == arg->process) {
-                if (0 > sequential_sort(ssort_data, arg)) {
+                if (0 > sequential_sort(&result, arg, MPI_COMM_WORLD)) {
                         MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
                 }
-
         } else if (1 < arg->process) {
-                /*
-                 * NOTE:
-                 * The array size is different since the outputs
-                 * are different.
-                 */
-                if (arg->phase) {
-                        parallel_sort(psort_per_phase_data, arg);
-                } else {
-                        parallel_sort(psort_data, arg);
+                parallel_sort(&result, arg, MPI_COMM_WORLD);
+        }
+
+        if (0 == rank) {
+                output_write(&result, arg, &meta);
+        }
+
+        report_meta_destroy(&meta);
+        free(result.sample);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/*
+ * Sorts every combination of the number of processes, length and
+ * distribution listed in 'arg' in turn, and writes all of them as a single
+ * report on root.
+ *
+ * NOTE:
+ * The cases of 'p' processes run on a communicator split off from the
+ * ranks below 'p', while the rest of the processes wait at the barrier
+ * that closes each number of processes, so no run overlaps another.
+ */
+static void sweep_launch(const struct cli_arg *const arg)
+{
+        int rank = 0;
+        unsigned int id = 0U;
+        MPI_Comm comm = MPI_COMM_NULL;
+        struct cli_arg sweep_arg;
+        struct sort_result result;
+        struct report_meta meta;
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 == rank && 0 > report_sweep_begin(stdout, arg)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        memset(&result, 0, sizeof result);
+        result.sample_count = arg->run;
+        result.sample = calloc(arg->run, sizeof(*result.sample));
+        if (NULL == result.sample) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        for (unsigned int i = 0U; i < arg->sweep_process_count; ++i) {
+                sweep_arg = *arg;
+                sweep_arg.process = arg->sweep_process[i];
+                MPI_Comm_split(MPI_COMM_WORLD,
+                               rank < sweep_arg.process ? 0 : MPI_UNDEFINED,
+                               rank,
+                               &comm);
+
+                for (unsigned int j = 0U;
+                     MPI_COMM_NULL != comm && j < arg->sweep_length_count;
+                     ++j) {
+                        sweep_arg.length = arg->sweep_length[j];
+                        for (unsigned int k = 0U;
+                             k < arg->sweep_dist_count;
+                             ++k) {
+                                sweep_arg.dist = arg->sweep_dist[k];
+                                sweep_case_run(&result,
+                                               &meta,
+                                               &sweep_arg,
+                                               comm);
+                                if (0 == rank &&
+                                    0 > report_sweep_write(stdout,
+                                                           id,
+                                                           &result,
+                                                           &sweep_arg,
+                                                           &meta)) {
+                                        MPI_Abort(MPI_COMM_WORLD,
+                                                  EXIT_FAILURE);
+                                }
+                                report_meta_destroy(&meta);
+                                ++id;
+                        }
                 }
+
+                if (MPI_COMM_NULL != comm) {
+                        MPI_Comm_free(&comm);
+                }
+                /* The processes outside of 'comm' wait here. */
+                MPI_Barrier(MPI_COMM_WORLD);
+        }
+
+        if (0 == rank && 0 > report_sweep_end(stdout, arg)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        free(result.sample);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/*
+ * Splits the processes into 'arg->group' groups of consecutive ranks, each
+ * of which sorts a table of its own (generated from the seed plus the index
+ * of the group) 'arg->run' times after 'arg->warmup' times through
+ * 'psrs_sort', concurrently with all the other groups; the time of every
+ * sort and the sorts per second of all the groups together are written on
+ * root.
+ *
+ * NOTE:
+ * Every group sorts on a communicator of its own (which 'psrs_sort'
+ * duplicates in turn), so the messages of different groups never match
+ * each other whatever their tags are: MPI matches a message by its
+ * communicator before its tag, and the collectives have no tags at all.
+ */
+static void batch_launch(const struct cli_arg *const arg)
+{
+        const int group_process = arg->process / (int)arg->group;
+        /* Number of elements of a table per process. */
+        const int size = arg->length / group_process;
+        int rank = 0;
+        int group_rank = 0;
+        int group_id = 0;
+        unsigned int rejected = 0U;
+        double begin = 0;
+        double wall = 0;
+        double stats[SORT_STAT_SIZE];
+        double (*all_stats)[SORT_STAT_SIZE] = NULL;
+        unsigned int *all_rejected = NULL;
+        /* Time of every measured sort on this process, then the slowest. */
+        double *elapsed = NULL;
+        double *slowest = NULL;
+        long *table = NULL;
+        long *block = NULL;
+        long *work = NULL;
+        struct psrs_opts opts;
+        struct psrs_result sorted;
+        struct batch_result result;
+        struct report_meta meta;
+        MPI_Comm comm = MPI_COMM_NULL;
+
+        memset(stats, 0, sizeof stats);
+        memset(&opts, 0, sizeof opts);
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        group_id = rank / group_process;
+        MPI_Comm_split(MPI_COMM_WORLD, group_id, rank, &comm);
+        MPI_Comm_rank(comm, &group_rank);
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        block = malloc(sizeof(long) * size);
+        work = malloc(sizeof(long) * size);
+        elapsed = calloc(arg->run, sizeof(double));
+        slowest = calloc(arg->run, sizeof(double));
+        if (NULL == block || NULL == work || NULL == elapsed ||
+            NULL == slowest) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /*
+         * The table of a group is generated and scattered once; every sort
+         * starts off from a fresh copy of the block of each process.
+         */
+        if (0 == group_rank) {
+                table = malloc(sizeof(long) * arg->length);
+                if (NULL == table ||
+                    0 > array_dist_generate(&table,
+                                            arg->length,
+                                            arg->seed + group_id,
+                                            arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+        MPI_Scatter(table, size, MPI_LONG, block, size, MPI_LONG, 0, comm);
+#ifndef PRINT_DEBUG_INFO
+        /* Otherwise the last result of the group is checked against it. */
+        free(table);
+        table = NULL;
+#endif
+
+        opts.mem_limit = arg->mem_limit;
+        opts.barrier = arg->barrier;
+
+        for (unsigned int k = 0U; k < arg->warmup + arg->run; ++k) {
+                /* All the groups start measuring at the same time. */
+                if (k == arg->warmup) {
+                        MPI_Barrier(MPI_COMM_WORLD);
+                        begin = MPI_Wtime();
+                }
+                memcpy(work, block, sizeof(long) * size);
+                if (0 > psrs_sort(comm, work, size, &sorted, &opts)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                if (k >= arg->warmup) {
+                        elapsed[k - arg->warmup] = sorted.elapsed;
+                }
+#ifdef PRINT_DEBUG_INFO
+                if (arg->warmup + arg->run - 1U == k) {
+                        array_check(sorted.head,
+                                    (int)sorted.size,
+                                    table,
+                                    arg->length,
+                                    comm);
+                }
+#endif
+                psrs_result_destroy(&sorted);
+        }
+        wall = MPI_Wtime() - begin;
+
+        MPI_Reduce(elapsed, slowest, arg->run, MPI_DOUBLE, MPI_MAX, 0, comm);
+        if (0 == group_rank) {
+                series_stats_calc(stats, &rejected, slowest, arg->run, arg);
+        }
+
+        /* Only the rows of the first process of each group are kept. */
+        if (0 == rank) {
+                all_stats = calloc(arg->process, sizeof(*all_stats));
+                all_rejected = calloc(arg->process, sizeof(unsigned int));
+                result.stats = calloc(arg->group, sizeof(*result.stats));
+                result.rejected = calloc(arg->group, sizeof(unsigned int));
+                if (NULL == all_stats || NULL == all_rejected ||
+                    NULL == result.stats || NULL == result.rejected) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+        MPI_Gather(stats, SORT_STAT_SIZE, MPI_DOUBLE,
+                   all_stats, SORT_STAT_SIZE, MPI_DOUBLE,
+                   0, MPI_COMM_WORLD);
+        MPI_Gather(&rejected, 1, MPI_UNSIGNED,
+                   all_rejected, 1, MPI_UNSIGNED,
+                   0, MPI_COMM_WORLD);
+        MPI_Reduce(&wall, &(result.wall), 1, MPI_DOUBLE, MPI_MAX,
+                   0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                result.group = arg->group;
+                result.group_process = group_process;
+                result.sorts = arg->group * arg->run;
+                result.throughput = result.sorts / result.wall;
+                for (unsigned int i = 0U; i < arg->group; ++i) {
+                        memcpy(result.stats[i],
+                               all_stats[i * group_process],
+                               sizeof(result.stats[i]));
+                        result.rejected[i] = all_rejected[i * group_process];
+                }
+                if (0 > report_batch_write(stdout, &result, arg, &meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        free(result.rejected);
+        free(result.stats);
+        free(all_rejected);
+        free(all_stats);
+        free(table);
+        free(slowest);
+        free(elapsed);
+        free(work);
+        free(block);
+        report_meta_destroy(&meta);
+        MPI_Comm_free(&comm);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/*
+ * Keeps all the processes up to sort the jobs root reads from the FIFO at
+ * 'arg->serve_path' one at a time, in the order they arrive, until "quit"
+ * or 'arg->run' jobs; root writes a record of every job as soon as it is
+ * served, and the statistics of the last 'arg->window' jobs after the
+ * first 'arg->warmup' ones at the end.
+ *
+ * NOTE:
+ * Only the length, the seed and the distribution of a job are broadcast;
+ * root generates the table and scatters it as evenly as it goes.  Nothing
+ * is allocated per job once the buffers have grown to the largest job so
+ * far: the table, the blocks and the memory 'psrs_sort' works in (through
+ * 'reuse') are all kept from one job to the next, and they start off with
+ * the room for a job of 'arg->length'.
+ */
+static void serve_launch(const struct cli_arg *const arg)
+{
+        int rank = 0;
+        /* Elements there is room for in the table and in the block. */
+        int table_capacity = 0;
+        int block_capacity = 0;
+        int size = 0;
+        int *count = NULL;
+        int *displ = NULL;
+        long *table = NULL;
+        long *block = NULL;
+        /* Length, seed and distribution of the job; 0 length to stop. */
+        unsigned long desc[3];
+        double begin = 0;
+        double scattered = 0;
+        double sort = 0;
+        struct serve_queue *queue = NULL;
+        struct serve_job job;
+        struct serve_record record;
+        struct serve_result result;
+        /* Records of the last 'arg->window' measured jobs, on root. */
+        struct serve_record *recent = NULL;
+        struct psrs_opts opts;
+        struct psrs_result sorted;
+        struct report_meta meta;
+
+        memset(&job, 0, sizeof job);
+        memset(&record, 0, sizeof record);
+        memset(&result, 0, sizeof result);
+        memset(&opts, 0, sizeof opts);
+        memset(&sorted, 0, sizeof sorted);
+        memset(&meta, 0, sizeof meta);
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        opts.mem_limit = arg->mem_limit;
+        opts.barrier = arg->barrier;
+        opts.reuse = true;
+
+        block_capacity = arg->length / arg->process;
+        block = malloc(sizeof(long) * block_capacity);
+        if (NULL == block) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
         if (0 == rank) {
-                if (1 == arg->process) {
-                        output_write(ssort_data, arg);
-                } else if (1 < arg->process) {
-                        if (arg->phase) {
-                                output_write(psort_per_phase_data, arg);
-                        } else {
-                                output_write(psort_data, arg);
+                table_capacity = arg->length;
+                table = malloc(sizeof(long) * table_capacity);
+                count = malloc(sizeof(int) * arg->process);
+                displ = malloc(sizeof(int) * arg->process);
+                recent = malloc(sizeof(struct serve_record) * arg->window);
+                if (NULL == table || NULL == count || NULL == displ ||
+                    NULL == recent) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                if (0 > serve_queue_init(&queue,
+                                         arg->serve_path,
+                                         arg->seed,
+                                         arg->dist)) {
+                        fprintf(stderr, "serve: %s: %s\n",
+                                arg->serve_path, strerror(errno));
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                if (0 > report_serve_begin(stdout, arg, &meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                fflush(stdout);
+        }
+
+        for (;;) {
+                memset(desc, 0, sizeof desc);
+                if (0 == rank && result.jobs < arg->run) {
+                        switch (serve_queue_next(queue, &job)) {
+                        case 1:
+                                desc[0] = (unsigned long)job.length;
+                                desc[1] = job.seed;
+                                desc[2] = job.dist;
+                                record.queued = (unsigned int)queue->count;
+                                break;
+                        case 0:
+                                break;
+                        default:
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                }
+                begin = MPI_Wtime();
+                MPI_Bcast(desc, 3, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+                if (0UL == desc[0]) {
+                        break;
+                }
+
+                /* The first 'length % process' processes take 1 more. */
+                size = (int)(desc[0] / arg->process) +
+                       (rank < (int)(desc[0] % arg->process));
+                if (block_capacity < size) {
+                        free(block);
+                        block_capacity = size;
+                        block = malloc(sizeof(long) * block_capacity);
+                        if (NULL == block) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                }
+
+                if (0 == rank) {
+                        if (table_capacity < job.length) {
+                                free(table);
+                                table_capacity = job.length;
+                                table = malloc(sizeof(long) *
+                                               table_capacity);
+                        }
+                        if (NULL == table ||
+                            0 > array_dist_generate(&table,
+                                                    job.length,
+                                                    job.seed,
+                                                    job.dist)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        for (int i = 0; i < arg->process; ++i) {
+                                count[i] = job.length / arg->process +
+                                           (i < job.length % arg->process);
+                                displ[i] = 0 == i ? 0 :
+                                           displ[i - 1] + count[i - 1];
+                        }
+                }
+                MPI_Scatterv(table, count, displ, MPI_LONG,
+                             block, size, MPI_LONG, 0, MPI_COMM_WORLD);
+                scattered = MPI_Wtime();
+
+                if (0 > psrs_sort(MPI_COMM_WORLD,
+                                  block,
+                                  size,
+                                  &sorted,
+                                  &opts)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                MPI_Reduce(&(sorted.elapsed), &sort, 1, MPI_DOUBLE, MPI_MAX,
+                           0, MPI_COMM_WORLD);
+
+                if (0 == rank) {
+                        record.job = job;
+                        record.wait = begin - job.arrival;
+                        record.setup = scattered - begin;
+                        record.sort = sort;
+                        record.latency = MPI_Wtime() - job.arrival;
+                        serve_record_add(&result, recent, &record, arg);
+                        if (0 > report_serve_write(stdout, &record, arg)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
                         }
+                        /* Whoever reads the records gets them right away. */
+                        fflush(stdout);
+                }
+#ifdef PRINT_DEBUG_INFO
+                /* After the record, so only the jobs queued up wait on it. */
+                array_check(sorted.head,
+                            (int)sorted.size,
+                            table,
+                            (int)desc[0],
+                            MPI_COMM_WORLD);
+#endif
+                result.jobs += 1U;
+        }
+
+        if (0 == rank) {
+                if (0U < result.measured) {
+                        result.throughput = result.measured / result.busy;
+                        serve_stats_calc(&result, recent, arg);
+                }
+                if (0 > report_serve_end(stdout, &result, arg)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
                 }
+                serve_queue_destroy(&queue);
         }
 
+        psrs_result_destroy(&sorted);
+        free(recent);
+        free(displ);
+        free(count);
+        free(table);
+        free(block);
+        report_meta_destroy(&meta);
         MPI_Barrier(MPI_COMM_WORLD);
 }
 
-int part_blk_init(struct part_blk **self, bool clean, int size)
+/*
+ * Sorts the array of 'arg->length' as 'arg->segment' independent segments
+ * of equal length 'arg->run' times after 'arg->warmup' times in 2 ways: in
+ * a single pass through 'psrs_sort_segments', and one segment after
+ * another through 'psrs_sort'; root writes the statistics of the time each
+ * takes to sort all the segments.
+ *
+ * NOTE:
+ * Segment 'k' is the 'k'-th slice of the array as generated, so it lies in
+ * the blocks of the processes it overlaps after the scatter.  Sorted one
+ * after another, every process still takes part in the sort of every
+ * segment, even if it holds none of its elements, as it would if the
+ * segments were separate sorts: each costs the full set of collectives
+ * and messages whatever its length, which is the overhead the single pass
+ * pays only once.
+ */
+static void segment_launch(const struct cli_arg *const arg)
 {
-        struct part_blk *blk = NULL;
-        size_t total_size = sizeof(struct part_blk) +\
-                            size * sizeof(struct partition);
+        const int size = arg->length / arg->process;
+        const int segment_length = arg->length / (int)arg->segment;
+        int rank = 0;
+        /* Index of the first element of the block within the array. */
+        int base = 0;
+        int begin = 0;
+        int end = 0;
+        double lap = 0;
+        double *elapsed = NULL;
+        double *slowest = NULL;
+        long *table = NULL;
+        long *block = NULL;
+        long *work = NULL;
+        int32_t *segment = NULL;
+        struct psrs_opts opts;
+        struct psrs_result sorted;
+        struct segment_result result;
+        struct report_meta meta;
+
+        memset(&opts, 0, sizeof opts);
+        memset(&sorted, 0, sizeof sorted);
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
 
-        if (NULL == self || 0 >= size) {
-                errno = EINVAL;
-                return -1;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        base = rank * size;
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        blk = (struct part_blk *)malloc(total_size);
+        block = malloc(sizeof(long) * size);
+        work = malloc(sizeof(long) * size);
+        segment = malloc(sizeof(int32_t) * size);
+        /* The batched times of every run, followed by the serial ones. */
+        elapsed = calloc(2U * arg->run, sizeof(double));
+        slowest = calloc(2U * arg->run, sizeof(double));
+        if (NULL == block || NULL == work || NULL == segment ||
+            NULL == elapsed || NULL == slowest) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
 
-        if (NULL == blk) {
-                return -1;
+        if (0 == rank) {
+                table = malloc(sizeof(long) * arg->length);
+                if (NULL == table ||
+                    0 > array_dist_generate(&table,
+                                            arg->length,
+                                            arg->seed,
+                                            arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
         }
+        MPI_Scatter(table, size, MPI_LONG, block, size, MPI_LONG,
+                    0, MPI_COMM_WORLD);
+#ifndef PRINT_DEBUG_INFO
+        /* Otherwise the last result is checked against it. */
+        free(table);
+        table = NULL;
+#endif
 
-        memset(blk, 0, total_size);
-        blk->clean = clean;
-        blk->size = size;
+        for (int i = 0; i < size; ++i) {
+                segment[i] = (base + i) / segment_length;
+        }
 
-        *self = blk;
-        return 0;
+        opts.mem_limit = arg->mem_limit;
+        opts.barrier = arg->barrier;
+        /* Neither way allocates again after the first sort. */
+        opts.reuse = true;
+
+        for (unsigned int k = 0U; k < arg->warmup + arg->run; ++k) {
+                memcpy(work, block, sizeof(long) * size);
+                MPI_Barrier(MPI_COMM_WORLD);
+                lap = MPI_Wtime();
+                if (0 > psrs_sort_segments(MPI_COMM_WORLD,
+                                           work,
+                                           segment,
+                                           size,
+                                           &sorted,
+                                           &opts)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                lap = MPI_Wtime() - lap;
+                if (k >= arg->warmup) {
+                        elapsed[k - arg->warmup] = lap;
+                }
+#ifdef PRINT_DEBUG_INFO
+                if (arg->warmup + arg->run - 1U == k) {
+                        segment_check(&sorted, table, arg);
+                }
+#endif
+
+                memcpy(work, block, sizeof(long) * size);
+                MPI_Barrier(MPI_COMM_WORLD);
+                lap = MPI_Wtime();
+                for (unsigned int j = 0U; j < arg->segment; ++j) {
+                        /* Part of segment 'j' within the block, if any. */
+                        begin = (int)j * segment_length - base;
+                        end = begin + segment_length;
+                        begin = 0 > begin ? 0 : begin;
+                        begin = size < begin ? size : begin;
+                        end = size < end ? size : end;
+                        end = begin > end ? begin : end;
+                        if (0 > psrs_sort(MPI_COMM_WORLD,
+                                          work + begin,
+                                          end - begin,
+                                          &sorted,
+                                          &opts)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                }
+                lap = MPI_Wtime() - lap;
+                if (k >= arg->warmup) {
+                        elapsed[arg->run + k - arg->warmup] = lap;
+                }
+        }
+
+        MPI_Reduce(elapsed, slowest, 2 * arg->run, MPI_DOUBLE, MPI_MAX,
+                   0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                result.segment = arg->segment;
+                result.segment_length = segment_length;
+                for (unsigned int i = 0U; i < 2U; ++i) {
+                        series_stats_calc(0U == i ?
+                                          result.batched : result.serial,
+                                          0U == i ?
+                                          &result.batched_rejected :
+                                          &result.serial_rejected,
+                                          &slowest[i * arg->run],
+                                          arg->run,
+                                          arg);
+                }
+                if (0 > report_segment_write(stdout, &result, arg, &meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        psrs_result_destroy(&sorted);
+        free(table);
+        free(slowest);
+        free(elapsed);
+        free(segment);
+        free(work);
+        free(block);
+        report_meta_destroy(&meta);
+        MPI_Barrier(MPI_COMM_WORLD);
 }
 
-int part_blk_destroy(struct part_blk **self)
+/*
+ * Sorts 'arg->run' jobs (after 'arg->warmup' ones), each a fresh copy of
+ * the same array, back to back and then with up to 'arg->pipeline' of them
+ * in flight at once through 'pipeline_run'; root writes the jobs per second
+ * and the statistics of the latency of a job of both.
+ *
+ * NOTE:
+ * Both run on the same engine, the back to back one with a depth of 1, so
+ * the difference is only in the overlap of the phases of different jobs.
+ */
+static void pipeline_launch(const struct cli_arg *const arg)
 {
-        struct part_blk *blk = NULL;
+        const int size = arg->length / arg->process;
+        const unsigned int depth[PIPELINE_MODE_COUNT] = {
+                [PIPELINE_SERIAL]  = 1U,
+                [PIPELINE_OVERLAP] = arg->pipeline
+        };
+        int rank = 0;
+        double begin = 0;
+        double wall = 0;
+        double *latency = NULL;
+        double *slowest = NULL;
+        long *table = NULL;
+        long *block = NULL;
+        struct pipeline *pipeline = NULL;
+        struct pipeline_result result;
+        struct report_meta meta;
+
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        block = malloc(sizeof(long) * size);
+        /* Room for the warm-up jobs as well. */
+        latency = calloc(arg->warmup + arg->run, sizeof(double));
+        slowest = calloc(arg->run, sizeof(double));
+        if (NULL == block || NULL == latency || NULL == slowest) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        if (0 == rank) {
+                table = malloc(sizeof(long) * arg->length);
+                if (NULL == table ||
+                    0 > array_dist_generate(&table,
+                                            arg->length,
+                                            arg->seed,
+                                            arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+        MPI_Scatter(table, size, MPI_LONG, block, size, MPI_LONG,
+                    0, MPI_COMM_WORLD);
+#ifndef PRINT_DEBUG_INFO
+        /* Otherwise the last results are checked against it. */
+        free(table);
+        table = NULL;
+#endif
+
+        result.depth = arg->pipeline;
+        result.jobs = arg->run;
+
+        for (int i = PIPELINE_SERIAL; i < PIPELINE_MODE_COUNT; ++i) {
+                if (0 > pipeline_init(&pipeline,
+                                      MPI_COMM_WORLD,
+                                      depth[i],
+                                      size)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                if (0U < arg->warmup &&
+                    0 > pipeline_run(pipeline, block, arg->warmup,
+                                     latency)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                MPI_Barrier(MPI_COMM_WORLD);
+                begin = MPI_Wtime();
+                if (0 > pipeline_run(pipeline, block, arg->run, latency)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                wall = MPI_Wtime() - begin;
+#ifdef PRINT_DEBUG_INFO
+                /* Every slot that took a job holds the result of its last. */
+                for (unsigned int j = 0U; j < depth[i] && j < arg->run; ++j) {
+                        array_check(pipeline->slot[j].arg.merged,
+                                    pipeline->slot[j].arg.merged_size,
+                                    table,
+                                    arg->length,
+                                    MPI_COMM_WORLD);
+                }
+#endif
+                pipeline_destroy(&pipeline);
+
+                MPI_Reduce(&wall, &(result.wall[i]), 1, MPI_DOUBLE, MPI_MAX,
+                           0, MPI_COMM_WORLD);
+                MPI_Reduce(latency, slowest, arg->run, MPI_DOUBLE, MPI_MAX,
+                           0, MPI_COMM_WORLD);
+                if (0 != rank) {
+                        continue;
+                }
+
+                result.throughput[i] = arg->run / result.wall[i];
+                series_stats_calc(result.latency[i],
+                                  &(result.rejected[i]),
+                                  slowest,
+                                  arg->run,
+                                  arg);
+        }
+
+        if (0 == rank &&
+            0 > report_pipeline_write(stdout, &result, arg, &meta)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        free(table);
+        free(slowest);
+        free(latency);
+        free(block);
+        report_meta_destroy(&meta);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/*
+ * Sorts the array as keys of 'arg->type' rather than 'long' through
+ * 'key_sort', 'arg->run' times (after 'arg->warmup' runs); root writes the
+ * statistics of the time of a sort, the keys per second and the bytes
+ * every process sends while exchanging partitions, which shrink along with
+ * the keys.
+ *
+ * NOTE:
+ * The values are generated as for 'long' and converted by the kernel of
+ * the type (see 'struct key_kernel'), so the same seed and distribution
+ * give the same order of keys of every type.
+ */
+static void key_launch(const struct cli_arg *const arg)
+{
+        const struct key_kernel *kernel = key_kernel(arg->type);
+        const MPI_Datatype datatype = key_datatype(arg->type);
+        const int size = arg->length / arg->process;
+        int rank = 0;
+        size_t key_size = 0U;
+        double begin = 0;
+        double sent_sum = 0;
+        double *elapsed = NULL;
+        double *slowest = NULL;
+        long *generated = NULL;
+        unsigned char *table = NULL;
+        unsigned char *block = NULL;
+        unsigned char *work = NULL;
+        struct arena *arena = NULL;
+        struct key_sorted sorted;
+        struct key_result result;
+        struct report_meta meta;
+
+        if (NULL == kernel) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        memset(&sorted, 0, sizeof sorted);
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        key_size = kernel->size;
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        block = malloc(key_size * size);
+        elapsed = calloc(arg->run, sizeof(double));
+        slowest = calloc(arg->run, sizeof(double));
+        if (NULL == block || NULL == elapsed || NULL == slowest) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /* Root keeps the table to check the result against. */
+        if (0 == rank) {
+                table = malloc(key_size * arg->length);
+                if (NULL == table ||
+                    0 > array_dist_generate(&generated,
+                                            arg->length,
+                                            arg->seed,
+                                            arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                kernel->convert(table, generated, arg->length, arg->dist);
+                array_destroy(&generated);
+        }
+        MPI_Scatter(table, size, datatype, block, size, datatype,
+                    0, MPI_COMM_WORLD);
+
+        /*
+         * A copy of the block, the radix sort buffer, the partitions
+         * received and the 2 merge buffers (about a block each), and the
+         * samples; the arena grows during the 1st run if that falls short.
+         */
+        if (0 > arena_init(&arena,
+                           key_size * (5U * size +
+                                       arg->process * arg->process +
+                                       2U * arg->process) +
+                           6U * sizeof(int) * arg->process +
+                           8U * ARENA_ALIGN)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        for (unsigned int k = 0U; k < arg->warmup + arg->run; ++k) {
+                if (0 > arena_reset(arena) ||
+                    0 > arena_alloc(arena, (void **)&work, key_size * size)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                memcpy(work, block, key_size * size);
+                MPI_Barrier(MPI_COMM_WORLD);
+                begin = MPI_Wtime();
+                if (0 > key_sort(&sorted, MPI_COMM_WORLD, kernel, datatype,
+                                 work, size, arena)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                if (k >= arg->warmup) {
+                        elapsed[k - arg->warmup] = MPI_Wtime() - begin;
+                }
+        }
+
+#ifdef PRINT_DEBUG_INFO
+        key_check(&sorted, table, arg);
+#endif
+
+        /* Every run exchanges the same partitions, so the last one does. */
+        MPI_Reduce(elapsed, slowest, arg->run, MPI_DOUBLE, MPI_MAX,
+                   0, MPI_COMM_WORLD);
+        MPI_Reduce(&(sorted.sent), &sent_sum, 1, MPI_DOUBLE, MPI_SUM,
+                   0, MPI_COMM_WORLD);
+        MPI_Reduce(&(sorted.sent), &(result.sent_max), 1, MPI_DOUBLE,
+                   MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                result.type = arg->type;
+                result.size = key_size;
+                result.sent = sent_sum / arg->process;
+                series_stats_calc(result.time,
+                                  &(result.rejected),
+                                  slowest,
+                                  arg->run,
+                                  arg);
+                result.throughput = arg->length / result.time[MEAN];
+
+                if (0 > report_key_write(stdout, &result, arg, &meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        arena_destroy(&arena);
+        free(table);
+        free(slowest);
+        free(elapsed);
+        free(block);
+        report_meta_destroy(&meta);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/*
+ * Sorts records of each payload size in 'arg->record' in turn (see
+ * 'record_case_run'); root writes the statistics of the time of a sort by
+ * either strategy, the records per second and the bytes every process
+ * sends over all the exchanges of a sort, along with how much faster
+ * fetching the payloads after the keys is than carrying them along.
+ */
+static void record_launch(const struct cli_arg *const arg)
+{
+        int rank = 0;
+        struct record_result result;
+        struct report_meta meta;
+
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        result.count = arg->record_count;
+        for (unsigned int i = 0U; i < arg->record_count; ++i) {
+                record_case_run(&result, i, arg);
+        }
+
+        if (0 == rank &&
+            0 > report_record_write(stdout, &result, arg, &meta)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        report_meta_destroy(&meta);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/*
+ * Sorts records with the payload size 'arg->record[index]' through
+ * 'record_sort' by every strategy, 'arg->run' times each (after
+ * 'arg->warmup' runs), and fills in the entries of 'index' in 'result' on
+ * root.
+ *
+ * NOTE:
+ * The keys are the values generated as for 'long', so the same seed and
+ * distribution give the same order whatever the payload; the payload of
+ * a record repeats its index in the whole table, so every record can be
+ * told apart and checked after the sort.
+ */
+static void record_case_run(struct record_result *const result,
+                            const unsigned int index,
+                            const struct cli_arg *const arg)
+{
+        const int size = arg->length / arg->process;
+        int rank = 0;
+        int64_t key = 0;
+        uint64_t origin = 0U;
+        double begin = 0;
+        double sent_sum = 0;
+        double *elapsed = NULL;
+        double *slowest = NULL;
+        long *generated = NULL;
+        unsigned char *table = NULL;
+        unsigned char *block = NULL;
+        unsigned char *work = NULL;
+        unsigned char *record = NULL;
+        struct arena *arena = NULL;
+        struct record_layout layout;
+        struct record_sorted sorted;
+
+        memset(&sorted, 0, sizeof sorted);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 > record_layout_init(&layout, (size_t)arg->record[index])) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        block = malloc(layout.size * size);
+        elapsed = calloc(arg->run, sizeof(double));
+        slowest = calloc(arg->run, sizeof(double));
+        if (NULL == block || NULL == elapsed || NULL == slowest) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /* Root keeps the table to check the result against. */
+        if (0 == rank) {
+                table = malloc(layout.size * arg->length);
+                if (NULL == table ||
+                    0 > array_dist_generate(&generated,
+                                            arg->length,
+                                            arg->seed,
+                                            arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                for (int i = 0; i < arg->length; ++i) {
+                        record = table + layout.size * i;
+                        key = (int64_t)generated[i];
+                        origin = (uint64_t)i;
+                        memcpy(record, &key, sizeof(int64_t));
+                        for (size_t j = 0U; j < layout.payload; j += 8U) {
+                                memcpy(record + sizeof(int64_t) + j,
+                                       &origin,
+                                       sizeof(uint64_t));
+                        }
+                }
+                array_destroy(&generated);
+        }
+        MPI_Scatter(table, size, layout.datatype,
+                    block, size, layout.datatype,
+                    0, MPI_COMM_WORLD);
+
+        /*
+         * A copy of the block, the records received and the 2 merge
+         * buffers, or the pairs, their buffers and the payloads fetched
+         * (about a block each), and the samples; the arena grows during
+         * the 1st run if that falls short.
+         */
+        if (0 > arena_init(&arena,
+                           (5U * layout.size + 80U) * size +
+                           layout.size *
+                           (arg->process * arg->process +
+                            2U * arg->process) +
+                           9U * sizeof(int) * arg->process +
+                           16U * ARENA_ALIGN)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        result->payload[index] = arg->record[index];
+        result->size[index] = layout.size;
+
+        for (unsigned int strategy = RECORD_CARRY;
+             strategy < RECORD_STRATEGY_COUNT;
+             ++strategy) {
+                for (unsigned int k = 0U; k < arg->warmup + arg->run; ++k) {
+                        if (0 > arena_reset(arena) ||
+                            0 > arena_alloc(arena,
+                                            (void **)&work,
+                                            layout.size * size)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        memcpy(work, block, layout.size * size);
+                        MPI_Barrier(MPI_COMM_WORLD);
+                        begin = MPI_Wtime();
+                        if (0 > record_sort(&sorted, MPI_COMM_WORLD,
+                                            &layout, strategy,
+                                            work, size, arena)) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        if (k >= arg->warmup) {
+                                elapsed[k - arg->warmup] =
+                                        MPI_Wtime() - begin;
+                        }
+                }
+
+#ifdef PRINT_DEBUG_INFO
+                record_check(&sorted, table, &layout, arg);
+#endif
+
+                MPI_Reduce(elapsed, slowest, arg->run, MPI_DOUBLE, MPI_MAX,
+                           0, MPI_COMM_WORLD);
+                MPI_Reduce(&(sorted.sent), &sent_sum, 1, MPI_DOUBLE,
+                           MPI_SUM, 0, MPI_COMM_WORLD);
+
+                if (0 != rank) {
+                        continue;
+                }
+                result->sent[index][strategy] = sent_sum / arg->process;
+                series_stats_calc(result->time[index][strategy],
+                                  &(result->rejected[index][strategy]),
+                                  slowest,
+                                  arg->run,
+                                  arg);
+                result->throughput[index][strategy] =
+                        arg->length / result->time[index][strategy][MEAN];
+        }
+
+        arena_destroy(&arena);
+        record_layout_destroy(&layout);
+        free(table);
+        free(slowest);
+        free(elapsed);
+        free(block);
+}
+
+/*
+ * Sorts the array of 'arg->length' 'arg->run' times after 'arg->warmup'
+ * times in 2 ways: through 'psrs_sort', and stably along with the original
+ * index of every element through 'psrs_argsort'; root writes the
+ * statistics of the time of each and how much more the latter costs.
+ *
+ * NOTE:
+ * Every element of 'psrs_argsort' carries its index through the exchange
+ * and the merge, so twice as many bytes move, and the local sort breaks
+ * ties by it; that is the cost of being stable and of telling where every
+ * element comes from, all of which 'psrs_sort' does without.
+ */
+static void argsort_launch(const struct cli_arg *const arg)
+{
+        const int size = arg->length / arg->process;
+        int rank = 0;
+        double lap = 0;
+        double *elapsed = NULL;
+        double *slowest = NULL;
+        long *table = NULL;
+        long *block = NULL;
+        long *work = NULL;
+        struct psrs_opts opts;
+        struct psrs_result sorted[ARGSORT_MODE_COUNT];
+        struct argsort_result result;
+        struct report_meta meta;
+
+        memset(&opts, 0, sizeof opts);
+        memset(sorted, 0, sizeof sorted);
+        memset(&result, 0, sizeof result);
+        memset(&meta, 0, sizeof meta);
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 > report_meta_init(&meta, MPI_COMM_WORLD)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        block = malloc(sizeof(long) * size);
+        work = malloc(sizeof(long) * size);
+        /* The times of every run of each mode, one mode after another. */
+        elapsed = calloc(ARGSORT_MODE_COUNT * arg->run, sizeof(double));
+        slowest = calloc(ARGSORT_MODE_COUNT * arg->run, sizeof(double));
+        if (NULL == block || NULL == work ||
+            NULL == elapsed || NULL == slowest) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /* Root keeps the table to check the result against. */
+        if (0 == rank &&
+            0 > array_dist_generate(&table,
+                                    arg->length,
+                                    arg->seed,
+                                    arg->dist)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        MPI_Scatter(table, size, MPI_LONG, block, size, MPI_LONG,
+                    0, MPI_COMM_WORLD);
+
+        opts.barrier = arg->barrier;
+        /* Neither mode allocates again after the first sort. */
+        opts.reuse = true;
+
+        for (unsigned int k = 0U; k < arg->warmup + arg->run; ++k) {
+                memcpy(work, block, sizeof(long) * size);
+                MPI_Barrier(MPI_COMM_WORLD);
+                lap = MPI_Wtime();
+                if (0 > psrs_sort(MPI_COMM_WORLD,
+                                  work,
+                                  size,
+                                  &sorted[ARGSORT_SORT],
+                                  &opts)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                lap = MPI_Wtime() - lap;
+                if (k >= arg->warmup) {
+                        elapsed[k - arg->warmup] = lap;
+                }
+
+                /* 'block' is left as it is, so there is nothing to copy. */
+                MPI_Barrier(MPI_COMM_WORLD);
+                lap = MPI_Wtime();
+                if (0 > psrs_argsort(MPI_COMM_WORLD,
+                                     block,
+                                     size,
+                                     &sorted[ARGSORT_STABLE],
+                                     &opts)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                lap = MPI_Wtime() - lap;
+                if (k >= arg->warmup) {
+                        elapsed[arg->run + k - arg->warmup] = lap;
+                }
+        }
+
+#ifdef PRINT_DEBUG_INFO
+        argsort_check(&sorted[ARGSORT_STABLE], table, arg);
+#endif
+
+        MPI_Reduce(elapsed, slowest, ARGSORT_MODE_COUNT * arg->run,
+                   MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                for (unsigned int i = 0U; i < ARGSORT_MODE_COUNT; ++i) {
+                        series_stats_calc(result.time[i],
+                                          &(result.rejected[i]),
+                                          &slowest[i * arg->run],
+                                          arg->run,
+                                          arg);
+                        result.throughput[i] =
+                                arg->length / result.time[i][MEAN];
+                }
+                result.overhead = result.time[ARGSORT_STABLE][MEAN] /
+                                  result.time[ARGSORT_SORT][MEAN];
+                if (0 > report_argsort_write(stdout, &result, arg, &meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        for (unsigned int i = 0U; i < ARGSORT_MODE_COUNT; ++i) {
+                psrs_result_destroy(&sorted[i]);
+        }
+        array_destroy(&table);
+        free(slowest);
+        free(elapsed);
+        free(work);
+        free(block);
+        report_meta_destroy(&meta);
+        MPI_Barrier(MPI_COMM_WORLD);
+}
+
+#ifdef PRINT_DEBUG_INFO
+/*
+ * Gathers the keys 'sorted' holds on every process to root, and checks
+ * them against the 'table' they were scattered from sorted by 'qsort'
+ * bit for bit, so NaN and -0.0 have to end up in their places as well.
+ *
+ * NOTE: 'table' is sorted in place.
+ */
+static void key_check(const struct key_sorted *const sorted,
+                      void *table,
+                      const struct cli_arg *const arg)
+{
+        const struct key_kernel *kernel = key_kernel(arg->type);
+        const MPI_Datatype datatype = key_datatype(arg->type);
+        int rank = 0;
+        int *count = NULL;
+        int *displ = NULL;
+        unsigned char *result = NULL;
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 == rank) {
+                count = malloc(sizeof(int) * arg->process);
+                displ = malloc(sizeof(int) * arg->process);
+                result = malloc(kernel->size * arg->length);
+                if (NULL == count || NULL == displ || NULL == result) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        MPI_Gather(&(sorted->size), 1, MPI_INT, count, 1, MPI_INT,
+                   0, MPI_COMM_WORLD);
+        for (int i = 0, offset = 0; 0 == rank && i < arg->process; ++i) {
+                displ[i] = offset;
+                offset += count[i];
+        }
+        MPI_Gatherv(sorted->head, sorted->size, datatype,
+                    result, count, displ, datatype,
+                    0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                qsort(table, arg->length, kernel->size, kernel->compare);
+                fputs("\n------------------------------\n", stderr);
+                fputs("Phase 5: Result Verification\n", stderr);
+                fputs("\n------------------------------\n", stderr);
+                if (0 != memcmp(table, result, kernel->size * arg->length)) {
+                        fputs("The Result is Wrong!\n", stderr);
+                } else {
+                        fputs("The Result is Right!\n", stderr);
+                }
+                fputs("------------------------------\n", stderr);
+        }
+
+        free(result);
+        free(displ);
+        free(count);
+}
+
+/*
+ * Gathers the records 'sorted' holds on every process to root, checks
+ * that their keys never go down, and that they are the records of the
+ * 'table' they were scattered from with their payloads intact.
+ *
+ * NOTE: 'table' is sorted in place.
+ */
+static void record_check(const struct record_sorted *const sorted,
+                         unsigned char *table,
+                         const struct record_layout *const layout,
+                         const struct cli_arg *const arg)
+{
+        int rank = 0;
+        bool right = true;
+        int *count = NULL;
+        int *displ = NULL;
+        unsigned char *result = NULL;
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 == rank) {
+                count = malloc(sizeof(int) * arg->process);
+                displ = malloc(sizeof(int) * arg->process);
+                result = malloc(layout->size * arg->length);
+                if (NULL == count || NULL == displ || NULL == result) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        MPI_Gather(&(sorted->size), 1, MPI_INT, count, 1, MPI_INT,
+                   0, MPI_COMM_WORLD);
+        for (int i = 0, offset = 0; 0 == rank && i < arg->process; ++i) {
+                displ[i] = offset;
+                offset += count[i];
+        }
+        MPI_Gatherv(sorted->head, sorted->size, layout->datatype,
+                    result, count, displ, layout->datatype,
+                    0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                for (int i = 1; right && i < arg->length; ++i) {
+                        right = record_key(result + layout->size * (i - 1)) <=
+                                record_key(result + layout->size * i);
+                }
+                /* Records of equal keys are told apart by their index. */
+                qsort(table, arg->length, layout->size, record_check_compare);
+                qsort(result, arg->length, layout->size, record_check_compare);
+                right = right &&
+                        0 == memcmp(table, result,
+                                    layout->size * arg->length);
+                fputs("\n------------------------------\n", stderr);
+                fputs("Phase 5: Result Verification\n", stderr);
+                fputs("\n------------------------------\n", stderr);
+                if (!right) {
+                        fputs("The Result is Wrong!\n", stderr);
+                } else {
+                        fputs("The Result is Right!\n", stderr);
+                }
+                fputs("------------------------------\n", stderr);
+        }
+
+        free(result);
+        free(displ);
+        free(count);
+}
+
+/*
+ * Compares 2 records as made by 'record_case_run' by their keys and then
+ * their index, as for 'qsort'.
+ */
+static int record_check_compare(const void *left, const void *right)
+{
+        const unsigned char *const left_record = left;
+        const unsigned char *const right_record = right;
+        const int64_t left_key = record_key(left_record);
+        const int64_t right_key = record_key(right_record);
+        uint64_t left_origin = 0U;
+        uint64_t right_origin = 0U;
+
+        if (left_key != right_key) {
+                return (left_key > right_key) - (left_key < right_key);
+        }
+        memcpy(&left_origin, left_record + sizeof(int64_t), sizeof(uint64_t));
+        memcpy(&right_origin,
+               right_record + sizeof(int64_t),
+               sizeof(uint64_t));
+        return (left_origin > right_origin) - (left_origin < right_origin);
+}
+
+/*
+ * Gathers the keys and the indices 'sorted' holds on every process to
+ * root, and checks that the keys never go down, that every key is the one
+ * of 'table' at its index, that the indices of equal keys go up, and that
+ * every index turns up exactly once.
+ */
+static void argsort_check(const struct psrs_result *const sorted,
+                          const long table[const],
+                          const struct cli_arg *const arg)
+{
+        const int size = (int)sorted->size;
+        int rank = 0;
+        bool right = true;
+        int *count = NULL;
+        int *displ = NULL;
+        long *key = NULL;
+        int64_t *index = NULL;
+        bool *seen = NULL;
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 == rank) {
+                count = malloc(sizeof(int) * arg->process);
+                displ = malloc(sizeof(int) * arg->process);
+                key = malloc(sizeof(long) * arg->length);
+                index = malloc(sizeof(int64_t) * arg->length);
+                seen = calloc(arg->length, sizeof(bool));
+                if (NULL == count || NULL == displ || NULL == key ||
+                    NULL == index || NULL == seen) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        MPI_Gather(&size, 1, MPI_INT, count, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        for (int i = 0, offset = 0; 0 == rank && i < arg->process; ++i) {
+                displ[i] = offset;
+                offset += count[i];
+        }
+        MPI_Gatherv(sorted->head, size, MPI_LONG,
+                    key, count, displ, MPI_LONG,
+                    0, MPI_COMM_WORLD);
+        MPI_Gatherv(sorted->index, size, MPI_INT64_T,
+                    index, count, displ, MPI_INT64_T,
+                    0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                for (int i = 0; right && i < arg->length; ++i) {
+                        right = 0 <= index[i] && arg->length > index[i] &&
+                                !seen[index[i]] &&
+                                table[index[i]] == key[i];
+                        if (right) {
+                                seen[index[i]] = true;
+                        }
+                        if (right && 0 < i) {
+                                right = key[i - 1] < key[i] ||
+                                        (key[i - 1] == key[i] &&
+                                         index[i - 1] < index[i]);
+                        }
+                }
+                fputs("\n------------------------------\n", stderr);
+                fputs("Phase 5: Result Verification\n", stderr);
+                fputs("\n------------------------------\n", stderr);
+                if (!right) {
+                        fputs("The Result is Wrong!\n", stderr);
+                } else {
+                        fputs("The Result is Right!\n", stderr);
+                }
+                fputs("------------------------------\n", stderr);
+        }
+
+        free(seen);
+        free(index);
+        free(key);
+        free(displ);
+        free(count);
+}
+
+/*
+ * Gathers the keys and the segments 'sorted' holds on every process to
+ * root, and checks that the segments come one after another in the order
+ * of their numbers, each as long as in 'table' it was scattered from, and
+ * that the keys of each are those of its part of 'table' sorted by
+ * 'qsort', so none crosses the boundary of its segment.
+ *
+ * NOTE: 'table' is sorted in place, a segment at a time.
+ */
+static void segment_check(const struct psrs_result *const sorted,
+                          long table[const],
+                          const struct cli_arg *const arg)
+{
+        const int size = (int)sorted->size;
+        const int segment_length = arg->length / (int)arg->segment;
+        int rank = 0;
+        bool right = true;
+        int *count = NULL;
+        int *displ = NULL;
+        long *key = NULL;
+        int32_t *segment = NULL;
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        if (0 == rank) {
+                count = malloc(sizeof(int) * arg->process);
+                displ = malloc(sizeof(int) * arg->process);
+                key = malloc(sizeof(long) * arg->length);
+                segment = malloc(sizeof(int32_t) * arg->length);
+                if (NULL == count || NULL == displ || NULL == key ||
+                    NULL == segment) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        MPI_Gather(&size, 1, MPI_INT, count, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        for (int i = 0, offset = 0; 0 == rank && i < arg->process; ++i) {
+                displ[i] = offset;
+                offset += count[i];
+        }
+        MPI_Gatherv(sorted->head, size, MPI_LONG,
+                    key, count, displ, MPI_LONG,
+                    0, MPI_COMM_WORLD);
+        MPI_Gatherv(sorted->segment, size, MPI_INT32_T,
+                    segment, count, displ, MPI_INT32_T,
+                    0, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+                for (unsigned int j = 0U; j < arg->segment; ++j) {
+                        qsort(table + (size_t)j * segment_length,
+                              segment_length,
+                              sizeof(long),
+                              long_compare);
+                }
+                for (int i = 0; right && i < arg->length; ++i) {
+                        right = i / segment_length == segment[i] &&
+                                table[i] == key[i];
+                }
+                fputs("\n------------------------------\n", stderr);
+                fputs("Phase 5: Result Verification\n", stderr);
+                fputs("\n------------------------------\n", stderr);
+                if (!right) {
+                        fputs("The Result is Wrong!\n", stderr);
+                } else {
+                        fputs("The Result is Right!\n", stderr);
+                }
+                fputs("------------------------------\n", stderr);
+        }
+
+        free(segment);
+        free(key);
+        free(displ);
+        free(count);
+}
+
+/*
+ * Gathers the 'size' elements 'sorted' holds on every process of 'comm'
+ * to root in the order of the ranks, and checks them against the 'length'
+ * elements of 'table' sorted by 'qsort'; 'table' is only read on root.
+ *
+ * NOTE: 'table' is sorted in place.
+ */
+static void array_check(const long sorted[const],
+                        const int size,
+                        long table[const],
+                        const int length,
+                        MPI_Comm comm)
+{
+        int rank = 0;
+        int process = 0;
+        int *count = NULL;
+        int *displ = NULL;
+        long *result = NULL;
+
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &process);
+
+        if (0 == rank) {
+                count = malloc(sizeof(int) * process);
+                displ = malloc(sizeof(int) * process);
+                result = malloc(sizeof(long) * length);
+                if (NULL == count || NULL == displ || NULL == result) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        MPI_Gather(&size, 1, MPI_INT, count, 1, MPI_INT, 0, comm);
+        for (int i = 0, offset = 0; 0 == rank && i < process; ++i) {
+                displ[i] = offset;
+                offset += count[i];
+        }
+        if (0 == rank && length != displ[process - 1] + count[process - 1]) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        MPI_Gatherv(sorted, size, MPI_LONG,
+                    result, count, displ, MPI_LONG,
+                    0, comm);
+
+        if (0 == rank) {
+                qsort(table, length, sizeof(long), long_compare);
+                fputs("\n------------------------------\n", stderr);
+                fputs("Phase 5: Result Verification\n", stderr);
+                fputs("\n------------------------------\n", stderr);
+                if (0 != memcmp(table, result, sizeof(long) * length)) {
+                        fputs("The Result is Wrong!\n", stderr);
+                } else {
+                        fputs("The Result is Right!\n", stderr);
+                }
+                fputs("------------------------------\n", stderr);
+        }
+
+        free(result);
+        free(displ);
+        free(count);
+}
+#endif
+
+/*
+ * Accounts for the job of 'record' in 'result', and keeps it among the
+ * 'arg->window' most recent ones in 'recent' unless it is a warm-up job.
+ */
+static void serve_record_add(struct serve_result *const result,
+                             struct serve_record recent[const],
+                             const struct serve_record *const record,
+                             const struct cli_arg *const arg)
+{
+        if (record->queued > result->queued_max) {
+                result->queued_max = record->queued;
+        }
+
+        if (result->jobs < arg->warmup) {
+                return;
+        }
+
+        recent[result->measured % arg->window] = *record;
+        result->measured += 1U;
+        result->busy += record->latency - record->wait;
+}
+
+/*
+ * Fills in the statistics of every time of 'enum serve_time' over the
+ * records in 'recent', which are fewer than 'arg->window' if not as many
+ * jobs are measured.
+ */
+static void serve_stats_calc(struct serve_result *const result,
+                             const struct serve_record recent[const],
+                             const struct cli_arg *const arg)
+{
+        const unsigned int kept = result->measured < arg->window ?
+                                  result->measured : arg->window;
+        /* The oldest record is overwritten first once 'recent' is full. */
+        const unsigned int oldest = result->measured % kept;
+        unsigned int rejected = 0U;
+        const struct serve_record *record = NULL;
+        double *series = NULL;
+
+        series = malloc(SERVE_TIME_COUNT * kept * sizeof(double));
+        if (NULL == series) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        for (unsigned int j = 0U; j < kept; ++j) {
+                record = &recent[(oldest + j) % kept];
+                series[SERVE_WAIT * kept + j] = record->wait;
+                series[SERVE_SETUP * kept + j] = record->setup;
+                series[SERVE_SORT * kept + j] = record->sort;
+                series[SERVE_LATENCY * kept + j] = record->latency;
+        }
+        for (int i = SERVE_WAIT; i < SERVE_TIME_COUNT; ++i) {
+                series_stats_calc(result->time[i],
+                                  &rejected,
+                                  &series[i * kept],
+                                  kept,
+                                  arg);
+        }
+        free(series);
+}
+
+/*
+ * Sorts the single case described by 'arg' on 'comm', which consists of
+ * exactly 'arg->process' processes.
+ */
+static void sweep_case_run(struct sort_result *const result,
+                           struct report_meta *const meta,
+                           const struct cli_arg *const arg,
+                           MPI_Comm comm)
+{
+        double (*sample)[SAMPLE_SIZE] = result->sample;
+
+        memset(result, 0, sizeof(*result));
+        memset(sample, 0, arg->run * sizeof(*sample));
+        result->sample = sample;
+        result->sample_count = arg->run;
+        memset(meta, 0, sizeof(*meta));
+
+        /* Only the structured formats describe the environment. */
+        if (FORMAT_TEXT != arg->format &&
+            0 > report_meta_init(meta, comm)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        if (1 == arg->process) {
+                if (0 > sequential_sort(result, arg, comm)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        } else {
+                parallel_sort(result, arg, comm);
+        }
+}
+
+/*
+ * NOTE:
+ * The 'part_blk' lives in 'arena' along with the partitions it describes,
+ * so there is no matching destroy function: it goes away on 'arena_reset'.
+ */
+int part_blk_init(struct part_blk **self, struct arena *arena, int size)
+{
+        struct part_blk *blk = NULL;
+        size_t total_size = sizeof(struct part_blk) +\
+                            size * sizeof(struct partition);
+
+        if (NULL == self || NULL == arena || 0 >= size) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (0 > arena_alloc(arena, (void **)&blk, total_size)) {
+                return -1;
+        }
+
+        memset(blk, 0, total_size);
+        blk->size = size;
+
+        *self = blk;
+        return 0;
+}
+
+static void
+output_write(const struct sort_result *const result,
+             const struct cli_arg *const arg,
+             const struct report_meta *const meta)
+{
+        static const char *const STAT_HEADER = "Mean, Standard Deviation, "
+                                               "Min, Max, Median, P90, P99, "
+                                               "CI95 Low, CI95 High";
+        static const char *const STAT_FORMAT = "%f, %f, %f, %f, %f, "
+                                               "%f, %f, %f, %f\n";
+        static const char *const COUNTER_NAME[COUNTER_COUNT] = {
+                [COUNTER_CYCLES]        = "Cycles",
+                [COUNTER_INSTRUCTIONS]  = "Instructions",
+                [COUNTER_BRANCH_MISSES] = "Branch Misses",
+                [COUNTER_LLC_MISSES]    = "LLC Misses",
+                [COUNTER_DTLB_MISSES]   = "dTLB Misses"
+        };
+        static const char *const MEMORY_NAME[MEMORY_STAT_SIZE] = {
+                [MEMORY_ALLOCATED]   = "Allocated (bytes)",
+                [MEMORY_ALLOCATIONS] = "Allocations",
+                [MEMORY_LIVE]        = "Live (bytes)",
+                [MEMORY_RESERVED]    = "Reserved (bytes)",
+                [MEMORY_RSS]         = "RSS (bytes)",
+                [MEMORY_PEAK_RSS]    = "Peak RSS (bytes)"
+        };
+        static const char *const COMM_NAME[COMM_FUNC_COUNT] = {
+                [COMM_SEND]     = "MPI_Send",
+                [COMM_SSEND]    = "MPI_Ssend",
+                [COMM_RECV]     = "MPI_Recv",
+                [COMM_BARRIER]  = "MPI_Barrier",
+                [COMM_BCAST]    = "MPI_Bcast",
+                [COMM_SCATTER]  = "MPI_Scatter",
+                [COMM_GATHER]   = "MPI_Gather",
+                [COMM_GATHERV]  = "MPI_Gatherv",
+                [COMM_ALLTOALL] = "MPI_Alltoall",
+                [COMM_REDUCE]   = "MPI_Reduce"
+        };
+        static const char *const SUBPHASE_NAME[SUBPHASE_COUNT] = {
+                [SUB_SCATTER]       = "1.1 Scatter",
+                [SUB_LOCAL_SORT]    = "1.2 Local Sort",
+                [SUB_SAMPLING]      = "1.3 Sampling",
+                [SUB_GATHER]        = "2.1 Sample Gather",
+                [SUB_PIVOT]         = "2.2 Pivot Selection",
+                [SUB_PARTITION]     = "2.3 Partition Forming",
+                [SUB_EXCHANGE]      = "3 Exchange",
+                [SUB_MERGE]         = "4.1 Merge",
+                [SUB_RESULT_GATHER] = "4.2 Result Gather"
+        };
+
+        if (NULL == result || NULL == arg || NULL == meta) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /*
+         * The structured formats always carry everything recorded,
+         * regardless of the value of 'arg->phase'.
+         */
+        if (FORMAT_JSON == arg->format) {
+                if (0 > report_json_write(stdout, result, arg, meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                return;
+        } else if (FORMAT_CSV == arg->format) {
+                if (0 > report_csv_write(stdout, result, arg, meta)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                return;
+        }
+
+        /*
+         * NOTE:
+         * The binary output is either 'SORT_STAT_SIZE' values of the total
+         * sorting time, or, with the per-phase flag, 'SORT_STAT_SIZE'
+         * values for each of the 4 phases followed by the total; the order
+         * of the values is the same as 'enum sort_stat'.
+         */
+        if (arg->binary) {
+                if (arg->phase) {
+                        fwrite(result->phase,
+                               sizeof(result->phase[0][0]),
+                               PHASE_COUNT * SORT_STAT_SIZE,
+                               stdout);
+                }
+                fwrite(result->total,
+                       sizeof(result->total[0]),
+                       SORT_STAT_SIZE,
+                       stdout);
+                return;
+        }
+
+        if (arg->phase) {
+                printf("Phase, %s\n", STAT_HEADER);
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        printf("Phase %d, ", i - PHASE1 + 1);
+                        printf(STAT_FORMAT,
+                               result->phase[i][MEAN],
+                               result->phase[i][STDEV],
+                               result->phase[i][MIN],
+                               result->phase[i][MAX],
+                               result->phase[i][MEDIAN],
+                               result->phase[i][P90],
+                               result->phase[i][P99],
+                               result->phase[i][CI95_LOW],
+                               result->phase[i][CI95_HIGH]);
+                }
+                printf("Total, ");
+        } else {
+                printf("%s\n", STAT_HEADER);
+        }
+        printf(STAT_FORMAT,
+               result->total[MEAN],
+               result->total[STDEV],
+               result->total[MIN],
+               result->total[MAX],
+               result->total[MEDIAN],
+               result->total[P90],
+               result->total[P99],
+               result->total[CI95_LOW],
+               result->total[CI95_HIGH]);
+
+        /*
+         * Sub-phases are only timed by PSRS: each row is the mean time of
+         * the sub-phase summarized across all the processes.
+         */
+        if (arg->phase && 1 < arg->process) {
+                printf("\nSub-Phase, Min, Avg, Max\n");
+                for (int i = SUB_SCATTER; i < SUBPHASE_COUNT; ++i) {
+                        printf("%s, %f, %f, %f\n",
+                               SUBPHASE_NAME[i],
+                               result->subphase[i][RANK_MIN],
+                               result->subphase[i][RANK_AVG],
+                               result->subphase[i][RANK_MAX]);
+                }
+        }
+
+        /*
+         * Hardware events are the mean count per run of each process,
+         * summarized across all the processes like the sub-phases.
+         */
+        if (arg->counter) {
+                printf("\nPhase, Counter, Min, Avg, Max\n");
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int j = COUNTER_CYCLES; j < COUNTER_COUNT; ++j) {
+                                printf("Phase %d, %s, ",
+                                       i - PHASE1 + 1, COUNTER_NAME[j]);
+                                if (!(result->counter_available & 1U << j)) {
+                                        puts("n/a, n/a, n/a");
+                                        continue;
+                                }
+                                printf("%.0f, %.0f, %.0f\n",
+                                       result->counter[i][j][RANK_MIN],
+                                       result->counter[i][j][RANK_AVG],
+                                       result->counter[i][j][RANK_MAX]);
+                        }
+                }
+        }
+
+        /*
+         * The memory is the largest over the runs of each process,
+         * summarized across all the processes like the sub-phases.
+         */
+        if (arg->memory && 1 < arg->process) {
+                printf("\nPhase, Memory, Min, Avg, Max\n");
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int j = MEMORY_ALLOCATED;
+                             j < MEMORY_STAT_SIZE;
+                             ++j) {
+                                printf("Phase %d, %s, %.0f, %.0f, %.0f\n",
+                                       i - PHASE1 + 1, MEMORY_NAME[j],
+                                       result->memory[i][j][RANK_MIN],
+                                       result->memory[i][j][RANK_AVG],
+                                       result->memory[i][j][RANK_MAX]);
+                        }
+                }
+        }
+
+        /*
+         * The MPI calls are the mean per run of each process, summarized
+         * across all the processes; a function is left out of a phase if
+         * no process calls it there.  The summary per phase gives the mean
+         * of each process: few bytes per call suggests the phase is bound
+         * by latency, many by bandwidth.
+         */
+        if (arg->comm && 1 < arg->process) {
+                printf("\nPhase, Function, Calls, Bytes Sent, "
+                       "Bytes Received, Time Min, Time Avg, Time Max\n");
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                                const double (*stat)[RANK_STAT_SIZE] =
+                                        result->comm[i][j];
+
+                                if (0 >= stat[COMM_CALLS][RANK_MAX]) {
+                                        continue;
+                                }
+                                printf("Phase %d, %s, %.2f, %.0f, %.0f, "
+                                       "%f, %f, %f\n",
+                                       i - PHASE1 + 1, COMM_NAME[j],
+                                       stat[COMM_CALLS][RANK_AVG],
+                                       stat[COMM_BYTES_SENT][RANK_AVG],
+                                       stat[COMM_BYTES_RECEIVED][RANK_AVG],
+                                       stat[COMM_TIME][RANK_MIN],
+                                       stat[COMM_TIME][RANK_AVG],
+                                       stat[COMM_TIME][RANK_MAX]);
+                        }
+                }
+
+                /*
+                 * Like the calls above, the summary of a phase is the mean
+                 * of each process, except that 'MPI_Barrier' is left out,
+                 * just as the barrier waits are left out of the time of the
+                 * phase the MPI time is a share of (see 'comm_reduce'); the
+                 * share is summarized across processes.
+                 */
+                printf("\nPhase, Calls, Bytes Sent, Bytes per Call, "
+                       "MPI Time, MPI Time Min (%%), MPI Time Avg (%%), "
+                       "MPI Time Max (%%)\n");
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        double sum[COMM_STAT_SIZE] = {0};
+
+                        for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                                for (int s = COMM_CALLS;
+                                     COMM_BARRIER != j && s < COMM_STAT_SIZE;
+                                     ++s) {
+                                        sum[s] += result->comm[i][j][s]
+                                                              [RANK_AVG];
+                                }
+                        }
+                        printf("Phase %d, %.2f, %.0f, %.0f, %f, "
+                               "%.1f, %.1f, %.1f\n",
+                               i - PHASE1 + 1,
+                               sum[COMM_CALLS],
+                               sum[COMM_BYTES_SENT],
+                               0 < sum[COMM_CALLS] ?
+                               (sum[COMM_BYTES_SENT] +
+                                sum[COMM_BYTES_RECEIVED]) /
+                               sum[COMM_CALLS] : 0.0,
+                               sum[COMM_TIME],
+                               result->comm_share[i][RANK_MIN],
+                               result->comm_share[i][RANK_AVG],
+                               result->comm_share[i][RANK_MAX]);
+                }
+        }
+
+        /*
+         * The methodology is stated whenever it departs from the default,
+         * so results measured with cold and warm caches can not be
+         * mistaken for one another; the layout is as before otherwise.
+         */
+        if (!methodology_given(arg)) {
+                return;
+        }
+        printf("\nMethodology, Value\n");
+        printf("Warmup Runs, %u\n", arg->warmup);
+        printf("Cache, %s\n", arg->cold ? "cold" : "warm");
+        printf("Pinning, %s\n", arg->pin ? "on" : "off");
+        printf("Persistent Requests, %s\n", arg->persistent ? "on" : "off");
+        if (arg->outlier) {
+                printf("Outlier Rejection, MAD (%g)\n", OUTLIER_LIMIT);
+                printf("Rejected Runs, %u\n", result->rejected[PHASE_COUNT]);
+        } else {
+                printf("Outlier Rejection, none\n");
+        }
+        if (0UL != arg->mem_limit) {
+                printf("Memory Limit (bytes), %lu\n", arg->mem_limit);
+                printf("Memory Bound (bytes), %.0f\n", result->mem_bound);
+        } else {
+                printf("Memory Limit (bytes), none\n");
+        }
+        printf("\nRank, Host, CPU Affinity\n");
+        for (int i = 0; i < meta->process; ++i) {
+                printf("%d, %s, \"%s\"\n",
+                       i, meta->host[i], meta->affinity[i]);
+        }
+}
+
+/*
+ * Whether any option of the methodology of the runs is given, as opposed
+ * to their defaults.
+ */
+static bool
+methodology_given(const struct cli_arg *const arg)
+{
+        return 0U != arg->warmup || arg->cold || arg->pin || arg->outlier ||
+               arg->persistent || 0UL != arg->mem_limit;
+}
+
+/*
+ * Fills in every statistic of 'enum sort_stat' from the series of sorting
+ * times recorded in 'window'; with outlier rejection turned on, the
+ * statistics are those of the runs left after the outliers are taken out,
+ * and 'rejected' is set to the number of runs taken out.
+ */
+static int
+stats_calc(double stats[const],
+           unsigned int *const rejected,
+           const struct moving_window *const window,
+           const struct cli_arg *const arg)
+{
+        size_t outlier = 0U;
+        struct moving_window *filtered = NULL;
+        /* Either 'window' itself or the runs left in 'filtered'. */
+        const struct moving_window *kept = window;
+
+        if (NULL == stats || NULL == rejected ||
+            NULL == window || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        *rejected = 0U;
+        if (arg->outlier) {
+                if (0 > moving_mad_filter(window,
+                                          OUTLIER_LIMIT,
+                                          &filtered,
+                                          &outlier)) {
+                        return -1;
+                }
+                *rejected = (unsigned int)outlier;
+                kept = filtered;
+        }
+
+        if (0 > moving_average_calc(kept, &(stats[MEAN])) ||
+            0 > moving_stdev_calc(kept, &(stats[STDEV])) ||
+            0 > moving_min_calc(kept, &(stats[MIN])) ||
+            0 > moving_max_calc(kept, &(stats[MAX])) ||
+            0 > moving_percentile_calc(kept, 50, &(stats[MEDIAN])) ||
+            0 > moving_percentile_calc(kept, 90, &(stats[P90])) ||
+            0 > moving_percentile_calc(kept, 99, &(stats[P99])) ||
+            0 > moving_ci95_calc(kept,
+                                 &(stats[CI95_LOW]),
+                                 &(stats[CI95_HIGH]))) {
+                if (NULL != filtered) {
+                        moving_window_destroy(&filtered);
+                }
+                return -1;
+        }
+
+        if (NULL != filtered) {
+                moving_window_destroy(&filtered);
+        }
+        return 0;
+}
+
+/*
+ * Fills in 'stats' and 'rejected' the way stats_calc does from the 'count'
+ * sorting times of 'series', of which the moving window keeps the last
+ * 'arg->window'; any failure aborts the program.
+ */
+static void
+series_stats_calc(double stats[const],
+                  unsigned int *const rejected,
+                  const double series[const],
+                  const unsigned int count,
+                  const struct cli_arg *const arg)
+{
+        struct moving_window *window = NULL;
+
+        if (0 > moving_window_init(&window, arg->window)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        for (unsigned int k = 0U; k < count; ++k) {
+                if (0 > moving_window_push(window, series[k])) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+        if (0 > stats_calc(stats, rejected, window, arg)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        moving_window_destroy(&window);
+}
+
+static int
+sequential_sort(struct sort_result *const result,
+                const struct cli_arg *const arg,
+                MPI_Comm comm)
+{
+        double elapsed = 0;
+        double begin = 0;
+        long *array = NULL;
+        struct timespec start;
+        struct moving_window *window = NULL;
+        struct trace *trace = NULL;
+        struct timing_flush flush;
+
+        if (NULL == result || NULL == arg) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (arg->cold && 0 > timing_flush_init(&flush)) {
+                return -1;
+        }
+
+        if (0 > moving_window_init(&window, arg->window)) {
+                return -1;
+        }
+
+        if (0 > array_dist_generate(&array,
+                                    arg->length,
+                                    arg->seed,
+                                    arg->dist)) {
+                return -1;
+        }
+
+        /* Only the runs themselves are traced for the sequential sort. */
+        if (arg->trace &&
+            0 > trace_init(&trace, arg->warmup + arg->run)) {
+                return -1;
+        }
+
+        timing_reset(&start);
+        /*
+         * If the number of threads needs to be executed is 1, pthread APIs
+         * need not to be invoked.
+         */
+        for (size_t iteration = 0U;
+             iteration < arg->warmup + arg->run;
+             ++iteration) {
+                if (arg->cold && 0 > timing_flush(&flush)) {
+                        return -1;
+                }
+                begin = MPI_Wtime();
+                timing_start(&start);
+                qsort(array, arg->length, sizeof(long), long_compare);
+                timing_stop(&elapsed, &start);
+                if (0 > trace_add(trace, TRACE_RUN, 0, begin)) {
+                        return -1;
+                }
+                timing_reset(&start);
+                /*
+                 * Revert the unsorted version back into array
+                 * using the same seed: no new memory is allocated.
+                 */
+                if (0 > array_dist_generate(&array,
+                                            arg->length,
+                                            arg->seed,
+                                            arg->dist)) {
+                        return -1;
+                }
+                /* The warmup runs are not recorded at all. */
+                if (arg->warmup <= iteration) {
+                        moving_window_push(window, elapsed);
+                        result->sample[iteration - arg->warmup][PHASE_COUNT] =
+                                elapsed;
+                }
+                elapsed = .0;
+        }
+
+        if (0 > stats_calc(result->total,
+                           &(result->rejected[PHASE_COUNT]),
+                           window,
+                           arg)) {
+                return -1;
+        }
+
+        if (arg->cold) {
+                timing_flush_destroy(&flush);
+        }
+
+        if (arg->trace) {
+                if (0 > trace_write(trace, arg->trace_file, comm)) {
+                        return -1;
+                }
+                trace_destroy(&trace);
+        }
+
+        array_destroy(&array);
+        moving_window_destroy(&window);
+        return 0;
+}
+
+static void
+parallel_sort(struct sort_result *const result,
+              const struct cli_arg *const arg,
+              MPI_Comm comm)
+{
+        /*
+         * Sorting time per-phase; all the fields are filled regardless
+         * of the value of 'arg->phase'.
+         */
+        double sort_time[PHASE_COUNT];
+        double total_sort_time;
+        /*
+         * Sorting time per-sub-phase, recorded by every process on its own
+         * (as opposed to 'sort_time', which is only meaningful on root).
+         */
+        double lap[SUBPHASE_COUNT];
+        double lap_mean[SUBPHASE_COUNT];
+        double lap_sum[SUBPHASE_COUNT];
+        /* Time per-sub-phase of this process over all the measured runs. */
+        double lap_total[SUBPHASE_COUNT];
+        double merged_size = 0;
+        double mem_bound = 0;
+        int rank = 0;
+        /* Index of the measured run, which excludes the warmup runs. */
+        unsigned int i = 0U;
+        /* Number of elements to be processed per process. */
+        size_t chunk_size = (size_t)ceil((double)arg->length / arg->process);
+        /* Elements received at once in the memory-bounded mode. */
+        size_t chunk_limit = arg->mem_limit / sizeof(long);
+        size_t arena_size = 0U;
+        struct arena *arena = NULL;
+        struct trace *trace = NULL;
+        struct plan *plan = NULL;
+        struct timing_counter counter;
+        struct timing_flush flush;
+        /* Members shared by all the runs; the rest is set per run. */
+        struct process_arg process_info;
+        /*
+         * Hardware events per-phase, summed over all the runs; only
+         * filled in if 'arg->counter' is set.
+         */
+        double count[PHASE_COUNT][COUNTER_COUNT];
+        /*
+         * Memory per-phase, the largest over all the runs; only filled in
+         * if 'arg->memory' is set.
+         */
+        double memory[PHASE_COUNT][MEMORY_STAT_SIZE];
+        struct moving_window *phase_wdw[PHASE_COUNT];
+        struct moving_window *total_wdw = NULL;
+        struct moving_window *lap_wdw[SUBPHASE_COUNT];
+
+        memset(sort_time, 0, sizeof sort_time);
+        memset(lap, 0, sizeof lap);
+        memset(lap_total, 0, sizeof lap_total);
+        memset(count, 0, sizeof count);
+        memset(memory, 0, sizeof memory);
+        MPI_Comm_rank(comm, &rank);
+
+        /*
+         * The arena is sized once for the buffers of a whole run:
+         * the local block, the received partitions along with the 2 merge
+         * buffers (about n / p each when the load is balanced), samples and
+         * pivots (O(p^2) on root), and the 'part_blk' descriptors;
+         * root additionally holds the generated array and the final result.
+         *
+         * If the received partitions turn out to be larger than the
+         * estimate, the arena grows during the 1st run and keeps the larger
+         * size for all the following runs.
+         */
+        arena_size = sizeof(long) * (4U * chunk_size +\
+                                     (size_t)arg->process * arg->process +\
+                                     2U * arg->process) +\
+                     2U * (sizeof(struct part_blk) +\
+                           arg->process * sizeof(struct partition)) +\
+                     16U * ARENA_ALIGN;
+        if (0 == rank) {
+                arena_size += 2U * sizeof(long) * arg->length;
+        }
+
+        /*
+         * In the memory-bounded mode there are neither a receive buffer for
+         * all the partitions nor merge buffers: only the merged result
+         * (again about n / p) and a single chunk; root neither generates
+         * the whole array nor gathers the final result (see
+         * 'psort_launch'), so it needs no more than any other process.
+         */
+        if (INT_MAX < chunk_limit) {
+                chunk_limit = INT_MAX;
+        }
+        if (0U < chunk_limit) {
+                arena_size = sizeof(long) * (2U * chunk_size +\
+                                             (chunk_limit < chunk_size ?
+                                              chunk_limit : chunk_size) +\
+                                             (size_t)arg->process *
+                                             arg->process +\
+                                             2U * arg->process) +\
+                             2U * (sizeof(struct part_blk) +\
+                                   arg->process * sizeof(struct partition)) +\
+                             16U * ARENA_ALIGN;
+        }
+
+        if (0 > arena_init(&arena, arena_size)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        if (arg->counter) {
+                if (0 > timing_counter_init(&counter)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        if (arg->cold && 0 > timing_flush_init(&flush)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        /*
+         * A run records its phases, about 'p' barriers and messages in
+         * phase 3, and less than 'p' merges in phase 4; the trace grows
+         * by itself if the estimate is exceeded.
+         */
+        if (arg->trace) {
+                if (0 > trace_init(&trace,
+                                   (8U + 4U * arg->process) *
+                                   (arg->warmup + arg->run))) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        /*
+         * The requests are bound by the 1st run, warmup or not, and every
+         * other run merely starts them again; no process picks more than a
+         * regular sample per process.
+         */
+        if (arg->persistent &&
+            0 > plan_init(&plan, comm, arg->process)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        memset(&process_info, 0, sizeof(struct process_arg));
+        process_info.comm = comm;
+        process_info.arena = arena;
+        process_info.trace = trace;
+        process_info.counter = arg->counter ? &counter : NULL;
+        process_info.count = count;
+        process_info.memory = arg->memory ? memory : NULL;
+        process_info.chunk_limit = (int)chunk_limit;
+        process_info.plan = plan;
+
+        memset(phase_wdw, 0, sizeof phase_wdw);
+        memset(lap_wdw, 0, sizeof lap_wdw);
+
+        /*
+         * Initialize 4 parallel windows in order to calculate the
+         * statistics for each phase, along with the one for the total
+         * sorting time; all of them are recorded regardless of the value
+         * of 'arg->phase', since pushing a value is merely O(1).
+         */
+        for (int j = PHASE1; j < PHASE_COUNT; ++j) {
+                if (0 > moving_window_init(&(phase_wdw[j]), arg->window)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+        if (0 > moving_window_init(&total_wdw, arg->window)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        for (int j = SUB_SCATTER; j < SUBPHASE_COUNT; ++j) {
+                if (0 > moving_window_init(&(lap_wdw[j]), arg->window)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
+
+        /* Whatever an earlier case of a sweep accounted is dropped. */
+        comm_clear();
+        for (unsigned int k = 0; k < arg->warmup + arg->run; ++k) {
+                /*
+                 * Every process flushes its own caches, and 'psort_launch'
+                 * waits for all of them before the run starts.
+                 */
+                if (arg->cold && 0 > timing_flush(&flush)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+
+                /*
+                 * 'sort_time' always records sorting times per phase per run.
+                 */
+                psort_launch(sort_time, lap, arg, &process_info);
+
+                /* Every buffer of this run is given back at once. */
+                if (0 > arena_reset(arena)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+
+                /*
+                 * The warmup runs are not recorded at all; the hardware
+                 * events counted and the memory recorded during them are
+                 * dropped as well.
+                 */
+                if (k < arg->warmup) {
+                        memset(count, 0, sizeof count);
+                        memset(memory, 0, sizeof memory);
+                        comm_clear();
+                        MPI_Barrier(comm);
+                        continue;
+                }
+                i = k - arg->warmup;
+
+                total_sort_time = 0;
+                for (int j = PHASE1; j < PHASE_COUNT; ++j) {
+                        if (0 > moving_window_push(phase_wdw[j],
+                                                   sort_time[j])) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        result->sample[i][j] = sort_time[j];
+                        total_sort_time += sort_time[j];
+                }
+                result->sample[i][PHASE_COUNT] = total_sort_time;
+                if (0 > moving_window_push(total_wdw, total_sort_time)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                for (int j = SUB_SCATTER; j < SUBPHASE_COUNT; ++j) {
+                        if (0 > moving_window_push(lap_wdw[j], lap[j])) {
+                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        }
+                        lap_total[j] += lap[j];
+                }
+                MPI_Barrier(comm);
+        }
+
+        for (int j = PHASE1; j < PHASE_COUNT; ++j) {
+                if (0 > stats_calc(result->phase[j],
+                                   &(result->rejected[j]),
+                                   phase_wdw[j],
+                                   arg)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                moving_window_destroy(&(phase_wdw[j]));
+        }
+        if (0 > stats_calc(result->total,
+                           &(result->rejected[PHASE_COUNT]),
+                           total_wdw,
+                           arg)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        moving_window_destroy(&total_wdw);
+
+        if (arg->cold) {
+                timing_flush_destroy(&flush);
+        }
+
+        /*
+         * Each process reduces its own series of a sub-phase to a mean
+         * first, then the means are summarized across all the processes;
+         * the spread between 'RANK_MIN' and 'RANK_MAX' exposes the load
+         * imbalance and the time spent waiting for the slowest process.
+         */
+        for (int j = SUB_SCATTER; j < SUBPHASE_COUNT; ++j) {
+                if (0 > moving_average_calc(lap_wdw[j], &(lap_mean[j]))) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                moving_window_destroy(&(lap_wdw[j]));
+        }
+
+        for (int j = SUB_SCATTER; j < SUBPHASE_COUNT; ++j) {
+                MPI_Reduce(&(lap_mean[j]), &(result->subphase[j][RANK_MIN]),
+                           1, MPI_DOUBLE, MPI_MIN, 0, comm);
+                MPI_Reduce(&(lap_mean[j]), &(result->subphase[j][RANK_MAX]),
+                           1, MPI_DOUBLE, MPI_MAX, 0, comm);
+        }
+        MPI_Reduce(lap_mean, lap_sum, SUBPHASE_COUNT, MPI_DOUBLE, MPI_SUM,
+                   0, comm);
+
+        /* The partitions are the same in every run, so the last one does. */
+        merged_size = process_info.merged_size;
+        MPI_Reduce(&merged_size, &(result->load[RANK_MIN]), 1, MPI_DOUBLE,
+                   MPI_MIN, 0, comm);
+        MPI_Reduce(&merged_size, &(result->load[RANK_MAX]), 1, MPI_DOUBLE,
+                   MPI_MAX, 0, comm);
+        /* The elements are only moved around, so they always sum up to n. */
+        result->load[RANK_AVG] = (double)arg->length / arg->process;
+
+        /*
+         * The working memory of a process in the memory-bounded mode never
+         * exceeds its block of the input, the merged result, a single
+         * chunk, the samples and pivots, and the descriptors of the
+         * partitions, plus the alignment of the allocations; the largest
+         * over all the processes is reported.
+         */
+        result->mem_bound = 0;
+        if (0U < chunk_limit) {
+                mem_bound = sizeof(long) *\
+                            ((double)chunk_size +
+                             merged_size +
+                             (merged_size < chunk_limit ?
+                              merged_size : (double)chunk_limit) +
+                             (double)arg->process * arg->process +
+                             2.0 * arg->process) +
+                            2.0 * (sizeof(struct part_blk) +
+                                   arg->process * sizeof(struct partition)) +
+                            16.0 * ARENA_ALIGN;
+                MPI_Reduce(&mem_bound, &(result->mem_bound), 1, MPI_DOUBLE,
+                           MPI_MAX, 0, comm);
+        }
+
+        if (0 == rank) {
+                for (int j = SUB_SCATTER; j < SUBPHASE_COUNT; ++j) {
+                        result->subphase[j][RANK_AVG] = lap_sum[j] /\
+                                                        arg->process;
+                }
+        }
+
+        if (arg->counter) {
+                counter_reduce(result, count, counter.available, arg, comm);
+                timing_counter_destroy(&counter);
+        }
 
-        if (NULL == self) {
-                errno = EINVAL;
-                return -1;
+        if (arg->comm) {
+                comm_reduce(result, lap_total, arg, comm);
         }
 
-        blk = *self;
+        if (arg->memory) {
+                memory_reduce(result, memory, comm);
+        }
 
-        if (blk->clean) {
-                for (int i = 0; i < blk->size; ++i) {
-                        free(blk->part[i].head);
+        if (arg->trace) {
+                if (0 > trace_write(trace, arg->trace_file, comm)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
                 }
+                trace_destroy(&trace);
         }
 
-        free(blk);
-        *self = NULL;
+        if (arg->persistent) {
+                plan_destroy(&plan);
+        }
 
-        return 0;
+        arena_destroy(&arena);
 }
 
+/*
+ * Summarizes the hardware events per-phase per-run of every process into
+ * 'result' on root; a counter is only reported as available if it could be
+ * opened on all the processes.
+ */
 static void
-output_write(double data[const], const struct cli_arg *const arg)
+counter_reduce(struct sort_result *const result,
+               double count[const][COUNTER_COUNT],
+               const unsigned int available,
+               const struct cli_arg *const arg,
+               MPI_Comm comm)
 {
-        if (NULL == data || NULL == arg) {
+        double reduced[RANK_STAT_SIZE][PHASE_COUNT][COUNTER_COUNT];
+        const MPI_Op OP[RANK_STAT_SIZE] = {
+                [RANK_MIN] = MPI_MIN, [RANK_AVG] = MPI_SUM, [RANK_MAX] = MPI_MAX
+        };
+
+        if (NULL == result || NULL == count || NULL == arg) {
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        if (1 == arg->process) {
-                if (arg->binary) {
-                        fwrite(data, sizeof(data[0]), SORT_STAT_SIZE, stdout);
-                } else {
-                        puts("Mean Sorting Time, Standard Deviation");
-                        printf("%f, %f\n", data[MEAN], data[STDEV]);
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                for (int j = COUNTER_CYCLES; j < COUNTER_COUNT; ++j) {
+                        count[i][j] /= arg->run;
                 }
-        } else if (1 < arg->process) {
-                if (arg->binary) {
-                        /* There are 4 elements for the per-phased data. */
-                        if (arg->phase) {
-                                fwrite(data,
-                                       sizeof(data[0]),
-                                       PHASE_COUNT,
-                                       stdout);
-                        } else {
-                                fwrite(data,
-                                       sizeof(data[0]),
-                                       SORT_STAT_SIZE,
-                                       stdout);
-                        }
-                } else {
-                        /* There are 4 elements for the per-phased data. */
-                        if (arg->phase) {
-                                puts("Phase 1, Phase 2, Phase 3, Phase 4");
-                                printf("%f, %f, %f, %f\n",
-                                       data[PHASE1],
-                                       data[PHASE2],
-                                       data[PHASE3],
-                                       data[PHASE4]);
-                        } else {
-                                puts("Mean Sorting Time, Standard Deviation");
-                                printf("%f, %f\n", data[MEAN], data[STDEV]);
+        }
+
+        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                MPI_Reduce(count, reduced[k], PHASE_COUNT * COUNTER_COUNT,
+                           MPI_DOUBLE, OP[k], 0, comm);
+        }
+        MPI_Reduce(&available, &(result->counter_available), 1,
+                   MPI_UNSIGNED, MPI_BAND, 0, comm);
+
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                for (int j = COUNTER_CYCLES; j < COUNTER_COUNT; ++j) {
+                        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                                result->counter[i][j][k] = reduced[k][i][j];
                         }
+                        result->counter[i][j][RANK_AVG] /= arg->process;
                 }
         }
 }
 
-static int
-sequential_sort(double ssort_stats[const], const struct cli_arg *const arg)
+/*
+ * Summarizes the memory per-phase of every process into 'result' on root.
+ */
+static void
+memory_reduce(struct sort_result *const result,
+              double memory[const][MEMORY_STAT_SIZE],
+              MPI_Comm comm)
 {
-        double elapsed = 0, one_process_avg = 0, one_process_stdev = 0;
-        long *array = NULL;
-        struct timespec start;
-        struct moving_window *window = NULL;
-
-        if (NULL == ssort_stats || NULL == arg) {
-                errno = EINVAL;
-                return -1;
-        }
+        int size = 0;
+        double reduced[RANK_STAT_SIZE][PHASE_COUNT][MEMORY_STAT_SIZE];
+        const MPI_Op OP[RANK_STAT_SIZE] = {
+                [RANK_MIN] = MPI_MIN, [RANK_AVG] = MPI_SUM, [RANK_MAX] = MPI_MAX
+        };
 
-        if (0 > moving_window_init(&window, arg->window)) {
-                return -1;
+        if (NULL == result || NULL == memory) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        if (0 > array_generate(&array, arg->length, arg->seed)) {
-                return -1;
+        MPI_Comm_size(comm, &size);
+        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                MPI_Reduce(memory, reduced[k],
+                           PHASE_COUNT * MEMORY_STAT_SIZE,
+                           MPI_DOUBLE, OP[k], 0, comm);
         }
 
-        timing_reset(&start);
-        /*
-         * If the number of threads needs to be executed is 1, pthread APIs
-         * need not to be invoked.
-         */
-        for (size_t iteration = 0U; iteration < arg->run; ++iteration) {
-                timing_start(&start);
-                qsort(array, arg->length, sizeof(long), long_compare);
-                timing_stop(&elapsed, &start);
-                timing_reset(&start);
-                /*
-                 * Revert the unsorted version back into array
-                 * using the same seed: no new memory is allocated.
-                 */
-                if (0 > array_generate(&array, arg->length, arg->seed)) {
-                        return -1;
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                for (int j = MEMORY_ALLOCATED; j < MEMORY_STAT_SIZE; ++j) {
+                        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                                result->memory[i][j][k] = reduced[k][i][j];
+                        }
+                        result->memory[i][j][RANK_AVG] /= size;
                 }
-                moving_window_push(window, elapsed);
-                elapsed = .0;
         }
+}
 
-        if (0 > moving_average_calc(window, &one_process_avg)) {
-                return -1;
+/*
+ * Summarizes the MPI calls per-phase per-run of every process, as
+ * accounted by the PMPI layer, into 'result' on root; 'lap_total' is the
+ * time of each sub-phase of this process over all the measured runs, which
+ * the time within the MPI calls of the same runs is a share of.
+ */
+static void
+comm_reduce(struct sort_result *const result,
+            const double lap_total[const],
+            const struct cli_arg *const arg,
+            MPI_Comm comm)
+{
+#ifdef PSRS_PMPI
+        /* The phase each sub-phase belongs to. */
+        static const int SUBPHASE_PHASE[SUBPHASE_COUNT] = {
+                [SUB_SCATTER]       = PHASE1,
+                [SUB_LOCAL_SORT]    = PHASE1,
+                [SUB_SAMPLING]      = PHASE1,
+                [SUB_GATHER]        = PHASE2,
+                [SUB_PIVOT]         = PHASE2,
+                [SUB_PARTITION]     = PHASE2,
+                [SUB_EXCHANGE]      = PHASE3,
+                [SUB_MERGE]         = PHASE4,
+                [SUB_RESULT_GATHER] = PHASE4
+        };
+        double count[PHASE_COUNT][COMM_FUNC_COUNT][COMM_STAT_SIZE];
+        double reduced[RANK_STAT_SIZE][PHASE_COUNT][COMM_FUNC_COUNT]
+                      [COMM_STAT_SIZE];
+        double busy[PHASE_COUNT];
+        double share[PHASE_COUNT];
+        const MPI_Op OP[RANK_STAT_SIZE] = {
+                [RANK_MIN] = MPI_MIN, [RANK_AVG] = MPI_SUM, [RANK_MAX] = MPI_MAX
+        };
+
+        if (NULL == result || NULL == lap_total || NULL == arg) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        if (0 > moving_stdev_calc(window, &one_process_stdev)) {
-                return -1;
+        if (0 > comm_read(count, PHASE_COUNT)) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        array_destroy(&array);
-        moving_window_destroy(&window);
-
-        ssort_stats[MEAN] = one_process_avg;
-        ssort_stats[STDEV] = one_process_stdev;
-        return 0;
-}
-
-static void
-parallel_sort(double psort_stats[const], const struct cli_arg *const arg)
-{
         /*
-         * Sorting time per-phase; all the fields are filled regardless
-         * of the value of 'arg->phase'.
+         * Both the time within the MPI calls and the time of the phase are
+         * those of this process over the same runs; the barriers are left
+         * out of either, since they synchronize the phases for the sake of
+         * timing them rather than move any data (they are still accounted
+         * on their own as 'MPI_Barrier').
          */
-        double sort_time[PHASE_COUNT];
-        double total_sort_time;
-        struct moving_window *phase_wdw[PHASE_COUNT];
-        struct moving_window *total_wdw = NULL;
-
-        memset(sort_time, 0, sizeof sort_time);
-
-        if (arg->phase) {
-                memset(phase_wdw, 0, sizeof phase_wdw);
-
-                /*
-                 * Initialize 4 parallel windows in order to calculate the
-                 * moving average for each phase.
-                 */
-                for (int j = PHASE1; j < PHASE_COUNT; ++j) {
-                        if (0 > moving_window_init(&(phase_wdw[j]),
-                                                   arg->window)) {
-                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        memset(busy, 0, sizeof busy);
+        memset(share, 0, sizeof share);
+        for (int j = SUB_SCATTER; j < SUBPHASE_COUNT; ++j) {
+                busy[SUBPHASE_PHASE[j]] += lap_total[j];
+        }
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                        if (COMM_BARRIER != j && 0 < busy[i]) {
+                                share[i] += count[i][j][COMM_TIME] /
+                                            busy[i] * 100;
                         }
                 }
-        } else {
-                if (0 > moving_window_init(&total_wdw, arg->window)) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                        for (int s = COMM_CALLS; s < COMM_STAT_SIZE; ++s) {
+                                count[i][j][s] /= arg->run;
+                        }
                 }
         }
 
-        for (unsigned int i = 0; i < arg->run; ++i) {
-                /*
-                 * 'sort_time' always records sorting times per phase per run.
-                 */
-                psort_launch(sort_time, arg);
+        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                MPI_Reduce(count, reduced[k],
+                           PHASE_COUNT * COMM_FUNC_COUNT * COMM_STAT_SIZE,
+                           MPI_DOUBLE, OP[k], 0, comm);
+        }
 
-                if (arg->phase) {
-                        for (int j = PHASE1; j < PHASE_COUNT; ++j) {
-                                if (0 > moving_window_push(phase_wdw[j],
-                                                           sort_time[j])) {
-                                        MPI_Abort(MPI_COMM_WORLD,
-                                                  EXIT_FAILURE);
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                for (int j = COMM_SEND; j < COMM_FUNC_COUNT; ++j) {
+                        for (int s = COMM_CALLS; s < COMM_STAT_SIZE; ++s) {
+                                for (int k = RANK_MIN;
+                                     k < RANK_STAT_SIZE;
+                                     ++k) {
+                                        result->comm[i][j][s][k] =
+                                                reduced[k][i][j][s];
                                 }
-                        }
-                } else {
-                        total_sort_time = 0;
-                        for (int j = 0; j < PHASE_COUNT; ++j) {
-                                total_sort_time += sort_time[j];
-                        }
-                        /*
-                         * If 'arg->phase' is 'false', a moving average based
-                         * on a series of total sorting time can be calculated.
-                         */
-                        if (0 > moving_window_push(total_wdw,
-                                                   total_sort_time)) {
-                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                                result->comm[i][j][s][RANK_AVG] /=
+                                        arg->process;
                         }
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
         }
 
-        /*
-         * NOTE:
-         * The size of 'psort_stats' differs depends on whether 'arg->phase'
-         * is set to 'true'.
-         */
-        if (arg->phase) {
-                for (int j = PHASE1; j < PHASE_COUNT; ++j) {
-                        if (0 > moving_average_calc(phase_wdw[j],
-                                                    &(psort_stats[j]))) {
-                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                        }
-                        moving_window_destroy(&(phase_wdw[j]));
-                }
-        } else {
-                if (0 > moving_average_calc(total_wdw, &(psort_stats[MEAN]))) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
-                if (0 > moving_stdev_calc(total_wdw, &(psort_stats[STDEV]))) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        for (int k = RANK_MIN; k < RANK_STAT_SIZE; ++k) {
+                MPI_Reduce(share, busy, PHASE_COUNT, MPI_DOUBLE, OP[k],
+                           0, comm);
+                for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                        result->comm_share[i][k] = busy[i];
                 }
-                moving_window_destroy(&total_wdw);
         }
+        for (int i = PHASE1; i < PHASE_COUNT; ++i) {
+                result->comm_share[i][RANK_AVG] /= arg->process;
+        }
+#else
+        /* Rejected by 'argument_parse' in the first place. */
+        (void)result;
+        (void)lap_total;
+        (void)arg;
+        (void)comm;
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+#endif
 }
 
 static void
-psort_launch(double elapsed[const], const struct cli_arg *const arg)
+psort_launch(double elapsed[const],
+             double lap[const],
+             const struct cli_arg *const arg,
+             struct process_arg *const process)
 {
         long *array = NULL;
+        struct arena *arena = NULL;
         /* Number of elements to be processed per process. */
         int chunk_size = (int)ceil((double)arg->length / arg->process);
         struct process_arg process_info;
 
-        if (NULL == elapsed || NULL == arg) {
+        if (NULL == elapsed || NULL == lap || NULL == arg || NULL == process ||
+            NULL == process->arena) {
                 errno = EINVAL;
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        /* Initialize the 'process_info' for each process. */
-        memset(&process_info, 0, sizeof(struct process_arg));
-        MPI_Comm_rank(MPI_COMM_WORLD, &(process_info.id));
+        /*
+         * Initialize the 'process_info' for each process; the arena and
+         * instrumentation members are set up by the caller once for all
+         * the runs and are left untouched.
+         */
+        process_info = *process;
+        arena = process_info.arena;
+        MPI_Comm_rank(process_info.comm, &(process_info.id));
+        process_info.head = NULL;
+        process_info.size = 0;
+        process_info.max_sample_size = 0;
+        process_info.merged_size = 0;
         process_info.total_size = arg->length;
         process_info.process = arg->process;
+        process_info.barrier = arg->barrier;
 
         if (0 == process_info.id) {
                 process_info.root = true;
@@ -351,9 +2842,23 @@ psort_launch(double elapsed[const], const struct cli_arg *const arg)
                 process_info.root = false;
         }
 
-        /* Only the root process needs to generate the array. */
-        if (process_info.root) {
-                if (0 > array_generate(&array, arg->length, arg->seed)) {
+        /*
+         * Only the root process needs to generate the array, except in the
+         * memory-bounded mode (see below).
+         *
+         * NOTE: 'array_dist_generate' fills the memory in place since
+         * 'array' is no longer 'NULL' at this point.
+         */
+        if (process_info.root && 0 >= process_info.chunk_limit) {
+                if (0 > arena_alloc(arena,
+                                    (void **)&array,
+                                    sizeof(long) * arg->length)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                if (0 > array_dist_generate(&array,
+                                    arg->length,
+                                    arg->seed,
+                                    arg->dist)) {
                         MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
                 }
 #if 0
@@ -372,7 +2877,7 @@ psort_launch(double elapsed[const], const struct cli_arg *const arg)
          * Every other process waits for the root until array generation is
          * complete.
          */
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(process_info.comm);
 
         /*
          * For all the processes other than the last, the size of the array
@@ -397,24 +2902,76 @@ psort_launch(double elapsed[const], const struct cli_arg *const arg)
                 }
         }
 
-        psort_start(elapsed, array, &process_info);
+        /*
+         * In the memory-bounded mode root does not hold the whole array:
+         * every process generates its own block of the same input, and
+         * keeps its part of the result as 'psrs_sort' does, so root needs
+         * no more memory than any other process.
+         */
+        if (0 < process_info.chunk_limit) {
+                process_info.distributed = true;
+                process_info.max_sample_size =
+                        0 != (arg->length % chunk_size) ?
+                        (int)(arg->length % chunk_size) : arg->process;
+                if (0 > arena_alloc(arena,
+                                    (void **)&(process_info.head),
+                                    sizeof(long) * process_info.size) ||
+                    0 > array_dist_slice_generate(process_info.head,
+                                                  (size_t)chunk_size *
+                                                  process_info.id,
+                                                  process_info.size,
+                                                  arg->length,
+                                                  arg->seed,
+                                                  arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+        }
 
-        if (process_info.root) {
+        psort_start(elapsed, lap, array, &process_info);
+#ifdef PRINT_DEBUG_INFO
+        /* The result stays on the processes, so root regenerates the input. */
+        if (process_info.distributed) {
+                if (process_info.root &&
+                    0 > array_dist_generate(&array,
+                                            arg->length,
+                                            arg->seed,
+                                            arg->dist)) {
+                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                }
+                array_check(process_info.merged,
+                            process_info.merged_size,
+                            array,
+                            arg->length,
+                            process_info.comm);
                 array_destroy(&array);
         }
+#endif
+        *process = process_info;
 }
 
-static void
+void
 psort_start(double elapsed[const],
+            double lap[const],
             long array[const],
             struct process_arg *const arg)
 {
+        /* Times the phases on root only. */
         struct timespec start;
+        /* Times the sub-phases on every process. */
+        struct timespec lap_start;
+        /* Time spent in the barriers since 'lap_start'. */
+        double barrier_wait = 0;
+        /* Beginning of the run and the current phase for 'arg->trace'. */
+        double run_begin = 0;
+        double phase_begin = 0;
 
         /* Phase 1 Result */
         struct partition local_samples;
 
-        /* Phase 2.1 - 2.2 Result */
+        /* Phase 2.1 Result */
+        struct partition total_samples;
+
+        /* Phase 2.2 Result */
         struct partition pivots;
 
         /* Phase 2.3 Result */
@@ -424,71 +2981,121 @@ psort_start(double elapsed[const],
         /* Phase 3 Result */
         struct part_blk *blk_copy = NULL;
 
-        /* Phase 4 Result */
+        /* Phase 4.1 Result */
+        struct partition merged;
+
+        /* Phase 4.2 Result */
         struct partition result;
         /*
          * NOTE:
-         * If any single process fails, the whole progress group identified
-         * by 'MPI_COMM_WORLD' communicator would abort.
+         * If any single process fails, the processes of 'arg->comm' abort,
+         * rather than all of 'MPI_COMM_WORLD', which a caller of 'libpsrs'
+         * may never have handed over.
          *
-         * This implementaion does not fully handle the case where the
-         * 'arg->total_size' of the array is not fully divisible by
-         * 'arg->process' since 'MPI_Gather' would access out of bound
-         * memory region for the last process with maximum rank.
+         * With 'arg->distributed' set (see 'psrs_sort'), every process
+         * starts off with its own block in 'arg->head' rather than having
+         * it scattered from 'array', and keeps its part of the result in
+         * 'arg->merged' rather than having it gathered to root.
          */
 
+        /*
+         * Every process starts at the same time regardless of whether
+         * 'arg->barrier' is set, so the first sub-phase is not charged for
+         * the time it takes root to generate the array.
+         */
         timing_reset(&start);
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(arg->comm);
 
         if (arg->root) {
                 timing_start(&start);
         }
+        arg->barrier_wait = &barrier_wait;
+        timing_start(&lap_start);
+        run_begin = MPI_Wtime();
+        phase_begin = run_begin;
+        counter_begin(arg);
+        memory_begin(arg);
+        comm_mark(arg->comm, PHASE1);
 
         /*
          * Phase 1.1
          *
          * Scatter the generated 'array' to each process from root.
          */
-        local_scatter(array, arg);
+        if (!arg->distributed) {
+                local_scatter(array, arg);
+        }
+        subphase_lap(&(lap[SUB_SCATTER]), &lap_start, &barrier_wait);
         /*
          * Phase 1.2
          *
+         * Sort the scattered sub-array in place.
+         */
+        local_sort(arg);
+        subphase_lap(&(lap[SUB_LOCAL_SORT]), &lap_start, &barrier_wait);
+        /*
+         * Phase 1.3
+         *
          * Local regular samples of all process are written into
          * 'local_samples' structure.
          *
-         * NOTE: Ownership of 'local_samples.head' is transferred back to
-         * this function first, then to 'pivots_bcast' later.
+         * NOTE: 'local_samples.head' is allocated from 'arg->arena', like
+         * every other buffer below; none of them is freed individually.
          */
-        local_sort(&local_samples, arg);
+        local_sample(&local_samples, arg);
+        subphase_lap(&(lap[SUB_SAMPLING]), &lap_start, &barrier_wait);
+        counter_end(arg, PHASE1);
+        memory_end(arg, PHASE1);
+        trace_record(arg, TRACE_PHASE1, 0, phase_begin);
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
         if (arg->root) {
                 timing_stop(&(elapsed[PHASE1]), &start);
                 timing_reset(&start);
                 timing_start(&start);
         }
+        /*
+         * The wait in the barrier between the phases is not charged to any
+         * sub-phase, nor is that in the barriers within them (see
+         * 'subphase_lap').
+         */
+        timing_start(&lap_start);
+        barrier_wait = 0;
+        phase_begin = MPI_Wtime();
+        counter_begin(arg);
+        /* The barrier above is charged to the MPI calls of phase 1. */
+        comm_mark(arg->comm, PHASE2);
 
         /*
          * Phase 2 - Find Pivots then Partition.
          */
 
         /*
-         * Phase 2.1 - 2.2
+         * Phase 2.1
          *
          * Given 'local_samples' from each process, forms 'total_samples'
-         * and picks, broadcasts 'pivots' to all processes.
+         * on root.
+         */
+        samples_gather(&total_samples, &local_samples, arg);
+        subphase_lap(&(lap[SUB_GATHER]), &lap_start, &barrier_wait);
+
+        /*
+         * Phase 2.2
+         *
+         * Root picks 'pivots' from 'total_samples' and broadcasts them to
+         * all processes.
          *
-         * NOTE: Ownership of 'pivots.head' is transferred back to
-         * this function.
+         * NOTE: 'pivots.head' is handed back to this function.
          */
-        pivots_bcast(&pivots, &local_samples, arg);
+        pivots_bcast(&pivots, &total_samples, arg);
+        subphase_lap(&(lap[SUB_PIVOT]), &lap_start, &barrier_wait);
 
         /*
          * Abort if the total number of pivots is not 1 less than the total
          * number of processes.
          */
         if (arg->process != pivots.size + 1) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                MPI_Abort(arg->comm, EXIT_FAILURE);
         }
 
         /* Phase 2.3
@@ -496,69 +3103,103 @@ psort_start(double elapsed[const],
          * Each process receives a copy of the 'pivots' and forms p partitions
          * from their sorted local blocks.
          *
-         * NOTE: 'blk' temporarily lends to 'partition_form', the ownership
-         * is not transferred; but the ownership of 'pivots.head' is
-         * transferred because 'pivots.head' is not needed after this phase.
+         * NOTE: 'blk' temporarily lends to 'partition_form';
+         * 'pivots.head' is not needed after this phase.
          */
-        if (0 > part_blk_init(&blk, false, pivots.size + 1)) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        if (0 > part_blk_init(&blk, arg->arena, pivots.size + 1)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
         }
         partition_form(blk, &pivots, arg);
+        subphase_lap(&(lap[SUB_PARTITION]), &lap_start, &barrier_wait);
+        counter_end(arg, PHASE2);
+        memory_end(arg, PHASE2);
+        trace_record(arg, TRACE_PHASE2, 0, phase_begin);
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
         if (arg->root) {
                 timing_stop(&(elapsed[PHASE2]), &start);
                 timing_reset(&start);
                 timing_start(&start);
         }
+        timing_start(&lap_start);
+        barrier_wait = 0;
+        phase_begin = MPI_Wtime();
+        counter_begin(arg);
+        comm_mark(arg->comm, PHASE3);
         /*
          * Phase 3 - Exchange Partitions
          *
          * Each processor i keeps the i-th partition for itself and assigns
          * the j-th partition to the j-th processor.
          *
-         * In this implementation each thread does not distinguish between
-         * partitions from others and the partition belong to itself:
-         * the 'part' member is filled by the last step of previous phase,
+         * The 'part' member is filled by the last step of previous phase,
          * which merely records the beginning addresses and size for each
-         * partition and no copy is involved.
+         * partition and no copy is involved; the i-th partition is kept
+         * in place in 'arg->head' while all the others are received into
+         * one contiguous buffer.
          *
          * NOTE:
-         * Ownership of 'blk' is transferred to 'partition_exchange'
-         * function; the partition copies would be written into 'blk_copy'
-         * structure after the function returns; the initial sorted local
-         * array stored in 'arg->head' is no longer needed for each process
-         * after the partition exchange is done, so its ownership is hand
-         * over to 'partition_exchange' as well.
+         * The partition copies would be written into 'blk_copy'
+         * structure after the function returns; 'blk' is not needed
+         * after the partition exchange is done.
          */
-        if (0 > part_blk_init(&blk_copy, true, pivots.size + 1)) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        if (0 > part_blk_init(&blk_copy, arg->arena, pivots.size + 1)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
         }
         partition_exchange(blk_copy, blk, arg);
+        subphase_lap(&(lap[SUB_EXCHANGE]), &lap_start, &barrier_wait);
+        counter_end(arg, PHASE3);
+        memory_end(arg, PHASE3);
+        trace_record(arg, TRACE_PHASE3, 0, phase_begin);
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
         if (arg->root) {
                 timing_stop(&(elapsed[PHASE3]), &start);
                 timing_reset(&start);
                 timing_start(&start);
         }
+        timing_start(&lap_start);
+        barrier_wait = 0;
+        phase_begin = MPI_Wtime();
+        counter_begin(arg);
+        comm_mark(arg->comm, PHASE4);
         /*
-         * Phase 4 - Merge Partitions
+         * Phase 4.1 - Merge Partitions
          *
-         * NOTE: Ownership of 'blk_copy' is transferred to 'partition_merge'
-         * function while ownership of 'result.head' is transferred back
-         * from it for the ROOT process ONLY.
+         * NOTE: 'merged.head' lives in 'arg->arena' until the end of this
+         * run.
          */
-        partition_merge(&result, blk_copy, arg);
-
-        MPI_Barrier(MPI_COMM_WORLD);
+        partition_merge(&merged, blk_copy, arg);
+        subphase_lap(&(lap[SUB_MERGE]), &lap_start, &barrier_wait);
+        arg->merged = merged.head;
+        arg->merged_size = merged.size;
+        /*
+         * Phase 4.2 - Gather Merged Partitions
+         *
+         * NOTE: 'result.head' is only filled in for the ROOT process.
+         */
+        if (!arg->distributed) {
+                result_gather(&result, &merged, arg);
+        }
+        subphase_lap(&(lap[SUB_RESULT_GATHER]), &lap_start, &barrier_wait);
+        counter_end(arg, PHASE4);
+        memory_end(arg, PHASE4);
+        trace_record(arg, TRACE_PHASE4, 0, phase_begin);
+
+        phase_barrier(arg);
+        /* 'barrier_wait' is gone once this returns. */
+        arg->barrier_wait = NULL;
+        comm_mark(arg->comm, COMM_PHASE_NONE);
+        trace_record(arg, TRACE_RUN, 0, run_begin);
         /* End */
         if (arg->root) {
                 timing_stop(&(elapsed[PHASE4]), &start);
+        }
 #ifdef PRINT_DEBUG_INFO
-                puts("\n------------------------------");
-                puts("Phase 5: Result Verification");
-                puts("\n------------------------------");
+        if (arg->root && !arg->distributed) {
+                fputs("\n------------------------------\n", stderr);
+                fputs("Phase 5: Result Verification\n", stderr);
+                fputs("\n------------------------------\n", stderr);
                 long *cmp = calloc(arg->total_size, sizeof(long));
                 memcpy(cmp, result.head, arg->total_size * sizeof(long));
                 qsort(cmp, arg->total_size, sizeof(long), long_compare);
@@ -570,8 +3211,8 @@ psort_start(double elapsed[const],
 #endif
                 if (0 !=
                     memcmp(cmp, result.head, arg->total_size * sizeof(long))) {
-                        puts("The Result is Wrong!");
-                        puts("------------------------------");
+                        fputs("The Result is Wrong!\n", stderr);
+                        fputs("------------------------------\n", stderr);
 
 #if 0
                         puts("Correct Sorted List:");
@@ -586,14 +3227,13 @@ psort_start(double elapsed[const],
                         puts("");
 #endif
                 } else {
-                        puts("The Result is Right!");
-                        puts("------------------------------");
+                        fputs("The Result is Right!\n", stderr);
+                        fputs("------------------------------\n", stderr);
                 }
                 free(cmp);
-#endif
-                free(result.head);
         }
-        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        MPI_Barrier(arg->comm);
 }
 
 /* ------------------------------- Phase 1.1 ------------------------------- */
@@ -610,12 +3250,14 @@ local_scatter(long array[const], struct process_arg *const arg)
         }
         /*
          * Each process allocate the memory needed to store the sub-array.
-         *
-         * NOTE: Ownership is transferred back to caller.
          */
-        arg->head = (long *)calloc(arg->size, sizeof(long));
+        if (0 > arena_alloc(arg->arena,
+                            (void **)&(arg->head),
+                            sizeof(long) * arg->size)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
+        }
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
 
         /*
          * Last process broadcast the 'max_sample_size' member to every
@@ -625,9 +3267,9 @@ local_scatter(long array[const], struct process_arg *const arg)
                   1,
                   MPI_INT,
                   arg->process - 1,
-                  MPI_COMM_WORLD);
+                  arg->comm);
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
 
         /* Scatter the sub-array to each process. */
         MPI_Scatter(array,
@@ -637,7 +3279,7 @@ local_scatter(long array[const], struct process_arg *const arg)
                     arg->size,
                     MPI_LONG,
                     0,
-                    MPI_COMM_WORLD);
+                    arg->comm);
 
 #if 0
         puts("\n------------------------------");
@@ -651,63 +3293,62 @@ local_scatter(long array[const], struct process_arg *const arg)
                         }
                         puts("\n------------------------------");
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(arg->comm);
         }
 #endif
 }
 /* ------------------------------- Phase 1.1 ------------------------------- */
 
 /* ------------------------------- Phase 1.2 ------------------------------- */
-static void
-local_sort(struct partition *const local_samples,
-           const struct process_arg *const arg)
+void
+local_sort(const struct process_arg *const arg)
+{
+        /* Sort disjoint local data. */
+        qsort(arg->head, arg->size, sizeof(long), long_compare);
+}
+/* ------------------------------- Phase 1.2 ------------------------------- */
+
+/* ------------------------------- Phase 1.3 ------------------------------- */
+void
+local_sample(struct partition *const local_samples,
+             const struct process_arg *const arg)
 {
-        /* w = n / p^2 */
-        int window = arg->total_size / (arg->process * arg->process);
-        struct list *local_sample_list = NULL;
+        /*
+         * w = n / p^2, where the block of this process is n / p long;
+         * since the blocks given to 'psrs_sort' need not be equal, the
+         * window is taken from the actual size of the block.
+         */
+        int window = arg->size / arg->process;
 
         memset(local_samples, 0, sizeof(struct partition));
 
-        /* 1.1 Sort disjoint local data. */
-        qsort(arg->head, arg->size, sizeof(long), long_compare);
-        /* 1.2 Begin regular sampling load balancing heuristic. */
-        if (0 > list_init(&local_sample_list)) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        /*
+         * Begin regular sampling load balancing heuristic.
+         *
+         * At most 'max_sample_size' samples are picked, so the samples are
+         * written straight into a buffer of that size.
+         */
+        if (0 > arena_alloc(arg->arena,
+                            (void **)&(local_samples->head),
+                            sizeof(long) * arg->max_sample_size)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
         }
 
-        for (int idx = 0, picked = 0;
-             idx < arg->size && picked < arg->max_sample_size;
-             idx += window, ++picked) {
-                if (0 > list_add(local_sample_list, arg->head[idx])) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
+        for (int idx = 0;
+             idx < arg->size && local_samples->size < arg->max_sample_size;
+             idx += window) {
+                local_samples->head[local_samples->size++] = arg->head[idx];
                 if (0U == window) {
                         break;
                 }
         }
-        local_samples->size = (int)local_sample_list->size;
-        /* Ownership is transferred back to caller. */
-        local_samples->head = (long *)calloc(local_samples->size,
-                                             sizeof(long));
-
-        if (NULL == local_samples) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
-
-        if (0 > list_copy(local_sample_list, local_samples->head)) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
-
-        if (0 > list_destroy(&local_sample_list)) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
 
         /* Wait until all processes finish writing their own samples. */
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
 
 #if 0
         puts("\n------------------------------");
-        puts("Phase 1.2: Sorting Local Samples");
+        puts("Phase 1.3: Sorting Local Samples");
         puts("\n------------------------------");
         for (int i = 0; i < arg->process; ++i) {
                 if (i == arg->id) {
@@ -717,61 +3358,86 @@ local_sort(struct partition *const local_samples,
                         }
                         puts("\n------------------------------");
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(arg->comm);
         }
 #endif
 }
-/* ------------------------------- Phase 1.2 ------------------------------- */
+/* ------------------------------- Phase 1.3 ------------------------------- */
 
-/* ---------------------------- Phase 2.1 - 2.2 ---------------------------- */
+/* ------------------------------- Phase 2.1 ------------------------------- */
 static void
-pivots_bcast(struct partition *const pivots,
-             struct partition *const local_samples,
-             const struct process_arg *const arg)
+samples_gather(struct partition *const total_samples,
+               struct partition *const local_samples,
+               const struct process_arg *const arg)
 {
-        /* ρ (rho) = floor(p / 2) */
-        int pivot_step = 0;
-        struct list *pivot_list = NULL;
-        struct partition total_samples;
+        /* Number of samples of each process and where they go; root only. */
+        int *sample_size = NULL;
+        int *sample_displ = NULL;
 
-        if (NULL == pivots || NULL == local_samples || NULL == arg) {
+        if (NULL == total_samples || NULL == local_samples || NULL == arg) {
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        pivot_step = arg->process / 2;
-        memset(pivots, 0, sizeof(struct partition));
-        memset(&total_samples, 0, sizeof(struct partition));
+        if (NULL != arg->plan) {
+                phase_barrier(arg);
+                if (0 > plan_gather(arg->plan, total_samples, local_samples)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+                local_samples->head = NULL;
+                return;
+        }
+
+        memset(total_samples, 0, sizeof(struct partition));
+
+        /*
+         * The processes may pick different numbers of samples (a block
+         * smaller than 'arg->process' yields fewer of them), so root
+         * collects how many each one sends first.
+         */
+        if (arg->root) {
+                if (0 > arena_alloc(arg->arena,
+                                    (void **)&sample_size,
+                                    sizeof(int) * arg->process) ||
+                    0 > arena_alloc(arg->arena,
+                                    (void **)&sample_displ,
+                                    sizeof(int) * arg->process)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+        }
 
-        MPI_Reduce(&(local_samples->size),
-                   &(total_samples.size),
+        MPI_Gather(&(local_samples->size),
+                   1,
+                   MPI_INT,
+                   sample_size,
                    1,
                    MPI_INT,
-                   MPI_SUM,
                    0,
-                   MPI_COMM_WORLD);
+                   arg->comm);
 
         if (arg->root) {
-                /*
-                 * Use calloc instead of malloc to silence the "conditional
-                 * jump based on uninitialized heap variable" warning
-                 * coming from valgrind.
-                 */
-                total_samples.head = (long *)calloc(total_samples.size,
-                                                    sizeof(long));
+                for (int i = 0; i < arg->process; ++i) {
+                        sample_displ[i] = total_samples->size;
+                        total_samples->size += sample_size[i];
+                }
+                if (0 > arena_alloc(arg->arena,
+                                    (void **)&(total_samples->head),
+                                    sizeof(long) * total_samples->size)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
         }
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
         /* Gather local samples into the root process. */
-        MPI_Gather(local_samples->head,
-                   local_samples->size,
-                   MPI_LONG,
-                   total_samples.head,
-                   local_samples->size,
-                   MPI_LONG,
-                   0,
-                   MPI_COMM_WORLD);
+        MPI_Gatherv(local_samples->head,
+                    local_samples->size,
+                    MPI_LONG,
+                    total_samples->head,
+                    sample_size,
+                    sample_displ,
+                    MPI_LONG,
+                    0,
+                    arg->comm);
         /* Samples from each individual process are no longer needed. */
-        free(local_samples->head);
         local_samples->head = NULL;
 
 #if 0
@@ -780,52 +3446,87 @@ pivots_bcast(struct partition *const pivots,
         puts("\n------------------------------");
         if (arg->root) {
                 puts("Gathered samples from Root");
-                for (int j = 0; j < total_samples.size; ++j) {
-                        printf("%ld\t", total_samples.head[j]);
+                for (int j = 0; j < total_samples->size; ++j) {
+                        printf("%ld\t", total_samples->head[j]);
                 }
                 puts("\n------------------------------");
         }
 #endif
+}
+/* ------------------------------- Phase 2.1 ------------------------------- */
 
-        /* 2.1 Sort the collected samples. */
-        if (arg->root) {
-                if (0 > list_init(&pivot_list)) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
-                qsort(total_samples.head,
-                      total_samples.size,
-                      sizeof(long),
-                      long_compare);
-                /* 2.2 p - 1 pivots are selected from the regular sample. */
-                for (int i = arg->process + pivot_step, count = 0;
-                     i < total_samples.size && count < arg->process - 1;
-                     i += arg->process, ++count) {
-                        if (0 > list_add(pivot_list, total_samples.head[i])) {
-                                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                        }
-                }
-                free(total_samples.head);
-                total_samples.head = NULL;
-                pivots->size = (int)pivot_list->size;
-                pivots->head = (long *)calloc(pivots->size, sizeof(long));
+/* ------------------------------- Phase 2.2 ------------------------------- */
+/*
+ * Sorts the samples gathered on root and picks the p - 1 pivots out of
+ * them into 'pivots', which is all root does between the 2 collectives of
+ * phase 2.
+ */
+void
+pivots_pick(struct partition *const pivots,
+            struct partition *const total_samples,
+            const struct process_arg *const arg)
+{
+        /* ρ (rho) = floor(p / 2) */
+        int pivot_step = 0;
+
+        if (NULL == pivots || NULL == total_samples || NULL == arg) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+
+        pivot_step = arg->process / 2;
+        memset(pivots, 0, sizeof(struct partition));
+
+        /* Sort the collected samples. */
+        qsort(total_samples->head,
+              total_samples->size,
+              sizeof(long),
+              long_compare);
+        /*
+         * p - 1 pivots are selected from the regular sample;
+         * they are written straight into a buffer of that size.
+         */
+        if (0 > arena_alloc(arg->arena,
+                            (void **)&(pivots->head),
+                            sizeof(long) * (arg->process - 1))) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
+        }
+        for (int i = arg->process + pivot_step;
+             i < total_samples->size && pivots->size < arg->process - 1;
+             i += arg->process) {
+                pivots->head[pivots->size++] = total_samples->head[i];
+        }
+        /*
+         * Too few samples (some blocks given to 'psrs_sort' are
+         * smaller than 'arg->process') leave the last partitions
+         * empty rather than short of pivots.
+         */
+        while (0 < total_samples->size &&
+               pivots->size < arg->process - 1) {
+                pivots->head[pivots->size++] =
+                        total_samples->head[total_samples->size - 1];
+        }
+        total_samples->head = NULL;
+}
 
-                if (NULL == pivots->head) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
+static void
+pivots_bcast(struct partition *const pivots,
+             struct partition *const total_samples,
+             const struct process_arg *const arg)
+{
+        if (NULL == pivots || NULL == total_samples || NULL == arg) {
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
 
-                if (0 > list_copy(pivot_list, pivots->head)) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
+        memset(pivots, 0, sizeof(struct partition));
 
-                if (0 > list_destroy(&pivot_list)) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
+        if (arg->root) {
+                pivots_pick(pivots, total_samples, arg);
         }
         /*
          * Wait until root process finishes sorting the gathered samples
          * and finds all the pivots.
          */
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
 
         /*
          * Every process other than root needs to know the size of the
@@ -835,22 +3536,22 @@ pivots_bcast(struct partition *const pivots,
                   1,
                   MPI_INT,
                   0,
-                  MPI_COMM_WORLD);
+                  arg->comm);
 
         if (false == arg->root) {
-                pivots->head = (long *)calloc(pivots->size, sizeof(long));
-
-                if (NULL == pivots->head) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                if (0 > arena_alloc(arg->arena,
+                                    (void **)&(pivots->head),
+                                    sizeof(long) * pivots->size)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
                 }
         }
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
         MPI_Bcast(pivots->head,
                   pivots->size,
                   MPI_LONG,
                   0,
-                  MPI_COMM_WORLD);
+                  arg->comm);
 
 #if 0
         puts("\n------------------------------");
@@ -864,14 +3565,14 @@ pivots_bcast(struct partition *const pivots,
                         }
                         puts("\n------------------------------");
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(arg->comm);
         }
 #endif
 }
-/* ---------------------------- Phase 2.1 - 2.2 ---------------------------- */
+/* ------------------------------- Phase 2.2 ------------------------------- */
 
 /* ------------------------------- Phase 2.3 ------------------------------- */
-static void
+void
 partition_form(struct part_blk *const blk,
                struct partition *const pivots,
                const struct process_arg *const arg)
@@ -894,17 +3595,20 @@ partition_form(struct part_blk *const blk,
                      ++sub_idx);
 #endif
 
-                if (0 > bin_search(&sub_idx,
+                /*
+                 * Partitions can be empty (e.g. for presorted input, where
+                 * all the values of a process fall between 2 pivots), so
+                 * nothing is left to search once the values run out.
+                 */
+                sub_idx = 0;
+                if (arg->size > prev_part_size &&
+                    0 > bin_search(&sub_idx,
                                    pivot,
                                    blk->part[part_idx].head,
                                    arg->size - prev_part_size)) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
                 }
 
-
-                if (0 == sub_idx) {
-                        ++sub_idx;
-                }
                 blk->part[part_idx].size = sub_idx;
                 prev_part_size += sub_idx;
                 blk->part[part_idx + 1].head = blk->part[part_idx].head +\
@@ -913,8 +3617,8 @@ partition_form(struct part_blk *const blk,
         }
         blk->part[part_idx].size = arg->size - prev_part_size;
 
-        free(pivots->head);
-        MPI_Barrier(MPI_COMM_WORLD);
+        pivots->head = NULL;
+        phase_barrier(arg);
 #if 0
         int per_process_size = 0, total_size = 0;
 
@@ -933,7 +3637,7 @@ partition_form(struct part_blk *const blk,
                         printf("Partition Size is: %d\n", per_process_size);
                         puts("\n------------------------------");
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(arg->comm);
         }
 
         MPI_Reduce(&per_process_size,
@@ -942,7 +3646,7 @@ partition_form(struct part_blk *const blk,
                    MPI_INT,
                    MPI_SUM,
                    0,
-                   MPI_COMM_WORLD);
+                   arg->comm);
         if (arg->root) {
                 printf("Total Partition Size: %d\n", total_size);
         }
@@ -956,21 +3660,88 @@ partition_exchange(struct part_blk *const blk_copy,
                    struct part_blk *blk,
                    const struct process_arg *const arg)
 {
-        int part_idx = 0;
+        int *send_size = NULL;
+        int *recv_size = NULL;
+        int recv_total = 0;
+        long *recv_buf = NULL;
 
         if (NULL == blk_copy || NULL == blk || NULL == arg) {
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        /* i identifies the current sending process. */
+        /*
+         * The requests of the plan replace the sends in turn below: all the
+         * partitions travel at once, each to a receive already in place.
+         */
+        if (NULL != arg->plan) {
+                if (0 > plan_exchange(arg->plan, blk_copy, blk)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+                return;
+        }
+
+        if (0 > arena_alloc(arg->arena,
+                            (void **)&send_size,
+                            sizeof(int) * arg->process) ||
+            0 > arena_alloc(arg->arena,
+                            (void **)&recv_size,
+                            sizeof(int) * arg->process)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
+        }
+
+        for (int j = 0; j < arg->process; ++j) {
+                send_size[j] = blk->part[j].size;
+        }
+
+        /*
+         * Every process learns the size of all the partitions destined for
+         * it up front, so all of them can be laid out back to back (in the
+         * order of the sending process) in a single receive buffer.
+         */
+        MPI_Alltoall(send_size,
+                     1,
+                     MPI_INT,
+                     recv_size,
+                     1,
+                     MPI_INT,
+                     arg->comm);
+
         for (int i = 0; i < arg->process; ++i) {
-                partition_send(blk_copy, blk, i, &part_idx, arg);
+                if (i != arg->id) {
+                        recv_total += recv_size[i];
+                }
         }
 
-        if (0 > part_blk_destroy(&blk)) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        if (0 < arg->chunk_limit) {
+                partition_exchange_bounded(blk_copy, blk, recv_size, arg);
+                return;
+        }
+
+        if (0 > arena_alloc(arg->arena,
+                            (void **)&recv_buf,
+                            sizeof(long) * recv_total)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
+        }
+
+        /*
+         * The partition a process keeps for itself is already sorted and
+         * stored in 'arg->head', so it is referenced in place rather than
+         * copied; it takes no room in the receive buffer.
+         */
+        for (int i = 0, offset = 0; i < arg->process; ++i) {
+                if (i == arg->id) {
+                        blk_copy->part[i] = blk->part[i];
+                } else {
+                        blk_copy->part[i].head = recv_buf + offset;
+                        blk_copy->part[i].size = recv_size[i];
+                        offset += recv_size[i];
+                }
+        }
+
+        /* i identifies the current sending process. */
+        for (int i = 0; i < arg->process; ++i) {
+                partition_send(blk_copy, blk, i, arg);
         }
-        free(arg->head);
 
 #if 0
         int per_process_size = 0, total_size = 0;
@@ -989,7 +3760,7 @@ partition_exchange(struct part_blk *const blk_copy,
                                i, per_process_size);
                         puts("\n------------------------------");
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(arg->comm);
         }
 
         MPI_Reduce(&per_process_size,
@@ -998,45 +3769,107 @@ partition_exchange(struct part_blk *const blk_copy,
                    MPI_INT,
                    MPI_SUM,
                    0,
-                   MPI_COMM_WORLD);
+                   arg->comm);
         if (arg->root) {
                 printf("Total Partition Size: %d\n", total_size);
         }
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(arg->comm);
 #endif
 }
 
+/*
+ * Phase 3 of the memory-bounded mode (see 'arg->chunk_limit'): instead of
+ * a receive buffer for all the incoming partitions, there is a single one
+ * of at most 'arg->chunk_limit' elements, and every chunk received into it
+ * is merged right away into the result, which starts off as a copy of the
+ * partition kept; so phase 4.1 has nothing left to merge.  Each incoming
+ * partition is merged in one pass over the result, however many chunks it
+ * takes, so a smaller limit costs messages rather than copying.
+ *
+ * NOTE:
+ * Afterwards only the partition of this process in 'blk_copy' is not
+ * empty, and it holds the whole result.
+ */
+static void
+partition_exchange_bounded(struct part_blk *const blk_copy,
+                           struct part_blk *blk,
+                           const int recv_size[const],
+                           const struct process_arg *const arg)
+{
+        int merged_total = blk->part[arg->id].size;
+        int chunk_size = 0;
+        long *chunk = NULL;
+        long *merged = NULL;
+
+        for (int i = 0; i < arg->process; ++i) {
+                if (i == arg->id) {
+                        continue;
+                }
+                merged_total += recv_size[i];
+                if (chunk_size < recv_size[i]) {
+                        chunk_size = recv_size[i] < arg->chunk_limit ?
+                                     recv_size[i] : arg->chunk_limit;
+                }
+        }
+
+        if (0 > arena_alloc(arg->arena,
+                            (void **)&merged,
+                            sizeof(long) * merged_total) ||
+            0 > arena_alloc(arg->arena,
+                            (void **)&chunk,
+                            sizeof(long) * chunk_size)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
+        }
+
+        memcpy(merged,
+               blk->part[arg->id].head,
+               sizeof(long) * blk->part[arg->id].size);
+        for (int i = 0; i < arg->process; ++i) {
+                if (i == arg->id) {
+                        blk_copy->part[i].head = merged;
+                        blk_copy->part[i].size = blk->part[i].size;
+                } else {
+                        blk_copy->part[i].head = chunk;
+                        blk_copy->part[i].size = recv_size[i];
+                }
+        }
+
+        /* i identifies the current sending process. */
+        for (int i = 0; i < arg->process; ++i) {
+                partition_send(blk_copy, blk, i, arg);
+        }
+
+        for (int i = 0; i < arg->process; ++i) {
+                if (i != arg->id) {
+                        blk_copy->part[i].size = 0;
+                }
+        }
+}
+
+/*
+ * NOTE:
+ * 'blk_copy' must already describe where each incoming partition goes:
+ * the 'sid'-th partition of 'blk_copy' receives from process 'sid'.
+ *
+ * In the memory-bounded mode, every partition travels in chunks of at most
+ * 'arg->chunk_limit' elements, and each chunk received is merged into the
+ * partition of this process in 'blk_copy' (see
+ * 'partition_exchange_bounded').
+ */
 static void
 partition_send(struct part_blk *const blk_copy,
                struct part_blk *const blk,
                const int sid,
-               int *const pindex,
                const struct process_arg *const arg)
 {
+        double begin = 0;
         MPI_Status recv_status;
 
-        if (NULL == blk_copy || NULL == blk ||\
-            0 > sid || NULL == pindex || 0 > *pindex || NULL == arg) {
+        if (NULL == blk_copy || NULL == blk || 0 > sid || NULL == arg) {
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
         memset(&recv_status, 0, sizeof(MPI_Status));
-        /*
-         * Copy the corresponding partition to itself if the current sending
-         * process is the same as 'arg->id'.
-         */
-        if (sid == arg->id) {
-                blk_copy->part[*pindex].size = blk->part[arg->id].size;
-                blk_copy->part[*pindex].head = (long *)\
-                                               calloc(blk->part[arg->id].size,
-                                                      sizeof(long));
-                if (NULL == blk_copy->part[*pindex].head) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-                }
-                memcpy(blk_copy->part[*pindex].head, blk->part[arg->id].head,
-                       blk->part[arg->id].size * sizeof(long));
-                ++*pindex;
-        }
         /*
          * From 5.7 (Chapter 5 Section 7) of
          * Multicore and GPU Programming
@@ -1067,128 +3900,206 @@ partition_send(struct part_blk *const blk_copy,
                  * There is no need to send anything if the id of the sender
                  * process equals to the id of the partition to be sent.
                  */
-                if (sid != j) {
+                if (sid != j && 0 < arg->chunk_limit) {
+                        partition_send_bounded(blk_copy, blk, sid, j, arg);
+                } else if (sid != j) {
+                        begin = MPI_Wtime();
                         if (sid == arg->id) {
-                                MPI_Ssend(&(blk->part[j].size),
-                                          1,
-                                          MPI_INT,
-                                          j,
-                                          0,
-                                          MPI_COMM_WORLD);
                                 MPI_Ssend(blk->part[j].head,
                                           blk->part[j].size,
                                           MPI_LONG,
                                           j,
                                           0,
-                                          MPI_COMM_WORLD);
+                                          arg->comm);
+                                trace_record(arg, TRACE_SEND, j, begin);
                         } else if (j == arg->id) {
-                                MPI_Recv(&(blk_copy->part[*pindex].size),
-                                         1,
-                                         MPI_INT,
-                                         sid,
-                                         MPI_ANY_TAG,
-                                         MPI_COMM_WORLD,
-                                         &recv_status);
-                                mpi_recv_check(&recv_status,
-                                               MPI_INT,
-                                               1);
-                                blk_copy->part[*pindex].head =(long *)calloc(\
-                                                blk_copy->part[*pindex].size,
-                                                sizeof(long));
-                                if (NULL == blk_copy->part[*pindex].head) {
-                                        MPI_Abort(MPI_COMM_WORLD,
-                                                  EXIT_FAILURE);
-                                }
-                                MPI_Recv(blk_copy->part[*pindex].head,
-                                         blk_copy->part[*pindex].size,
+                                MPI_Recv(blk_copy->part[sid].head,
+                                         blk_copy->part[sid].size,
                                          MPI_LONG,
                                          sid,
                                          MPI_ANY_TAG,
-                                         MPI_COMM_WORLD,
+                                         arg->comm,
                                          &recv_status);
                                 mpi_recv_check(&recv_status,
                                                MPI_LONG,
-                                               blk_copy->part[*pindex].size);
-                                ++*pindex;
+                                               blk_copy->part[sid].size,
+                                               arg->comm);
+                                trace_record(arg, TRACE_RECV, sid, begin);
                         }
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                phase_barrier(arg);
         }
 }
-/* -------------------------------- Phase 3 -------------------------------- */
 
-/* -------------------------------- Phase 4 -------------------------------- */
+/*
+ * Sends the 'j'-th partition of process 'sid' in the memory-bounded mode:
+ * in rounds of at most 'arg->chunk_limit' elements, from the largest
+ * elements down, so that the receiver merges the whole partition into its
+ * own one in 'blk_copy' in a single pass from the back, a round at a time,
+ * without moving the same elements again for every round; an empty
+ * partition is not sent at all.
+ */
 static void
-partition_merge(struct partition *const result,
+partition_send_bounded(struct part_blk *const blk_copy,
+                       struct part_blk *const blk,
+                       const int sid,
+                       const int j,
+                       const struct process_arg *const arg)
+{
+        double begin = 0;
+        int count = 0;
+        size_t lindex = 0U, oindex = 0U;
+        struct partition *mine = NULL;
+        MPI_Status recv_status;
+
+        memset(&recv_status, 0, sizeof(MPI_Status));
+        if (sid == arg->id) {
+                for (int i = blk->part[j].size; 0 < i; i -= count) {
+                        count = i < arg->chunk_limit ? i : arg->chunk_limit;
+                        begin = MPI_Wtime();
+                        MPI_Ssend(blk->part[j].head + i - count,
+                                  count,
+                                  MPI_LONG,
+                                  j,
+                                  0,
+                                  arg->comm);
+                        trace_record(arg, TRACE_SEND, j, begin);
+                }
+        } else if (j == arg->id) {
+                mine = &(blk_copy->part[arg->id]);
+                lindex = mine->size;
+                oindex = mine->size + blk_copy->part[sid].size;
+                for (int i = blk_copy->part[sid].size; 0 < i; i -= count) {
+                        count = i < arg->chunk_limit ? i : arg->chunk_limit;
+                        begin = MPI_Wtime();
+                        MPI_Recv(blk_copy->part[sid].head,
+                                 count,
+                                 MPI_LONG,
+                                 sid,
+                                 MPI_ANY_TAG,
+                                 arg->comm,
+                                 &recv_status);
+                        mpi_recv_check(&recv_status,
+                                       MPI_LONG,
+                                       count,
+                                       arg->comm);
+                        trace_record(arg, TRACE_RECV, sid, begin);
+                        array_merge_stream_back(mine->head,
+                                                &lindex,
+                                                &oindex,
+                                                blk_copy->part[sid].head,
+                                                count);
+                }
+                mine->size += blk_copy->part[sid].size;
+        }
+}
+/* -------------------------------- Phase 3 -------------------------------- */
+
+/* ------------------------------- Phase 4.1 ------------------------------- */
+void
+partition_merge(struct partition *const merged,
                 struct part_blk *blk_copy,
                 const struct process_arg *const arg)
 {
+        int merged_total = 0;
+        int dump_idx = 0;
+        double begin = 0;
+        /* The 2 buffers each merge step alternates between. */
+        long *merge_buf[2] = { NULL, NULL };
         struct partition running_result;
         struct partition merge_dump;
-        MPI_Status recv_status;
 
-        if (NULL == result || NULL == blk_copy || NULL == arg) {
+        if (NULL == merged || NULL == blk_copy || NULL == arg) {
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
-        memset(result, 0, sizeof(struct partition));
-        memset(&recv_status, 0, sizeof(MPI_Status));
+        for (int i = 0; i < blk_copy->size; ++i) {
+                merged_total += blk_copy->part[i].size;
+        }
 
         /* Perform a shallow copy of the 1st partition. */
         running_result = blk_copy->part[0];
         for (int i = 1; i < arg->process; ++i) {
-                merge_dump.size = running_result.size + blk_copy->part[i].size;
-                merge_dump.head = calloc(merge_dump.size, sizeof(long));
-                if (NULL == merge_dump.head) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                /* Nothing to merge with an empty partition. */
+                if (0 == blk_copy->part[i].size) {
+                        continue;
                 }
+                if (0 == running_result.size) {
+                        running_result = blk_copy->part[i];
+                        continue;
+                }
+                /*
+                 * Every intermediate result is at most 'merged_total' long,
+                 * so 2 buffers of that size are enough for all the merge
+                 * steps: each step reads from one of them and writes into
+                 * the other.  They are only set aside once there is
+                 * actually something to merge, which never happens in the
+                 * memory-bounded mode (see 'partition_exchange_bounded').
+                 */
+                if (NULL == merge_buf[dump_idx] &&
+                    0 > arena_alloc(arg->arena,
+                                    (void **)&(merge_buf[dump_idx]),
+                                    sizeof(long) * merged_total)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+                merge_dump.size = running_result.size + blk_copy->part[i].size;
+                merge_dump.head = merge_buf[dump_idx];
+                begin = MPI_Wtime();
                 array_merge(merge_dump.head,
                             running_result.head,
                             running_result.size,
                             blk_copy->part[i].head,
                             blk_copy->part[i].size);
-#if 0
-                free(running_result.head);
-                free(blk_copy->part[i].head);
-#endif
+                trace_record(arg, TRACE_MERGE, merge_dump.size, begin);
                 running_result = merge_dump;
+                dump_idx ^= 1;
         }
 
-        /*
-         * The merged result of all partitions is stored in 'running_result'.
-         * 'blk_copy' can be safely discarded for all processes.
-         */
-        if (0 > part_blk_destroy(&blk_copy)) {
+        *merged = running_result;
+}
+/* ------------------------------- Phase 4.1 ------------------------------- */
+
+/* ------------------------------- Phase 4.2 ------------------------------- */
+static void
+result_gather(struct partition *const result,
+              const struct partition *const merged,
+              const struct process_arg *const arg)
+{
+        MPI_Status recv_status;
+
+        if (NULL == result || NULL == merged || NULL == arg) {
                 MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
         }
 
+        memset(result, 0, sizeof(struct partition));
+        memset(&recv_status, 0, sizeof(MPI_Status));
+
         /*
-         * Root process copies 'running_result.head' into the tentative
+         * Root process copies 'merged->head' into the tentative
          * final 'result' since later on there is no need for the root
          * process to send merged partitions to itself.
          */
         if (arg->root) {
                 result->size = arg->total_size;
-                result->head = (long *)calloc(arg->total_size, sizeof(long));
-
-                if (NULL == result->head) {
-                        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                if (0 > arena_alloc(arg->arena,
+                                    (void **)&(result->head),
+                                    sizeof(long) * arg->total_size)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
                 }
                 memcpy(result->head,
-                       running_result.head,
-                       running_result.size * sizeof(long));
+                       merged->head,
+                       merged->size * sizeof(long));
         }
 
-        MPI_Barrier(MPI_COMM_WORLD);
+        phase_barrier(arg);
 
         /*
-         * 4.2
          * The concatenation of all the lists is the final sorted list.
          * 'i' denotes the sending process in each iteration.
          *
          * NOTE: 'last_size' is only meaningful in the root process.
          */
-        for (int i = 1, last_size = running_result.size, merged_size = 0;
+        for (int i = 1, last_size = merged->size, merged_size = 0;
              i < arg->process;
              ++i) {
                 if (arg->root) {
@@ -1197,22 +4108,24 @@ partition_merge(struct partition *const result,
                                  MPI_INT,
                                  i,
                                  MPI_ANY_TAG,
-                                 MPI_COMM_WORLD,
+                                 arg->comm,
                                  &recv_status);
                         mpi_recv_check(&recv_status,
                                        MPI_INT,
-                                       1);
+                                       1,
+                                       arg->comm);
 
                         MPI_Recv(result->head + last_size,
                                  merged_size,
                                  MPI_LONG,
                                  i,
                                  MPI_ANY_TAG,
-                                 MPI_COMM_WORLD,
+                                 arg->comm,
                                  &recv_status);
                         mpi_recv_check(&recv_status,
                                        MPI_LONG,
-                                       merged_size);
+                                       merged_size,
+                                       arg->comm);
                         last_size += merged_size;
 #if 0
                         memcpy(arg->head + last_size,
@@ -1221,28 +4134,173 @@ partition_merge(struct partition *const result,
                         last_size += arg[i].result_size;
 #endif
                 } else if (i == arg->id) {
-                        MPI_Ssend(&running_result.size,
+                        MPI_Ssend(&(merged->size),
                                   1,
                                   MPI_INT,
                                   0,
                                   0,
-                                  MPI_COMM_WORLD);
+                                  arg->comm);
 
-                        MPI_Ssend(running_result.head,
-                                  running_result.size,
+                        MPI_Ssend(merged->head,
+                                  merged->size,
                                   MPI_LONG,
                                   0,
                                   0,
-                                  MPI_COMM_WORLD);
+                                  arg->comm);
                 }
-                MPI_Barrier(MPI_COMM_WORLD);
+                phase_barrier(arg);
+        }
+        phase_barrier(arg);
+}
+/* ------------------------------- Phase 4.2 ------------------------------- */
+
+/*
+ * Synchronizes all the processes within and between phases unless
+ * 'arg->barrier' is turned off.
+ */
+static inline void
+phase_barrier(const struct process_arg *const arg)
+{
+        double begin = 0;
+
+        if (arg->barrier) {
+                begin = MPI_Wtime();
+                MPI_Barrier(arg->comm);
+                trace_record(arg, TRACE_BARRIER, 0, begin);
+                if (NULL != arg->barrier_wait) {
+                        *(arg->barrier_wait) += MPI_Wtime() - begin;
+                }
+        }
+}
+
+/*
+ * Times the sub-phase that has just ended into 'lap' as 'timing_lap' does,
+ * less the time spent in the barriers within it, which '*barrier_wait'
+ * holds and is cleared for the next sub-phase.
+ */
+static inline void
+subphase_lap(double *const lap,
+             struct timespec *const lap_start,
+             double *const barrier_wait)
+{
+        timing_lap(lap, lap_start);
+        *lap -= *barrier_wait;
+        *barrier_wait = 0;
+}
+
+/*
+ * Starts counting hardware events for the phase about to begin, which is a
+ * no-op unless the counters are turned on.
+ */
+static inline void
+counter_begin(const struct process_arg *const arg)
+{
+        if (NULL != arg->counter) {
+                if (0 > timing_counter_start(arg->counter)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+        }
+}
+
+/* Adds the hardware events counted since 'counter_begin' to 'phase'. */
+static inline void
+counter_end(const struct process_arg *const arg, const enum psrs_phase phase)
+{
+        if (NULL != arg->counter) {
+                if (0 > timing_counter_stop(arg->counter, arg->count[phase])) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+        }
+}
+
+/*
+ * Marks the beginning of the run for 'memory_end', which is a no-op unless
+ * memory instrumentation is turned on.
+ */
+static inline void
+memory_begin(struct process_arg *const arg)
+{
+        if (NULL != arg->memory) {
+                if (0 > memory_read(arg->memory_mark, arg->arena)) {
+                        MPI_Abort(arg->comm, EXIT_FAILURE);
+                }
+        }
+}
+
+/*
+ * Records the memory at the end of 'phase', keeping the largest value over
+ * the runs; the bytes and the number of allocations are the ones made since
+ * the end of the previous phase.
+ */
+static inline void
+memory_end(struct process_arg *const arg, const enum psrs_phase phase)
+{
+        double usage[MEMORY_STAT_SIZE];
+
+        if (NULL == arg->memory) {
+                return;
+        }
+
+        if (0 > memory_read(usage, arg->arena)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
+        }
+
+        for (int j = MEMORY_ALLOCATED; j < MEMORY_STAT_SIZE; ++j) {
+                double value = usage[j];
+
+                if (MEMORY_ALLOCATED == j || MEMORY_ALLOCATIONS == j) {
+                        value -= arg->memory_mark[j];
+                }
+                if (arg->memory[phase][j] < value) {
+                        arg->memory[phase][j] = value;
+                }
+        }
+        memcpy(arg->memory_mark, usage, sizeof usage);
+}
+
+/*
+ * Charges the MPI calls that follow to 'phase' (or to nothing with
+ * 'COMM_PHASE_NONE'), which is a no-op unless the PMPI layer is linked in;
+ * a failure aborts the processes of 'comm'.
+ */
+static inline void
+comm_mark(MPI_Comm comm, const int phase)
+{
+#ifdef PSRS_PMPI
+        if (0 > comm_phase_set(phase)) {
+                MPI_Abort(comm, EXIT_FAILURE);
+        }
+#else
+        (void)comm;
+        (void)phase;
+#endif
+}
+
+/* Drops whatever the PMPI layer accounted so far, if it is linked in. */
+static inline void
+comm_clear(void)
+{
+#ifdef PSRS_PMPI
+        comm_reset();
+#endif
+}
+
+/*
+ * Records an event that started at 'begin' into 'arg->trace', which is a
+ * no-op unless tracing is turned on.
+ */
+static inline void
+trace_record(const struct process_arg *const arg,
+             const enum trace_kind kind,
+             const int value,
+             const double begin)
+{
+        if (0 > trace_add(arg->trace, kind, value, begin)) {
+                MPI_Abort(arg->comm, EXIT_FAILURE);
         }
-        MPI_Barrier(MPI_COMM_WORLD);
-        free(running_result.head);
 }
-/* -------------------------------- Phase 4 -------------------------------- */
 
-static int long_compare(const void *left, const void *right)
+int long_compare(const void *left, const void *right)
 {
         const long left_long = *((const long *)left);
         const long right_long = *((const long *)right);
@@ -1260,11 +4318,11 @@ static int long_compare(const void *left, const void *right)
  * Link:
  * http://stanford.edu/~rezab/dao/notes/Lecture03/cme323_lec3.pdf
  */
-static int array_merge(long output[const],
-                       const long left[const],
-                       const size_t lsize,
-                       const long right[const],
-                       const size_t rsize)
+int array_merge(long output[const],
+                const long left[const],
+                const size_t lsize,
+                const long right[const],
+                const size_t rsize)
 {
         size_t lindex = 0U, rindex = 0U, oindex = 0U;
 
@@ -1306,7 +4364,57 @@ static int array_merge(long output[const],
         return 0;
 }
 
-static int
+/*
+ * Merges 'right' into the sorted 'lsize' elements at the beginning of
+ * 'inout', which must have room for 'lsize' + 'rsize' elements; the merge
+ * runs from the back so no other buffer is needed.
+ *
+ * NOTE:
+ * Unlike 'array_merge', 'lsize' may be 0; equal elements of 'inout' stay
+ * before those of 'right'.
+ */
+int array_merge_back(long inout[const],
+                     const size_t lsize,
+                     const long right[const],
+                     const size_t rsize)
+{
+        size_t lindex = lsize, oindex = lsize + rsize;
+
+        if (!inout || !right || 0U == rsize) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        array_merge_stream_back(inout, &lindex, &oindex, right, rsize);
+        /* Whatever remains of 'inout' is already in place. */
+        return 0;
+}
+
+/*
+ * Merges 'right' from the back into 'inout', whose first '*lindex'
+ * elements are not merged yet, writing downwards from '*oindex'; both are
+ * updated, so a sorted sequence that arrives in pieces, the largest first,
+ * is merged in one pass over 'inout' (see 'partition_send_bounded').
+ */
+static void
+array_merge_stream_back(long inout[const],
+                        size_t *const lindex,
+                        size_t *const oindex,
+                        const long right[const],
+                        const size_t rsize)
+{
+        size_t rindex = rsize;
+
+        while (0U < rindex) {
+                if (0U < *lindex && inout[*lindex - 1] > right[rindex - 1]) {
+                        inout[--*oindex] = inout[--*lindex];
+                } else {
+                        inout[--*oindex] = right[--rindex];
+                }
+        }
+}
+
+int
 bin_search(int *const index,
            const long value,
            const long array[const],
@@ -1339,22 +4447,23 @@ bin_search(int *const index,
 
 /*
  * Checks whether the number of elements received actually matches the
- * amount expected.
+ * amount expected, aborting the processes of 'comm' otherwise.
  */
 static inline void
 mpi_recv_check(const MPI_Status *const status,
                MPI_Datatype datatype,
-               const int count)
+               const int count,
+               MPI_Comm comm)
 {
         int received = 0;
 
         if (NULL == status || 0 > count) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                MPI_Abort(comm, EXIT_FAILURE);
         }
 
         MPI_Get_count(status, datatype, &received);
 
         if (received != count) {
-                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+                MPI_Abort(comm, EXIT_FAILURE);
         }
 }
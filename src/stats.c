@@ -1,4 +1,6 @@
+#define STATS_ONLY
 #include "psrs/stats.h"
+#undef STATS_ONLY
 
 #include <errno.h>
 #include <math.h>
@@ -20,12 +22,14 @@ int moving_window_init(struct moving_window **self, const size_t length)
                 return -1;
         }
 
-        if (0 > ring_init(&ring, length, NULL, NULL)) {
+        if (0 > ring_init(&ring, length, sizeof(double), NULL, NULL)) {
                 free(window);
                 return -1;
         }
 
         window->ring = ring;
+        window->mean = 0;
+        window->m2 = 0;
         window->written = 0U;
 
         *self = window;
@@ -34,15 +38,43 @@ int moving_window_init(struct moving_window **self, const size_t length)
 
 int moving_window_push(struct moving_window *self, const double value)
 {
+        double evicted = 0;
+        double prev_mean = 0;
+        size_t count = 0U;
+
         if (NULL == self) {
                 errno = EINVAL;
                 return -1;
         }
 
-        if (0 > ring_add(self->ring, &value, sizeof(double))) {
+        /* 'self->ring' can not be NULL; return value unchecked. */
+        ring_count(self->ring, &count);
+
+        if (0 > ring_add(self->ring, &value, &evicted)) {
                 return -1;
         }
 
+        prev_mean = self->mean;
+
+        if (count < self->ring->length) {
+                /* Welford's update for a growing sample. */
+                self->mean += (value - prev_mean) / (double)(count + 1U);
+                self->m2 += (value - prev_mean) * (value - self->mean);
+        } else {
+                /*
+                 * The window is full: 'value' replaces 'evicted' while the
+                 * sample size stays the same.
+                 */
+                self->mean += (value - evicted) / (double)count;
+                self->m2 += (value - evicted) *\
+                            (value - self->mean + evicted - prev_mean);
+        }
+
+        /* Guard against a tiny negative value caused by rounding errors. */
+        if (0 > self->m2) {
+                self->m2 = 0;
+        }
+
         /*
          * Let the 'written' field stay at 'SIZE_MAX' if it is about to
          * overflow: this field is only used for testing inequality
@@ -77,10 +109,7 @@ int moving_window_destroy(struct moving_window **self)
 
 int moving_average_calc(const struct moving_window *window, double *average)
 {
-        double result = 0;
-        double *current = NULL;
         size_t window_size = 0U;
-        struct ring_iter *iter = NULL;
 
         if (NULL == window || NULL == average) {
                 errno = EINVAL;
@@ -105,33 +134,13 @@ int moving_average_calc(const struct moving_window *window, double *average)
                 return -1;
         }
 
-        if (0 > ring_iter_init(&iter, window->ring)) {
-                return -1;
-        }
-
-        for (size_t i = 0U; i < window_size; ++i) {
-                /* Both arguments can not be NULL; return value unchecked. */
-                ring_iter_walk(iter, (void **)(&current));
-                result += *current;
-        }
-
-        result /= (double)window_size;
-
-        /* 'iter' can not be NULL; return value unchecked. */
-        ring_iter_destroy(&iter);
-
-        *average = result;
+        *average = window->mean;
         return 0;
 }
 
 int moving_stdev_calc(const struct moving_window *window, double *stdev)
 {
-        double average = 0;
-        double summation = 0;
-        double result = 0;
-        double *current = NULL;
         size_t window_size = 0U;
-        struct ring_iter *iter = NULL;
 
         if (NULL == window || NULL == stdev) {
                 errno = EINVAL;
@@ -156,34 +165,276 @@ int moving_stdev_calc(const struct moving_window *window, double *stdev)
                 return -1;
         }
 
-        if (0 > ring_iter_init(&iter, window->ring)) {
+        if (1U == window_size) {
+                *stdev = sqrt(window->m2 / (double)window_size);
+        } else {
+                /*
+                 * Apply Bessel's correction to the result standard
+                 * deviation when the sample size > 1.
+                 */
+                *stdev = sqrt(window->m2 / ((double)window_size - 1));
+        }
+        return 0;
+}
+
+int moving_min_calc(const struct moving_window *window, double *min)
+{
+        double *sorted = NULL;
+        size_t count = 0U;
+
+        if (NULL == window || NULL == min) {
+                errno = EINVAL;
                 return -1;
         }
 
-        if (0 > moving_average_calc(window, &average)) {
+        if (0 > moving_window_sorted_(window, &sorted, &count)) {
                 return -1;
         }
 
-        for (size_t i = 0U; i < window_size; ++i) {
-                /* Both arguments can not be NULL; return value unchecked. */
-                ring_iter_walk(iter, (void **)(&current));
-                /* Sum of Squares */
-                summation += pow(((*current) - average), 2);
+        *min = sorted[0];
+        free(sorted);
+        return 0;
+}
+
+int moving_max_calc(const struct moving_window *window, double *max)
+{
+        double *sorted = NULL;
+        size_t count = 0U;
+
+        if (NULL == window || NULL == max) {
+                errno = EINVAL;
+                return -1;
         }
 
-        if (1U == window_size) {
-                result = sqrt(summation / (double)window_size);
+        if (0 > moving_window_sorted_(window, &sorted, &count)) {
+                return -1;
+        }
+
+        *max = sorted[count - 1U];
+        free(sorted);
+        return 0;
+}
+
+/*
+ * Calculates the 'percent'-th percentile (in range [0, 100]) of the values in
+ * the window exactly, by linearly interpolating between the 2 closest ranks;
+ * so the 50th percentile is the median.
+ *
+ * NOTE:
+ * The window itself is the (small) exact buffer, its values are copied and
+ * sorted on every call; no approximation is involved.
+ */
+int moving_percentile_calc(const struct moving_window *window,
+                           const double percent,
+                           double *percentile)
+{
+        double *sorted = NULL;
+        double rank = 0;
+        size_t count = 0U;
+        size_t lower = 0U;
+
+        if (NULL == window || NULL == percentile ||\
+            !(0 <= percent && 100 >= percent)) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (0 > moving_window_sorted_(window, &sorted, &count)) {
+                return -1;
+        }
+
+        rank = percent / 100 * (double)(count - 1U);
+        lower = (size_t)floor(rank);
+
+        if (lower + 1U < count) {
+                *percentile = sorted[lower] +\
+                              (rank - (double)lower) *\
+                              (sorted[lower + 1U] - sorted[lower]);
         } else {
-                /*
-                 * Apply Bessel's correction to the result standard
-                 * deviation when the sample size > 1.
-                 */
-                result = sqrt(summation / ((double)window_size - 1));
+                *percentile = sorted[count - 1U];
+        }
+
+        free(sorted);
+        return 0;
+}
+
+/*
+ * Calculates the 95% confidence interval of the mean of the values in the
+ * window based on Student's t-distribution:
+ * mean ± t(0.975, n - 1) * stdev / sqrt(n)
+ */
+int moving_ci95_calc(const struct moving_window *window,
+                     double *low,
+                     double *high)
+{
+        double average = 0;
+        double stdev = 0;
+        double margin = 0;
+        size_t window_size = 0U;
+
+        if (NULL == window || NULL == low || NULL == high) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (0 > moving_average_calc(window, &average) ||\
+            0 > moving_stdev_calc(window, &stdev)) {
+                return -1;
         }
 
-        /* 'iter' can not be NULL; return value unchecked. */
-        ring_iter_destroy(&iter);
+        ring_length(window->ring, &window_size);
+
+        /* A single value has no spread to estimate the interval from. */
+        if (1U < window_size) {
+                margin = t_critical95_(window_size - 1U) *\
+                         stdev / sqrt((double)window_size);
+        }
 
-        *stdev = result;
+        *low = average - margin;
+        *high = average + margin;
         return 0;
 }
+
+/*
+ * Creates '*filtered', a new full window holding the values of 'window'
+ * (in the same order) except the outliers, and sets 'rejected' to the
+ * number of values left out; the caller needs to destroy '*filtered'.
+ *
+ * A value is an outlier if its modified z-score exceeds 'limit', that is,
+ * its distance from the median is more than 'limit' times the median
+ * absolute deviation (MAD) scaled by 1.4826, which makes the MAD a
+ * consistent estimator of the standard deviation for normal data.
+ *
+ * NOTE:
+ * Nothing is rejected if the MAD is 0 (more than half of the values are
+ * the same), since every other value would be infinitely far away.
+ */
+int moving_mad_filter(const struct moving_window *window,
+                      const double limit,
+                      struct moving_window **filtered,
+                      size_t *rejected)
+{
+        static const double MAD_SCALE = 1.4826;
+        double *sorted = NULL;
+        double value = 0;
+        double median = 0;
+        double mad = 0;
+        size_t count = 0U;
+        size_t kept = 0U;
+        struct moving_window *result = NULL;
+
+        if (NULL == window || NULL == filtered || NULL == rejected ||
+            !(0 < limit)) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (0 > moving_percentile_calc(window, 50, &median) ||
+            0 > moving_window_sorted_(window, &sorted, &count)) {
+                return -1;
+        }
+
+        /* The MAD is the median of the absolute deviations. */
+        for (size_t i = 0U; i < count; ++i) {
+                sorted[i] = fabs(sorted[i] - median);
+        }
+        qsort(sorted, count, sizeof(double), double_compare_);
+        mad = count % 2U ? sorted[count / 2U] :
+              (sorted[count / 2U - 1U] + sorted[count / 2U]) / 2;
+
+        for (size_t i = 0U; i < count; ++i) {
+                ring_get(window->ring, i, &value);
+                if (0 < mad && limit * MAD_SCALE * mad <
+                               fabs(value - median)) {
+                        continue;
+                }
+                sorted[kept++] = value;
+        }
+
+        if (0 > moving_window_init(&result, kept)) {
+                free(sorted);
+                return -1;
+        }
+
+        for (size_t i = 0U; i < kept; ++i) {
+                moving_window_push(result, sorted[i]);
+        }
+
+        free(sorted);
+        *filtered = result;
+        *rejected = count - kept;
+        return 0;
+}
+
+/*
+ * Copies the values in the window into a newly allocated array, sorted in
+ * ascending order; the array needs to be freed by the caller.
+ */
+static int moving_window_sorted_(const struct moving_window *window,
+                                 double **sorted,
+                                 size_t *count)
+{
+        double *values = NULL;
+        size_t window_size = 0U;
+
+        ring_length(window->ring, &window_size);
+
+        /* Same constraint as 'moving_average_calc'. */
+        if (window->written < window_size) {
+                errno = ENOTSUP;
+                return -1;
+        }
+
+        values = (double *)malloc(sizeof(double) * window_size);
+
+        if (NULL == values) {
+                return -1;
+        }
+
+        for (size_t i = 0U; i < window_size; ++i) {
+                /* 'i' is always in range; return value unchecked. */
+                ring_get(window->ring, i, &(values[i]));
+        }
+
+        qsort(values, window_size, sizeof(double), double_compare_);
+
+        *sorted = values;
+        *count = window_size;
+        return 0;
+}
+
+static int double_compare_(const void *left, const void *right)
+{
+        const double left_double = *((const double *)left);
+        const double right_double = *((const double *)right);
+
+        return (left_double < right_double ? -1 :
+                left_double > right_double ? 1 : 0);
+}
+
+/*
+ * Two-tailed critical value of Student's t-distribution at 95% confidence
+ * for the given degrees of 'freedom'.
+ */
+static double t_critical95_(const size_t freedom)
+{
+        static const double TABLE[] = {
+                12.706, 4.303, 3.182, 2.776, 2.571,
+                2.447, 2.365, 2.306, 2.262, 2.228,
+                2.201, 2.179, 2.160, 2.145, 2.131,
+                2.120, 2.110, 2.101, 2.093, 2.086,
+                2.080, 2.074, 2.069, 2.064, 2.060,
+                2.056, 2.052, 2.048, 2.045, 2.042
+        };
+
+        if (freedom <= sizeof(TABLE) / sizeof(TABLE[0])) {
+                return TABLE[freedom - 1U];
+        } else if (40U >= freedom) {
+                return 2.021;
+        } else if (60U >= freedom) {
+                return 2.000;
+        } else if (120U >= freedom) {
+                return 1.980;
+        }
+        return 1.960;
+}
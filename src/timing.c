@@ -1,6 +1,22 @@
+#include "psrs/macro.h"
+#define TIMING_ONLY
 #include "psrs/timing.h"
+#undef TIMING_ONLY
 
 #include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/* Assumed when the size of the last level cache can not be told. */
+#define TIMING_LLC_SIZE (32U << 20)
+#define TIMING_CACHE_LINE 64U
 
 int timing_start(struct timespec *start)
 {
@@ -29,8 +45,7 @@ int timing_reset(struct timespec *start)
 
 int timing_stop(double *elapsed, const struct timespec *start)
 {
-        struct timespec result = { .tv_nsec = 0 }, end = { .tv_nsec = 0 };
-        static const long NS_PER_SEC = 1000000000;
+        struct timespec end = { .tv_nsec = 0 };
 
         if (NULL == elapsed || NULL == start) {
                 errno = EINVAL;
@@ -40,18 +55,279 @@ int timing_stop(double *elapsed, const struct timespec *start)
         if (-1 == clock_gettime(CLOCK_REALTIME, &end)) {
                 return -1;
         }
+        return timing_stop_at_(elapsed, start, &end);
+}
+
+/*
+ * Same as 'timing_stop', except 'start' is moved forward to the current time
+ * afterwards, so consecutive calls time consecutive intervals without any gap
+ * in between.
+ */
+int timing_lap(double *elapsed, struct timespec *start)
+{
+        struct timespec now = { .tv_nsec = 0 };
+
+        if (NULL == elapsed || NULL == start) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (-1 == clock_gettime(CLOCK_REALTIME, &now)) {
+                return -1;
+        }
+
+        if (0 > timing_stop_at_(elapsed, start, &now)) {
+                return -1;
+        }
+
+        *start = now;
+        return 0;
+}
+
+static int timing_stop_at_(double *elapsed,
+                           const struct timespec *start,
+                           const struct timespec *end)
+{
+        struct timespec result = { .tv_nsec = 0 };
+        static const long NS_PER_SEC = 1000000000;
 
         /*
          * On a POSIX system, time_t is an arithmetic type.
          * Subtraction between 2 time_t values is allowed.
          */
-        if (start->tv_nsec > end.tv_nsec) {
-                result.tv_sec = end.tv_sec - start->tv_sec - 1;
-                result.tv_nsec = NS_PER_SEC + end.tv_nsec - start->tv_nsec;
+        if (start->tv_nsec > end->tv_nsec) {
+                result.tv_sec = end->tv_sec - start->tv_sec - 1;
+                result.tv_nsec = NS_PER_SEC + end->tv_nsec - start->tv_nsec;
         } else {
-                result.tv_sec = end.tv_sec - start->tv_sec;
-                result.tv_nsec = end.tv_nsec - start->tv_nsec;
+                result.tv_sec = end->tv_sec - start->tv_sec;
+                result.tv_nsec = end->tv_nsec - start->tv_nsec;
         }
         *elapsed = (double)result.tv_nsec / NS_PER_SEC + (double)result.tv_sec;
         return 0;
 }
+
+int timing_counter_init(struct timing_counter *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        self->available = 0U;
+        for (int i = COUNTER_CYCLES; i < COUNTER_COUNT; ++i) {
+                self->fd[i] = timing_counter_open_(i);
+                if (0 <= self->fd[i]) {
+                        self->available |= 1U << i;
+                }
+        }
+        return 0;
+}
+
+int timing_counter_start(struct timing_counter *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+#ifdef __linux__
+        for (int i = COUNTER_CYCLES; i < COUNTER_COUNT; ++i) {
+                if (0 > self->fd[i]) {
+                        continue;
+                }
+                if (-1 == ioctl(self->fd[i], PERF_EVENT_IOC_RESET, 0) ||
+                    -1 == ioctl(self->fd[i], PERF_EVENT_IOC_ENABLE, 0)) {
+                        return -1;
+                }
+        }
+#endif
+        return 0;
+}
+
+/*
+ * Stops every counter and ADDS the number of events counted since the last
+ * 'timing_counter_start' call to 'count', which has 'COUNTER_COUNT'
+ * elements; so the same 'count' can accumulate over several intervals.
+ *
+ * NOTE:
+ * If the kernel had to multiplex the counters, the values are scaled by
+ * the fraction of time each counter was actually running.
+ */
+int timing_counter_stop(struct timing_counter *self, double count[const])
+{
+#ifdef __linux__
+        /* Layout given by 'PERF_FORMAT_TOTAL_TIME_ENABLED | _RUNNING'. */
+        uint64_t value[3];
+#endif
+
+        if (NULL == self || NULL == count) {
+                errno = EINVAL;
+                return -1;
+        }
+
+#ifdef __linux__
+        for (int i = COUNTER_CYCLES; i < COUNTER_COUNT; ++i) {
+                if (0 > self->fd[i]) {
+                        continue;
+                }
+                if (-1 == ioctl(self->fd[i], PERF_EVENT_IOC_DISABLE, 0)) {
+                        return -1;
+                }
+                if (sizeof value != read(self->fd[i], value, sizeof value)) {
+                        return -1;
+                }
+                if (0U != value[2]) {
+                        count[i] += (double)value[0] *\
+                                    ((double)value[1] / value[2]);
+                }
+        }
+#endif
+        return 0;
+}
+
+int timing_counter_destroy(struct timing_counter *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+#ifdef __linux__
+        for (int i = COUNTER_CYCLES; i < COUNTER_COUNT; ++i) {
+                if (0 <= self->fd[i]) {
+                        close(self->fd[i]);
+                }
+                self->fd[i] = -1;
+        }
+#endif
+        self->available = 0U;
+        return 0;
+}
+
+int timing_flush_init(struct timing_flush *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        /*
+         * Half as large again as the last level cache, so it is evicted
+         * as a whole even if the replacement policy is not strictly LRU.
+         */
+        self->size = timing_llc_size_() / 2U * 3U;
+        self->buffer = (unsigned char *)malloc(self->size);
+
+        if (NULL == self->buffer) {
+                return -1;
+        }
+
+        /* Touch every page up front so no page fault is left for later. */
+        memset(self->buffer, 0, self->size);
+        return 0;
+}
+
+/*
+ * Writes to every cache line of the buffer, which also evicts the dirty
+ * lines of the previous run (not only the clean ones) from the caches.
+ */
+int timing_flush(struct timing_flush *self)
+{
+        if (NULL == self || NULL == self->buffer) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        for (size_t i = 0U; i < self->size; i += TIMING_CACHE_LINE) {
+                ++self->buffer[i];
+        }
+        return 0;
+}
+
+int timing_flush_destroy(struct timing_flush *self)
+{
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        free(self->buffer);
+        self->buffer = NULL;
+        self->size = 0U;
+        return 0;
+}
+
+/*
+ * Returns the file descriptor of a disabled counter of 'kind' for the
+ * calling thread in user space only, or -1 if it can not be opened.
+ */
+static int timing_counter_open_(const enum timing_counter_kind kind)
+{
+#ifdef __linux__
+        struct perf_event_attr attr;
+
+        memset(&attr, 0, sizeof attr);
+        attr.size = sizeof attr;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |\
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (kind) {
+        case COUNTER_CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+        case COUNTER_INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+        case COUNTER_BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+        case COUNTER_LLC_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_LL |\
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |\
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+        case COUNTER_DTLB_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB |\
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |\
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+        default:
+                errno = EINVAL;
+                return -1;
+        }
+
+        /* There is no glibc wrapper for this system call. */
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+        (void)kind;
+        errno = ENOSYS;
+        return -1;
+#endif
+}
+
+/*
+ * Returns the size of the last level cache in bytes, or 'TIMING_LLC_SIZE'
+ * if the system does not tell.
+ */
+static size_t timing_llc_size_(void)
+{
+        long size = -1;
+
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+        size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+        if (0 >= size) {
+                size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+        return 0 < size ? (size_t)size : TIMING_LLC_SIZE;
+}
@@ -0,0 +1,340 @@
+#include "psrs/macro.h"
+#define TRACE_ONLY
+#include "psrs/trace.h"
+#undef TRACE_ONLY
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Number of round trips per process used to estimate its clock offset. */
+#define TRACE_PING_COUNT 16
+#define TRACE_PING_TAG 0x7ACE
+
+static const struct {
+        const char *name;
+        const char *cat;
+        const char *arg; /* Name of the argument shown; NULL if none. */
+} TRACE_KIND_INFO[TRACE_KIND_COUNT] = {
+        [TRACE_RUN]     = { "Run",       "run",     NULL       },
+        [TRACE_PHASE1]  = { "Phase 1",   "phase",   NULL       },
+        [TRACE_PHASE2]  = { "Phase 2",   "phase",   NULL       },
+        [TRACE_PHASE3]  = { "Phase 3",   "phase",   NULL       },
+        [TRACE_PHASE4]  = { "Phase 4",   "phase",   NULL       },
+        [TRACE_BARRIER] = { "Barrier",   "wait",    NULL       },
+        [TRACE_SEND]    = { "Send",      "message", "to"       },
+        [TRACE_RECV]    = { "Recv",      "message", "from"     },
+        [TRACE_MERGE]   = { "Merge",     "compute", "elements" }
+};
+
+int trace_init(struct trace **self, const size_t capacity)
+{
+        struct trace *trace = NULL;
+
+        if (NULL == self || 0U == capacity) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (SIZE_MAX / sizeof(struct trace_event) < capacity) {
+                errno = EOVERFLOW;
+                return -1;
+        }
+
+        trace = (struct trace *)malloc(sizeof(struct trace));
+
+        if (NULL == trace) {
+                return -1;
+        }
+
+        trace->event = (struct trace_event *)malloc(capacity *\
+                                                    sizeof(struct trace_event));
+
+        if (NULL == trace->event) {
+                free(trace);
+                return -1;
+        }
+
+        trace->capacity = capacity;
+        trace->count = 0U;
+
+        *self = trace;
+        return 0;
+}
+
+/*
+ * Records an event that started at 'begin' (as returned by 'MPI_Wtime')
+ * and ends now.
+ *
+ * NOTE:
+ * A 'NULL' 'self' stands for tracing being turned off, so the call is a
+ * no-op and succeeds; this keeps the call sites free of extra checks.
+ */
+int trace_add(struct trace *self,
+              const enum trace_kind kind,
+              const int arg,
+              const double begin)
+{
+        double end = 0;
+        struct trace_event *event = NULL;
+
+        if (NULL == self) {
+                return 0;
+        }
+
+        end = MPI_Wtime();
+
+        if (TRACE_KIND_COUNT <= kind) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if (self->count == self->capacity) {
+                if (SIZE_MAX / 2U / sizeof(struct trace_event) <
+                    self->capacity) {
+                        errno = EOVERFLOW;
+                        return -1;
+                }
+
+                event = (struct trace_event *)
+                        realloc(self->event,
+                                2U * self->capacity *\
+                                sizeof(struct trace_event));
+
+                if (NULL == event) {
+                        return -1;
+                }
+                self->event = event;
+                self->capacity *= 2U;
+        }
+
+        event = &(self->event[self->count++]);
+        event->begin = begin;
+        event->end = end;
+        event->kind = kind;
+        event->arg = arg;
+        return 0;
+}
+
+/*
+ * Collective over 'comm': the events of every process are shifted into the
+ * clock of the process with rank 0, which then writes all of them into
+ * 'path' as a Chrome trace (JSON object format), one trace process per rank.
+ *
+ * NOTE:
+ * 'path' is only used (and so only needs to be valid) on rank 0;
+ * the clock offsets are estimated once here, at the end of the traced runs,
+ * so any drift between the clocks during the runs is not corrected for.
+ */
+int trace_write(struct trace *self, const char *path, MPI_Comm comm)
+{
+        int rank = 0;
+        int size = 0;
+        int count = 0;
+        double offset = 0;
+        double local_origin = 0;
+        double origin = 0;
+        FILE *stream = NULL;
+        struct trace_event *event = NULL;
+
+        if (NULL == self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if ((size_t)INT_MAX / sizeof(struct trace_event) < self->count) {
+                errno = EOVERFLOW;
+                return -1;
+        }
+
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &size);
+
+        if (0 > trace_offset_(&offset, comm)) {
+                return -1;
+        }
+
+        local_origin = self->count ? self->event[0].begin - offset : 0;
+        for (size_t i = 0U; i < self->count; ++i) {
+                self->event[i].begin -= offset;
+                self->event[i].end -= offset;
+                if (self->event[i].begin < local_origin) {
+                        local_origin = self->event[i].begin;
+                }
+        }
+
+        /*
+         * Timestamps are written relative to the earliest event of all the
+         * processes.
+         */
+        MPI_Reduce(&local_origin, &origin, 1, MPI_DOUBLE, MPI_MIN, 0, comm);
+
+        if (0 != rank) {
+                count = (int)self->count;
+                MPI_Send(&count, 1, MPI_INT, 0, TRACE_PING_TAG, comm);
+                MPI_Send(self->event,
+                         count * sizeof(struct trace_event),
+                         MPI_BYTE,
+                         0,
+                         TRACE_PING_TAG,
+                         comm);
+                return 0;
+        }
+
+        if (NULL == path || NULL == (stream = fopen(path, "w"))) {
+                return -1;
+        }
+
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", stream);
+        trace_json_write_(stream, self->event, self->count, 0, origin, true);
+
+        for (int i = 1; i < size; ++i) {
+                MPI_Recv(&count, 1, MPI_INT, i, TRACE_PING_TAG, comm,
+                         MPI_STATUS_IGNORE);
+                event = (struct trace_event *)
+                        malloc((count ? count : 1) *\
+                               sizeof(struct trace_event));
+
+                if (NULL == event) {
+                        fclose(stream);
+                        return -1;
+                }
+
+                MPI_Recv(event,
+                         count * sizeof(struct trace_event),
+                         MPI_BYTE,
+                         i,
+                         TRACE_PING_TAG,
+                         comm,
+                         MPI_STATUS_IGNORE);
+                trace_json_write_(stream, event, count, i, origin, false);
+                free(event);
+        }
+
+        fputs("\n]}\n", stream);
+
+        if (0 != fclose(stream)) {
+                return -1;
+        }
+        return 0;
+}
+
+int trace_destroy(struct trace **self)
+{
+        if (NULL == self || NULL == *self) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        free((*self)->event);
+        free(*self);
+        *self = NULL;
+        return 0;
+}
+
+/*
+ * Estimates how far the 'MPI_Wtime' clock of the calling process is ahead of
+ * the one of rank 0 by ping-pongs: rank 0 sends at 't0' and receives the
+ * reply at 't2', the other side reads its clock 't1' in between, so
+ * 't1 - (t0 + t2) / 2' is the offset if both legs take the same time;
+ * the round trip with the least latency gives the tightest estimate.
+ *
+ * NOTE: The processes are paired with rank 0 one at a time.
+ */
+static int trace_offset_(double *offset, MPI_Comm comm)
+{
+        int rank = 0;
+        int size = 0;
+        double t0 = 0, t1 = 0, t2 = 0;
+        double rtt = 0, best_rtt = 0, best = 0;
+
+        if (NULL == offset) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &size);
+
+        if (0 != rank) {
+                for (int j = 0; j < TRACE_PING_COUNT; ++j) {
+                        MPI_Recv(&t0, 1, MPI_DOUBLE, 0, TRACE_PING_TAG, comm,
+                                 MPI_STATUS_IGNORE);
+                        t1 = MPI_Wtime();
+                        MPI_Send(&t1, 1, MPI_DOUBLE, 0, TRACE_PING_TAG, comm);
+                }
+                MPI_Recv(offset, 1, MPI_DOUBLE, 0, TRACE_PING_TAG, comm,
+                         MPI_STATUS_IGNORE);
+                return 0;
+        }
+
+        for (int i = 1; i < size; ++i) {
+                for (int j = 0; j < TRACE_PING_COUNT; ++j) {
+                        t0 = MPI_Wtime();
+                        MPI_Send(&t0, 1, MPI_DOUBLE, i, TRACE_PING_TAG, comm);
+                        MPI_Recv(&t1, 1, MPI_DOUBLE, i, TRACE_PING_TAG, comm,
+                                 MPI_STATUS_IGNORE);
+                        t2 = MPI_Wtime();
+                        rtt = t2 - t0;
+
+                        if (0 == j || rtt < best_rtt) {
+                                best_rtt = rtt;
+                                best = t1 - (t0 + t2) / 2;
+                        }
+                }
+                MPI_Send(&best, 1, MPI_DOUBLE, i, TRACE_PING_TAG, comm);
+        }
+
+        *offset = 0;
+        return 0;
+}
+
+/*
+ * Writes the events of process 'rank' as complete ("X") events with
+ * microsecond timestamps relative to 'origin'; 'first' tells whether no
+ * event has been written into 'stream' yet (JSON allows no trailing comma).
+ */
+static int trace_json_write_(FILE *stream,
+                             const struct trace_event event[],
+                             const size_t count,
+                             const int rank,
+                             const double origin,
+                             const int first)
+{
+        static const double US_PER_SEC = 1e6;
+
+        if (NULL == stream || (NULL == event && 0U != count)) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        fprintf(stream,
+                "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"args\":{\"name\":\"Rank %d\"}},\n"
+                "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,"
+                "\"args\":{\"sort_index\":%d}}",
+                first ? "" : ",\n", rank, rank, rank, rank);
+
+        for (size_t i = 0U; i < count; ++i) {
+                fprintf(stream,
+                        ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                        "\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f",
+                        TRACE_KIND_INFO[event[i].kind].name,
+                        TRACE_KIND_INFO[event[i].kind].cat,
+                        rank,
+                        (event[i].begin - origin) * US_PER_SEC,
+                        (event[i].end - event[i].begin) * US_PER_SEC);
+
+                if (NULL != TRACE_KIND_INFO[event[i].kind].arg) {
+                        fprintf(stream,
+                                ",\"args\":{\"%s\":%d}",
+                                TRACE_KIND_INFO[event[i].kind].arg,
+                                event[i].arg);
+                }
+                fputs("}", stream);
+        }
+        return 0;
+}
@@ -11,6 +11,7 @@ __all__ = ["speedup_plot", "runtime_tabulate", "runtime_plot",
 
 # --------------------------------- MODULES -----------------------------------
 import argparse
+import json
 import math
 import matplotlib
 import matplotlib.pyplot as plt
@@ -25,6 +26,16 @@ from mpl_toolkits.mplot3d import Axes3D
 from typing import Dict, List, Tuple
 # --------------------------------- MODULES -----------------------------------
 
+# -------------------------------- CONSTANTS ----------------------------------
+# Number of double floating-point values 'psrs' writes in binary form for a
+# single series of sorting times, in the order of
+# (mean, stdev, min, max, median, p90, p99, ci95 low, ci95 high)
+SORT_STAT_SIZE = 9
+# Number of phases of PSRS; with the '-p' flag 'psrs' writes 'SORT_STAT_SIZE'
+# values for each phase followed by the ones for the total sorting time
+PHASE_COUNT = 4
+# -------------------------------- CONSTANTS ----------------------------------
+
 # ------------------------------ TYPE ALIASES ---------------------------------
 # The 'runtime_dict' returned by 'speedup_plot' is a 'dict' with keys
 # of the following form:
@@ -48,8 +59,10 @@ def speedup_plot(program: str, output: str) -> Dict[RunTimeKey, List[ValPair]]:
 
     NOTE:
     The PSRS program must support a command line interface of the following:
-        ' -b -l {length} -r {run} -s {seed} -w {window}'
-    and this function hard-coded the length to be range of:
+        ' --format json --sweep-lengths {lengths} --sweep-procs {processes}
+          -r {run} -s {seed} -w {window}'
+    all the cases are sorted within a single launch of the largest number of
+    processes; this function hard-coded the length to be range of:
         [2 ** e for e in range(19, 26, 2)] -> 2 ** 19 -- 2 ** 26 with step 2
     the number of processes is hard-coded to be range of:
         [2 ** e for e in range(4)] -> 2 ** 0 -- 2 ** 3
@@ -70,7 +83,8 @@ def speedup_plot(program: str, output: str) -> Dict[RunTimeKey, List[ValPair]]:
     mean_time = None
     std_err = None
     mpi_prefix = "mpiexec -n {process} "
-    psrs_flags = " -b -l {length} -r {run} -s {seed} -w {window}"
+    psrs_flags = (" --format json --sweep-lengths {lengths}"
+                  " --sweep-procs {processes} -r {run} -s {seed} -w {window}")
     program = mpi_prefix + program + psrs_flags
     argument_dict = dict(run=7, seed=10, window=5)
     process_range = tuple(2 ** e for e in range(4))
@@ -99,30 +113,28 @@ def speedup_plot(program: str, output: str) -> Dict[RunTimeKey, List[ValPair]]:
              color="c", label="Linear", linestyle="--",
              marker="+", markersize=10)
 
+    argument_dict["process"] = process_range[-1]
+    argument_dict["lengths"] = ",".join(str(i) for i in length_range)
+    argument_dict["processes"] = ",".join(str(i) for i in process_range)
+    command = program.format(**argument_dict).split()
+    # 'psrs' sorts every (number of processes, length) pair in turn and
+    # writes all of them as a single JSON object with a 'sweep' list, one
+    # record per pair; the statistics are printed with 9 significant digits.
+
+    # The method 'communicate' returns a tuple of the form
+    # (stdout_data, stderr_data)
+    # here only the first element is of interest.
+    with subprocess.Popen(command, stdout=subprocess.PIPE) as proc:
+        sweep = json.loads(proc.communicate()[0].decode())["sweep"]
+    sweep_dict = {(record["parameters"]["length"],
+                   record["environment"]["processes"]): record["total"]
+                  for record in sweep}
+
     for length, legend, color in zip(length_range, legend_range, color_range):
-        argument_dict["length"] = length
         speedup_vector.clear()
         for process_count in process_range:
-            argument_dict["process"] = process_count
-            command = program.format(**argument_dict).split()
-            # Let 'psrs' program write the moving average and standard error in
-            # binary form, rather than the human-readable text form, because
-            # 'printf' cannot print exact values of floating-point numbers that
-            # easily.
-            # 'psrs' calls 'fwrite' to write the moving average and standard
-            # error into the 'subprocess.PIPE', and is parsed by the 'unpack'
-            # mechanism.
-
-            # The method 'communicate' returns a tuple of the form
-            # (stdout_data, stderr_data)
-            # here only the first element is of interest.
-
-            # The result of 'unpack' method call is a tuple regardless of the
-            # data to be unpacked; since the output of 'psrs' are two
-            # double floating-point values, only the first two elements
-            # are needed.
-            with subprocess.Popen(command, stdout=subprocess.PIPE) as proc:
-                mean_time, std_err = struct.unpack("dd", proc.communicate()[0])
+            mean_time = sweep_dict[(length, process_count)]["mean"]
+            std_err = sweep_dict[(length, process_count)]["stdev"]
             if 1 != process_count:
                 # Speedup = T1 / Tp
                 speedup = speedup_vector[0] / mean_time
@@ -330,8 +342,13 @@ def phase_pie_plot(program: str, length: int, output: str):
         # The method 'communicate' returns a tuple of the form
         # (stdout_data, stderr_data)
         # here only the first element is of interest.
-        phase_time[0], phase_time[1], phase_time[2], phase_time[3] = \
-            struct.unpack("dddd", proc.communicate()[0])
+        # The statistics of each phase take 'SORT_STAT_SIZE' values, and the
+        # mean comes first.
+        stats = struct.unpack("{0}d".format((PHASE_COUNT + 1) *
+                                            SORT_STAT_SIZE),
+                              proc.communicate()[0])
+        for phase in range(PHASE_COUNT):
+            phase_time[phase] = stats[phase * SORT_STAT_SIZE]
 
     total_time = sum(phase_time)
     phase_percent = [phase / total_time * 100 for phase in phase_time]
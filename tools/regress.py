@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+
+"""
+Records a baseline of the PSRS program over a fixed matrix of configurations
+and compares later runs against it to catch performance regressions.
+"""
+
+# ------------------------------- MODULE INFO ---------------------------------
+__all__ = ["matrix_run", "baseline_write", "baseline_read",
+           "mann_whitney", "regression_find"]
+# ------------------------------- MODULE INFO ---------------------------------
+
+# --------------------------------- MODULES -----------------------------------
+import argparse
+import itertools
+import json
+import math
+import shlex
+import shutil
+import subprocess
+import sys
+
+from typing import Dict, List, Tuple
+# --------------------------------- MODULES -----------------------------------
+
+# -------------------------------- CONSTANTS ----------------------------------
+# Version of the baseline file layout.
+BASELINE_SCHEMA = 1
+# The matrix of configurations; every combination is sorted within a single
+# launch of 'psrs' (see its '--sweep-*' options) on the largest number of
+# processes.
+PROCESS_RANGE = (1, 2, 4, 8)
+LENGTH_RANGE = (2 ** 20, 2 ** 22)
+DIST_RANGE = ("uniform", "sorted", "few-unique")
+RUN = 9
+WINDOW = 7
+SEED = 10
+# Metrics compared for each configuration; the phases are only recorded for
+# more than 1 process.
+METRIC_RANGE = ("phase1", "phase2", "phase3", "phase4", "total")
+# A metric regresses if its median grows by more than the threshold (in
+# percent) AND the growth is significant at level 'ALPHA'.
+THRESHOLD = 5.0
+ALPHA = 0.05
+# If both samples are no larger than this, the Mann-Whitney U test is exact.
+EXACT_LIMIT = 20
+# -------------------------------- CONSTANTS ----------------------------------
+
+# ------------------------------ TYPE ALIASES ---------------------------------
+# A configuration is identified by
+# (number of processes, length of array, distribution)
+CaseKey = Tuple[int, int, str]
+# and maps to the samples within the moving window of each metric:
+# {"phase1": [...], ..., "total": [...]}
+CaseSamples = Dict[str, List[float]]
+# ------------------------------ TYPE ALIASES ---------------------------------
+
+
+# -------------------------------- FUNCTIONS ----------------------------------
+def matrix_run(program: str, mpiexec: str) -> List[dict]:
+    """
+    Runs the whole matrix of configurations with the 'program' that
+    implements the Parallel Sorting by Regular Sampling algorithm, and
+    returns the list of records of its '--format json' sweep output.
+
+    NOTE:
+    The 'program' should be built in Release mode for the times to be
+    representative; the result verification of a Debug build goes to
+    stderr, so the JSON output is valid either way.
+    """
+    if not shutil.which(program):
+        raise ValueError("'program' is not found")
+
+    command = shlex.split(mpiexec)
+    if not command or not shutil.which(command[0]):
+        raise ValueError("'mpiexec' is not found")
+
+    command += ["-n", str(PROCESS_RANGE[-1]), program,
+                "--format", "json",
+                "--sweep-procs", ",".join(str(i) for i in PROCESS_RANGE),
+                "--sweep-lengths", ",".join(str(i) for i in LENGTH_RANGE),
+                "--sweep-dists", ",".join(DIST_RANGE),
+                "-r", str(RUN), "-s", str(SEED), "-w", str(WINDOW)]
+
+    with subprocess.Popen(command, stdout=subprocess.PIPE) as proc:
+        output = proc.communicate()[0]
+        if 0 != proc.returncode:
+            raise RuntimeError("'{0}' failed".format(" ".join(command)))
+
+    try:
+        return json.loads(output.decode())["sweep"]
+    except ValueError:
+        raise RuntimeError("'psrs' did not write JSON")
+
+
+def baseline_write(records: List[dict], output: str):
+    """
+    Writes the 'records' of a sweep into 'output' as a baseline.
+    """
+    with open(output, "w") as stream:
+        json.dump({"schema": BASELINE_SCHEMA, "sweep": records},
+                  stream, indent=1)
+        stream.write("\n")
+
+
+def baseline_read(path: str) -> List[dict]:
+    """
+    Reads the records of a baseline written by 'baseline_write'; the raw
+    output of 'psrs --sweep-* --format json' is accepted as well.
+    """
+    with open(path) as stream:
+        baseline = json.load(stream)
+
+    if BASELINE_SCHEMA < baseline.get("schema", 0):
+        raise ValueError("'{0}' is written by a newer version".format(path))
+    return baseline["sweep"]
+
+
+def samples_get(records: List[dict]) -> Dict[CaseKey, CaseSamples]:
+    """
+    Extracts the samples within the moving window (the last 'window' runs)
+    of every metric of every configuration in 'records'.
+    """
+    result = dict()
+
+    for record in records:
+        key = (record["environment"]["processes"],
+               record["parameters"]["length"],
+               record["parameters"].get("dist", "uniform"))
+        window = record["parameters"]["window"]
+        samples = record["samples"][-window:]
+        result[key] = {metric: [sample[metric] for sample in samples]
+                       for metric in METRIC_RANGE
+                       if all(metric in sample for sample in samples)}
+    return result
+
+
+def mann_whitney(baseline: List[float], current: List[float]) -> float:
+    """
+    Returns the one-sided p-value of the Mann-Whitney U test for the
+    alternative that 'current' tends to be larger (slower) than 'baseline'.
+
+    NOTE:
+    The exact distribution of U is used if both samples are small and there
+    is no tie; otherwise the normal approximation with tie correction is
+    used.
+
+    Reference:
+    https://en.wikipedia.org/wiki/Mann%E2%80%93Whitney_U_test
+    """
+    m, n = len(baseline), len(current)
+
+    if 0 == m or 0 == n:
+        raise ValueError("Both samples must be non-empty")
+
+    # Ranks of the pooled samples, ties getting the average rank.
+    pooled = sorted(itertools.chain(((value, 0) for value in baseline),
+                                    ((value, 1) for value in current)))
+    rank_sum = 0.0
+    tie_sum = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        rank = (i + j) / 2 + 1
+        rank_sum += rank * sum(1 for k in range(i, j + 1) if pooled[k][1])
+        tie_sum += (j - i + 1) ** 3 - (j - i + 1)
+        i = j + 1
+
+    # Number of (baseline, current) pairs where current is the larger one.
+    u = rank_sum - n * (n + 1) / 2
+
+    if 0 == tie_sum and m <= EXACT_LIMIT and n <= EXACT_LIMIT:
+        return _u_exact_tail(m, n, int(u))
+
+    mean = m * n / 2
+    variance = m * n / 12 * ((m + n + 1) - tie_sum / ((m + n) * (m + n - 1)))
+    if 0 >= variance:
+        return 1.0
+    # Continuity correction.
+    z = (u - mean - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def regression_find(baseline: Dict[CaseKey, CaseSamples],
+                    current: Dict[CaseKey, CaseSamples],
+                    threshold: Dict[str, float],
+                    alpha: float) -> List[Tuple[CaseKey, str, float, float]]:
+    """
+    Compares every metric of every configuration present in both 'baseline'
+    and 'current', prints one row for each, and returns the regressions as
+    (configuration, metric, change of median in percent, p-value).
+
+    Each metric is judged against its own 'threshold', so a slower phase is
+    not hidden by a faster one.
+    """
+    regression = list()
+
+    print("Processes, Length, Distribution, Metric, Baseline, Current, "
+          "Change (%), P-Value, Verdict")
+    for key in sorted(baseline.keys() & current.keys()):
+        for metric in METRIC_RANGE:
+            if metric not in baseline[key] or metric not in current[key]:
+                continue
+            old = _median(baseline[key][metric])
+            new = _median(current[key][metric])
+            change = (new - old) / old * 100 if 0 < old else 0.0
+            p_value = mann_whitney(baseline[key][metric], current[key][metric])
+            verdict = "ok"
+            if threshold[metric] < change and p_value < alpha:
+                verdict = "REGRESSION"
+                regression.append((key, metric, change, p_value))
+            print("{0}, {1}, {2}, {3}, {4:.6f}, {5:.6f}, {6:+.1f}, "
+                  "{7:.4f}, {8}".format(*key, metric, old, new, change,
+                                        p_value, verdict))
+
+    for key in sorted(baseline.keys() - current.keys()):
+        print("{0}, {1}, {2}, missing from the current run".format(*key),
+              file=sys.stderr)
+    return regression
+
+
+def _median(values: List[float]) -> float:
+    """
+    Returns the median of 'values'.
+    """
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+
+    if len(ordered) % 2:
+        return ordered[middle]
+    return (ordered[middle - 1] + ordered[middle]) / 2
+
+
+def _u_exact_tail(m: int, n: int, u: int) -> float:
+    """
+    Returns P(U >= u) under the null hypothesis for samples of size 'm' and
+    'n' without ties.
+
+    NOTE:
+    'count[k]' holds the number of arrangements with U == k, built up by the
+    recurrence over the largest value of the pooled samples.
+    """
+    # table[i][j] is the distribution of U for sizes (i, j).
+    table = [[None] * (n + 1) for _ in range(m + 1)]
+
+    for i in range(m + 1):
+        for j in range(n + 1):
+            if 0 == i or 0 == j:
+                table[i][j] = [1]
+                continue
+            # The largest value is either from the current sample (adding
+            # 'i' to U) or from the baseline one (adding nothing).
+            count = [0] * (i * j + 1)
+            for k, ways in enumerate(table[i][j - 1]):
+                count[k + i] += ways
+            for k, ways in enumerate(table[i - 1][j]):
+                count[k] += ways
+            table[i][j] = count
+
+    count = table[m][n]
+    return sum(count[max(u, 0):]) / sum(count)
+
+
+def _threshold_parse(values: List[str]) -> Dict[str, float]:
+    """
+    Parses the 'METRIC=PERCENT' pairs given to '--threshold' on top of the
+    default threshold of every metric.
+    """
+    threshold = {metric: THRESHOLD for metric in METRIC_RANGE}
+
+    for value in values or list():
+        metric, _, percent = value.partition("=")
+        if metric not in threshold or not percent:
+            raise ValueError("'{0}' is not of the form METRIC=PERCENT "
+                             "with METRIC among {1}".format(value,
+                                                            METRIC_RANGE))
+        threshold[metric] = float(percent)
+    return threshold
+
+
+def main():
+    """
+    Main command line driver.
+    """
+    parser = argparse.ArgumentParser()
+    parser.add_argument("action",
+                        choices=("record", "compare"),
+                        help="record a baseline, or compare a run "
+                             "against one")
+    parser.add_argument("-b", "--baseline",
+                        type=str,
+                        required=True,
+                        help="file name of the baseline")
+    parser.add_argument("-e", "--executable",
+                        type=str,
+                        help="path to the PSRS executable")
+    parser.add_argument("-c", "--current",
+                        type=str,
+                        help="compare an existing result (as written by "
+                             "'record') instead of running the matrix")
+    parser.add_argument("-m", "--mpiexec",
+                        type=str,
+                        default="mpiexec",
+                        help="command (with flags) launching the processes")
+    parser.add_argument("-t", "--threshold",
+                        type=str,
+                        action="append",
+                        help="METRIC=PERCENT, e.g. phase3=10 "
+                             "(default: {0} for all)".format(THRESHOLD))
+    parser.add_argument("-a", "--alpha",
+                        type=float,
+                        default=ALPHA,
+                        help="significance level of the Mann-Whitney U test")
+    args = parser.parse_args()
+    threshold = _threshold_parse(args.threshold)
+
+    if "compare" == args.action and args.current:
+        records = baseline_read(args.current)
+    elif args.executable:
+        records = matrix_run(args.executable, args.mpiexec)
+    else:
+        parser.error("'--executable' is required")
+
+    if "record" == args.action:
+        baseline_write(records, args.baseline)
+        return
+
+    regression = regression_find(samples_get(baseline_read(args.baseline)),
+                                 samples_get(records),
+                                 threshold,
+                                 args.alpha)
+    if regression:
+        print("{0} regression(s) found".format(len(regression)),
+              file=sys.stderr)
+        sys.exit(1)
+# -------------------------------- FUNCTIONS ----------------------------------
+
+
+if __name__ == "__main__":
+    main()